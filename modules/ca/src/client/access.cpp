@@ -296,61 +296,45 @@ int epicsStdCall ca_create_channel (
         return caStatus;
     }
 
-    {
-        CAFDHANDLER * pFunc = 0;
-        void * pArg = 0;
-        {
-            epicsGuard < epicsMutex >
-                guard ( pcac->mutex );
-            if ( pcac->fdRegFuncNeedsToBeCalled ) {
-                pFunc = pcac->fdRegFunc;
-                pArg = pcac->fdRegArg;
-                pcac->fdRegFuncNeedsToBeCalled = false;
-            }
-        }
-        if ( pFunc ) {
-            ( *pFunc ) ( pArg, pcac->sock, true );
-        }
-    }
+    pcac->fdRegistration ();
 
-    try {
-        epicsGuard < epicsMutex > guard ( pcac->mutex );
-        oldChannelNotify * pChanNotify =
-            new ( pcac->oldChannelNotifyFreeList )
-                oldChannelNotify ( guard, *pcac, name_str,
-                    conn_func, puser, priority );
-        // make sure that their chan pointer is set prior to
-        // calling connection call backs
-        *chanptr = pChanNotify;
-        pChanNotify->initiateConnect ( guard );
-        // no need to worry about a connect preempting here because
-        // the connect sequence will not start until initiateConnect()
-        // is called
-    }
-    catch ( cacChannel::badString & ) {
-        return ECA_BADSTR;
-    }
-    catch ( std::bad_alloc & ) {
-        return ECA_ALLOCMEM;
-    }
-    catch ( cacChannel::badPriority & ) {
-        return ECA_BADPRIORITY;
-    }
-    catch ( cacChannel::unsupportedByService & ) {
-        return ECA_UNAVAILINSERV;
-    }
-    catch ( std :: exception & except ) {
-        pcac->printFormated (
-            "ca_create_channel: "
-            "unexpected exception was \"%s\"",
-            except.what () );
-        return ECA_INTERNAL;
-    }
-    catch ( ... ) {
-        return ECA_INTERNAL;
+    epicsGuard < epicsMutex > guard ( pcac->mutex );
+    return pcac->createChannelNotify ( guard, name_str, conn_func,
+        puser, priority, chanptr );
+}
+
+/*
+ * ca_create_channels ()
+ *
+ * The context is looked up and the fd registration function called
+ * once, and all of the channels are created under one hold of the
+ * context lock. Channel creation never blocks with the lock held.
+ */
+// extern "C"
+int epicsStdCall ca_create_channels ( unsigned nChannels,
+     const char * const * pNames, caCh * conn_func,
+     void * const * pUsers, capri priority, chid * pChanIds )
+{
+    ca_client_context * pcac;
+    int caStatus = fetchClientContext ( & pcac );
+    if ( caStatus != ECA_NORMAL ) {
+        return caStatus;
     }
 
-    return ECA_NORMAL;
+    pcac->fdRegistration ();
+
+    epicsGuard < epicsMutex > guard ( pcac->mutex );
+    for ( unsigned i = 0u; i < nChannels; i++ ) {
+        int status = pcac->createChannelNotify ( guard, pNames[i],
+            conn_func, pUsers ? pUsers[i] : 0, priority, & pChanIds[i] );
+        if ( status != ECA_NORMAL ) {
+            pChanIds[i] = 0;
+            if ( caStatus == ECA_NORMAL ) {
+                caStatus = status;
+            }
+        }
+    }
+    return caStatus;
 }
 
 /*
@@ -388,9 +372,26 @@ int epicsStdCall ca_clear_channel ( chid pChan )
         // o user doesnt periodically call a ca function
         // o user calls this function from an auxiliary thread
         //
-        CallbackGuard cbGuard ( cac.cbMutex );
+        // a callback pool thread may be running a callback for the
+        // channel, which can use it until it returns
+        if ( cac.pExecutor ) {
+            cac.pExecutor->purge ( pChan, 0 );
+            cac.pExecutor->waitIdle ( pChan, 0 );
+        }
+        {
+            CallbackGuard cbGuard ( cac.cbMutex );
+            epicsGuard < epicsMutex > guard ( cac.mutex );
+            pChan->destructor ( *cac.pCallbackGuard.get(), guard );
+            // no more callbacks are queued for it after this
+            if ( cac.pExecutor ) {
+                cac.pExecutor->purge ( pChan, 0 );
+            }
+        }
+        // in case a callback queued since the first purge is running
+        if ( cac.pExecutor ) {
+            cac.pExecutor->waitIdle ( pChan, 0 );
+        }
         epicsGuard < epicsMutex > guard ( cac.mutex );
-        pChan->destructor ( *cac.pCallbackGuard.get(), guard );
         cac.oldChannelNotifyFreeList.release ( pChan );
     }
     return ECA_NORMAL;
@@ -434,6 +435,35 @@ int epicsStdCall ca_clear_event ( evid pMon )
     return ca_clear_subscription ( pMon );
 }
 
+/*
+ *  ca_set_subscription_policy ()
+ */
+int epicsStdCall ca_set_subscription_policy ( evid pMon,
+    ca_subscription_policy_select policy, double window,
+    double bytesPerSecond )
+{
+    if ( policy < ca_subscription_lossless ||
+            policy > ca_subscription_windowed ) {
+        return ECA_BADTYPE;
+    }
+    if ( ! ( window >= 0.0 ) || ! ( bytesPerSecond >= 0.0 ) ||
+            ( policy == ca_subscription_windowed && window == 0.0 ) ) {
+        return ECA_BADTYPE;
+    }
+    ca_client_context & cac = pMon->channel ().getClientCtx ();
+    try {
+        epicsGuard < epicsMutex > guard ( cac.mutexRef () );
+        pMon->setPolicy ( guard, policy, window, bytesPerSecond );
+    }
+    catch ( std::bad_alloc & ) {
+        return ECA_ALLOCMEM;
+    }
+    catch ( ... ) {
+        return ECA_INTERNAL;
+    }
+    return ECA_NORMAL;
+}
+
 // extern "C"
 chid epicsStdCall ca_evid_to_chid ( evid pMon )
 {
@@ -521,6 +551,56 @@ int epicsStdCall ca_flush_io ()
     return ECA_NORMAL;
 }
 
+/*
+ *  ca_pin_event_data ()
+ *
+ *  Only the data delivered to get and subscription callbacks by a
+ *  TCP circuit can be pinned. The receive thread's message body
+ *  cache holding it is handed over and replaced by a new one.
+ */
+struct ca_pinned_data {
+    void * pBuf;
+    void * pFreeList; // nil if the buffer was malloc()ed
+};
+
+// extern "C"
+ca_pinned_data * epicsStdCall ca_pin_event_data ( const void * pDbr )
+{
+    tcpiiu * piiu = static_cast < tcpiiu * > (
+        epicsThreadPrivateGet ( caClientRecvCircuitId ) );
+    if ( ! piiu ) {
+        return 0;
+    }
+    ca_pinned_data * pPin = static_cast < ca_pinned_data * > (
+        malloc ( sizeof ( *pPin ) ) );
+    if ( ! pPin ) {
+        return 0;
+    }
+    pPin->pBuf = piiu->pinResponseData ( pDbr, pPin->pFreeList );
+    if ( ! pPin->pBuf ) {
+        free ( pPin );
+        return 0;
+    }
+    return pPin;
+}
+
+/*
+ *  ca_unpin_event_data ()
+ */
+// extern "C"
+void epicsStdCall ca_unpin_event_data ( ca_pinned_data * pPin )
+{
+    if ( pPin ) {
+        if ( pPin->pFreeList ) {
+            freeListFree ( pPin->pFreeList, pPin->pBuf );
+        }
+        else {
+            free ( pPin->pBuf );
+        }
+        free ( pPin );
+    }
+}
+
 /*
  *  CA_TEST_IO ()
  */
@@ -690,6 +770,30 @@ unsigned epicsStdCall ca_beacon_anomaly_count ()
     return pcac->beaconAnomaliesSinceProgramStart ();
 }
 
+int epicsStdCall ca_client_latency ( enum ca_latency_select select,
+    struct ca_latency_summary * pSummary )
+{
+    ca_client_context * pcac;
+    int caStatus = fetchClientContext ( & pcac );
+    if ( caStatus != ECA_NORMAL ) {
+        return caStatus;
+    }
+
+    return pcac->latency ( select, *pSummary );
+}
+
+int epicsStdCall ca_client_message_bytes ( unsigned command,
+    double * pSent, double * pReceived )
+{
+    ca_client_context * pcac;
+    int caStatus = fetchClientContext ( & pcac );
+    if ( caStatus != ECA_NORMAL ) {
+        return caStatus;
+    }
+
+    return pcac->messageBytes ( command, *pSent, *pReceived );
+}
+
 // extern "C"
 int epicsStdCall ca_channel_status ( epicsThreadId /* tid */ )
 {
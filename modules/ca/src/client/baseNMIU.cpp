@@ -29,6 +29,11 @@ baseNMIU::~baseNMIU ()
 {
 }
 
+bool baseNMIU::requestTime ( epicsTime & ) const
+{
+    return false;
+}
+
 void baseNMIU::forceSubscriptionUpdate (
         epicsGuard < epicsMutex > &, nciu & )
 {
@@ -0,0 +1,91 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include "beaconAnomalyTimer.h"
+
+// wait this long for the other anomalies of a batch
+static const double beaconAnomalyBatchDelay = 0.1; // sec
+// and no less than this between the batches
+static const double beaconAnomalyBatchPeriod = 1.0; // sec
+
+beaconAnomalyTimer::beaconAnomalyTimer (
+    beaconAnomalyTimerNotify & iiuIn,
+    epicsTimerQueue & queueIn,
+    epicsMutex & mutexIn, double unmatchedPeriodIn ) :
+        unmatchedPeriod ( unmatchedPeriodIn ), mutex ( mutexIn ),
+    timer ( queueIn.createTimer () ), iiu ( iiuIn ),
+    pending ( false ), deferred ( false ), stopped ( false )
+{
+}
+
+beaconAnomalyTimer::~beaconAnomalyTimer ()
+{
+    this->timer.destroy ();
+}
+
+void beaconAnomalyTimer::request (
+    epicsGuard < epicsMutex > & guard )
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    // a new anomaly doesn't wait for a deferred batch
+    if ( ( this->pending && ! this->deferred ) || this->stopped ) {
+        return;
+    }
+    this->pending = true;
+    this->deferred = false;
+    double delay = beaconAnomalyBatchDelay;
+    double sinceLast = epicsTime::getCurrent () - this->lastBatch;
+    if ( sinceLast + delay < beaconAnomalyBatchPeriod ) {
+        delay = beaconAnomalyBatchPeriod - sinceLast;
+    }
+    this->timer.start ( *this, delay );
+}
+
+void beaconAnomalyTimer::shutdown (
+    epicsGuard < epicsMutex > & cbGuard,
+    epicsGuard < epicsMutex > & guard )
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    this->stopped = true;
+    {
+        epicsGuardRelease < epicsMutex > unguard ( guard );
+        {
+            epicsGuardRelease < epicsMutex > cbUnguard ( cbGuard );
+            this->timer.cancel ();
+        }
+    }
+    this->pending = false;
+}
+
+epicsTimerNotify::expireStatus beaconAnomalyTimer::expire (
+    const epicsTime & currentTime )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    // the timer may expire a little early, so a deferred batch is
+    // never for the matching channels only
+    bool matchedOnly = ! this->deferred &&
+        currentTime - this->lastUnmatched < this->unmatchedPeriod;
+    this->pending = false;
+    this->deferred = false;
+    if ( ! this->stopped ) {
+        this->lastBatch = currentTime;
+        if ( ! matchedOnly ) {
+            this->lastUnmatched = currentTime;
+        }
+        bool skipped = this->iiu.beaconAnomalyBatchNotify (
+            guard, currentTime, matchedOnly );
+        if ( skipped && ! this->pending ) {
+            // a start() while expire runs overrides the restart status
+            this->pending = true;
+            this->deferred = true;
+            this->timer.start ( *this,
+                this->lastUnmatched + this->unmatchedPeriod );
+        }
+    }
+    return noRestart;
+}
+
+beaconAnomalyTimerNotify::~beaconAnomalyTimerNotify () {}
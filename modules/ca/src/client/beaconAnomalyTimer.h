@@ -0,0 +1,57 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// Collects the beacon anomalies seen within a short interval into one
+// batch, and limits how often the batches are processed, so that many
+// servers restarting together cause one round of searches. Channels
+// not matching an anomaly are included in a batch at most once each
+// unmatched period; a batch that had to skip them is followed by one
+// that includes them at the end of the period.
+//
+
+#ifndef INC_beaconAnomalyTimer_H
+#define INC_beaconAnomalyTimer_H
+
+#include "epicsMutex.h"
+#include "epicsGuard.h"
+#include "epicsTimer.h"
+
+class beaconAnomalyTimerNotify {
+public:
+    virtual ~beaconAnomalyTimerNotify () = 0;
+    // returns true if channels were skipped because of matchedOnly
+    virtual bool beaconAnomalyBatchNotify (
+        epicsGuard < epicsMutex > &, const epicsTime & currentTime,
+        bool matchedOnly ) = 0;
+};
+
+class beaconAnomalyTimer : private epicsTimerNotify {
+public:
+    beaconAnomalyTimer (
+        class beaconAnomalyTimerNotify &, epicsTimerQueue &, epicsMutex &,
+        double unmatchedPeriod );
+    virtual ~beaconAnomalyTimer ();
+    void request ( epicsGuard < epicsMutex > & );
+    void shutdown (
+        epicsGuard < epicsMutex > & cbGuard,
+        epicsGuard < epicsMutex > & guard );
+private:
+    epicsTime lastBatch;
+    epicsTime lastUnmatched;
+    const double unmatchedPeriod;
+    epicsMutex & mutex;
+    epicsTimer & timer;
+    class beaconAnomalyTimerNotify & iiu;
+    bool pending;
+    bool deferred;
+    bool stopped;
+    epicsTimerNotify::expireStatus expire ( const epicsTime & currentTime );
+    beaconAnomalyTimer ( const beaconAnomalyTimer & );
+    beaconAnomalyTimer & operator = ( const beaconAnomalyTimer & );
+};
+
+#endif // ifndef INC_beaconAnomalyTimer_H
@@ -49,7 +49,8 @@
 bhe::bhe ( epicsMutex & mutexIn, const epicsTime & initialTimeStamp,
           unsigned initialBeaconNumber, const inetAddrID & addr ) :
     inetAddrID ( addr ), timeStamp ( initialTimeStamp ), averagePeriod ( - DBL_MAX ),
-    mutex ( mutexIn ), pIIU ( 0 ), lastBeaconNumber ( initialBeaconNumber )
+    mutex ( mutexIn ), pIIU ( 0 ), lastBeaconNumber ( initialBeaconNumber ),
+    anomalyFlag ( false )
 {
 #   ifdef DEBUG
     {
@@ -60,6 +60,9 @@ public:
     LIBCA_API void show ( epicsGuard < epicsMutex > &, unsigned /* level */ ) const;
     LIBCA_API void registerIIU ( epicsGuard < epicsMutex > &, tcpiiu & );
     LIBCA_API void unregisterIIU ( epicsGuard < epicsMutex > &, tcpiiu & );
+    void setAnomalyPending ( epicsGuard < epicsMutex > & );
+    bool anomalyPending ( epicsGuard < epicsMutex > & ) const;
+    void clearAnomalyPending ();
     LIBCA_API void * operator new ( size_t size, bheMemoryManager & );
 #ifdef CXX_PLACEMENT_DELETE
     LIBCA_API void operator delete ( void *, bheMemoryManager & );
@@ -70,6 +73,7 @@ private:
     epicsMutex & mutex;
     tcpiiu * pIIU;
     ca_uint32_t lastBeaconNumber;
+    bool anomalyFlag; // until the next beacon anomaly batch
     void beaconAnomalyNotify ( epicsGuard < epicsMutex > & );
     void logBeacon ( const char * pDiagnostic,
                      const double & currentPeriod,
@@ -100,6 +104,21 @@ inline void * bhe::operator new ( size_t size,
     return mgr.allocate ( size );
 }
 
+inline void bhe::setAnomalyPending ( epicsGuard < epicsMutex > & )
+{
+    this->anomalyFlag = true;
+}
+
+inline bool bhe::anomalyPending ( epicsGuard < epicsMutex > & ) const
+{
+    return this->anomalyFlag;
+}
+
+inline void bhe::clearAnomalyPending ()
+{
+    this->anomalyFlag = false;
+}
+
 #ifdef CXX_PLACEMENT_DELETE
 inline void bhe::operator delete ( void * pCadaver,
         bheMemoryManager & mgr )
@@ -112,8 +112,9 @@ typedef ca_uint32_t     caResId;
 #define CA_PROTO_SIGNAL         25u /* knock the server out of select */
 #define CA_PROTO_CREATE_CH_FAIL 26u /* unable to create chan resource in server */
 #define CA_PROTO_SERVER_DISCONN 27u /* server deletes PV (or channel) */
+#define CA_PROTO_COMPRESSED     28u /* compressed response (see below) */
 
-#define CA_PROTO_LAST_CMMD CA_PROTO_SERVER_DISCONN
+#define CA_PROTO_LAST_CMMD CA_PROTO_COMPRESSED
 
 /*
  * for use with search and not_found (if search fails and
@@ -181,6 +182,28 @@ struct  mon_info {
     ca_uint16_t     m_pad;      /* extend to 32 bits */
 };
 
+/*
+ * Response compression
+ *
+ * A client that can accept compressed responses places the smallest
+ * payload size in bytes worth compressing in the m_available field of
+ * its TCP CA_PROTO_VERSION message, or zero (as sent by older clients)
+ * if it can't. A server may then send any CA_PROTO_READ, READ_NOTIFY or
+ * EVENT_ADD response with a payload at least that large as a
+ * CA_PROTO_COMPRESSED message instead. That has the m_dataType, m_count,
+ * m_cid and m_available fields of the original response, and a payload
+ * that starts with this header followed by the compressed data and
+ * padding. Servers that don't support compression ignore the field.
+ */
+typedef struct ca_compressed_hdr {
+    ca_uint16_t m_cmmd;         /* original command */
+    ca_uint8_t  m_codec;        /* CA_COMPRESS_xxx */
+    ca_uint8_t  m_stride;       /* element size used by the codec */
+    ca_uint32_t m_postsize;     /* original payload size */
+} caCompressedHdr;
+
+#define CA_COMPRESS_SHUFFLE_RLE 1u  /* byte planes, delta, run length */
+
 /*
  * PV names greater than this length assumed to be invalid
  */
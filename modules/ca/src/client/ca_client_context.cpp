@@ -32,6 +32,7 @@
 #include <stdio.h>
 
 #include "epicsExit.h"
+#include "envDefs.h"
 #include "errlog.h"
 #include "locationException.h"
 
@@ -40,6 +41,7 @@
 #include "cac.h"
 
 epicsThreadPrivateId caClientCallbackThreadId;
+epicsThreadPrivateId caClientRecvCircuitId;
 
 static epicsThreadOnceId cacOnce = EPICS_THREAD_ONCE_INIT;
 
@@ -50,6 +52,8 @@ extern "C" void cacOnceFunc ( void * )
 {
     caClientCallbackThreadId = epicsThreadPrivateCreate ();
     assert ( caClientCallbackThreadId );
+    caClientRecvCircuitId = epicsThreadPrivateCreate ();
+    assert ( caClientRecvCircuitId );
     ca_client_context::pDefaultServiceInstallMutex = newEpicsMutex;
 }
 
@@ -62,6 +66,7 @@ ca_client_context::ca_client_context ( bool enablePreemptiveCallback ) :
     mutex(__FILE__, __LINE__),
     cbMutex(__FILE__, __LINE__),
     createdByThread ( epicsThreadGetIdSelf () ),
+    pExecutor ( 0 ), pPacerQueue ( 0 ), pPacer ( 0 ),
     ca_exception_func ( 0 ), ca_exception_arg ( 0 ),
     pVPrintfFunc ( errlogVprintf ), fdRegFunc ( 0 ), fdRegArg ( 0 ),
     pndRecvCnt ( 0u ), ioSeqNo ( 0u ), callbackThreadsPending ( 0u ),
@@ -160,10 +165,30 @@ ca_client_context::ca_client_context ( bool enablePreemptiveCallback ) :
 
     // multiple steps ensure exception safety
     this->pCallbackGuard = PTRMOVE(pCBGuard);
+
+    if ( enablePreemptiveCallback ) {
+        long nThreads;
+        long status = envGetLongConfigParam (
+            & EPICS_CA_CALLBACK_THREADS, & nThreads );
+        if ( status || nThreads < 0 ) {
+            this->printFormated (
+                "ca_client_context: EPICS_CA_CALLBACK_THREADS "
+                "was not a positive integer\n" );
+        }
+        else if ( nThreads > 0 ) {
+            this->pExecutor = new callbackExecutor (
+                *this, static_cast < unsigned > ( nThreads ) );
+        }
+    }
 }
 
 ca_client_context::~ca_client_context ()
 {
+    // callbacks that haven't run yet are discarded
+    if ( this->pExecutor ) {
+        this->pExecutor->shutdown ();
+    }
+
     if ( this->fdRegFunc ) {
         ( *this->fdRegFunc )
             ( this->fdRegArg, this->sock, false );
@@ -180,9 +205,46 @@ ca_client_context::~ca_client_context ()
     if ( this->pCallbackGuard.get() ) {
         epicsGuardRelease < epicsMutex > unguard ( *this->pCallbackGuard );
         this->pServiceContext.reset ( 0 );
+        this->destroyPacer ();
     }
     else {
         this->pServiceContext.reset ( 0 );
+        this->destroyPacer ();
+    }
+    delete this->pExecutor;
+}
+
+// created when a subscription is first given a rate limit
+subscriptionPacer & ca_client_context::pacer (
+    epicsGuard < epicsMutex > & guard )
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( ! this->pPacer ) {
+        // not the shared queue, because the timer waits
+        // for the callback lock
+        epicsTimerQueueActive & queue = epicsTimerQueueActive::allocate (
+            false, epicsThreadGetPrioritySelf () );
+        try {
+            this->pPacer = new subscriptionPacer ( *this, queue );
+        }
+        catch ( ... ) {
+            queue.release ();
+            throw;
+        }
+        this->pPacerQueue = & queue;
+    }
+    return *this->pPacer;
+}
+
+// the timer might be waiting for the callback lock
+// so this must be called without it
+void ca_client_context::destroyPacer ()
+{
+    delete this->pPacer;
+    this->pPacer = 0;
+    if ( this->pPacerQueue ) {
+        this->pPacerQueue->release ();
+        this->pPacerQueue = 0;
     }
 }
 
@@ -214,6 +276,12 @@ void ca_client_context::destroySubscription (
     epicsGuard < epicsMutex > & guard, oldSubscription & os )
 {
     guard.assertIdenticalMutex ( this->mutex );
+    if ( this->pPacer ) {
+        this->pPacer->remove ( guard, os );
+    }
+    if ( this->pExecutor ) {
+        this->pExecutor->purge ( & os.channel (), & os );
+    }
     os.~oldSubscription ();
     this->subscriptionFreeList.release ( & os );
 }
@@ -255,6 +323,24 @@ void ca_client_context::registerForFileDescriptorCallBack (
 // should block here until related callback in progress completes
 }
 
+// tell the fd registration function about our socket once it is set
+void ca_client_context::fdRegistration ()
+{
+    CAFDHANDLER * pFunc = 0;
+    void * pArg = 0;
+    {
+        epicsGuard < epicsMutex > guard ( this->mutex );
+        if ( this->fdRegFuncNeedsToBeCalled ) {
+            pFunc = this->fdRegFunc;
+            pArg = this->fdRegArg;
+            this->fdRegFuncNeedsToBeCalled = false;
+        }
+    }
+    if ( pFunc ) {
+        ( *pFunc ) ( pArg, this->sock, true );
+    }
+}
+
 int ca_client_context :: printFormated (
     const char *pformat, ... ) const
 {
@@ -430,6 +516,12 @@ void ca_client_context::show ( unsigned level ) const
         this->pServiceContext->show ( guard, level - 1u );
         ::printf ( "\tpreemptive callback is %s\n",
             this->pCallbackGuard.get() ? "disabled" : "enabled" );
+        if ( this->pExecutor ) {
+            this->pExecutor->show ( level );
+        }
+        if ( this->pPacer ) {
+            this->pPacer->show ( guard, level );
+        }
         ::printf ( "\tthere are %u unsatisfied IO operations blocking ca_pend_io()\n",
                 this->pndRecvCnt );
         ::printf ( "\tthe current io sequence number is %u\n",
@@ -672,6 +764,49 @@ cacChannel & ca_client_context::createChannel (
         guard, pChannelName, chan, pri );
 }
 
+int ca_client_context::createChannelNotify (
+    epicsGuard < epicsMutex > & guard, const char * pName,
+    caCh * pConnCallBack, void * pPrivate, capri priority, chid * pChanId )
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    try {
+        oldChannelNotify * pChanNotify =
+            new ( this->oldChannelNotifyFreeList )
+                oldChannelNotify ( guard, *this, pName,
+                    pConnCallBack, pPrivate, priority );
+        // make sure that their chan pointer is set prior to
+        // calling connection call backs
+        *pChanId = pChanNotify;
+        pChanNotify->initiateConnect ( guard );
+        // no need to worry about a connect preempting here because
+        // the connect sequence will not start until initiateConnect()
+        // is called
+    }
+    catch ( cacChannel::badString & ) {
+        return ECA_BADSTR;
+    }
+    catch ( std::bad_alloc & ) {
+        return ECA_ALLOCMEM;
+    }
+    catch ( cacChannel::badPriority & ) {
+        return ECA_BADPRIORITY;
+    }
+    catch ( cacChannel::unsupportedByService & ) {
+        return ECA_UNAVAILINSERV;
+    }
+    catch ( std :: exception & except ) {
+        this->printFormated (
+            "ca_create_channel: "
+            "unexpected exception was \"%s\"",
+            except.what () );
+        return ECA_INTERNAL;
+    }
+    catch ( ... ) {
+        return ECA_INTERNAL;
+    }
+    return ECA_NORMAL;
+}
+
 void ca_client_context::flush ( epicsGuard < epicsMutex > & guard )
 {
     this->pServiceContext->flush ( guard );
@@ -689,6 +824,21 @@ unsigned ca_client_context::beaconAnomaliesSinceProgramStart () const
     return this->pServiceContext->beaconAnomaliesSinceProgramStart ( guard );
 }
 
+int ca_client_context::latency (
+    int select, struct ca_latency_summary & summary ) const
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    return this->pServiceContext->latency ( guard, select, summary );
+}
+
+int ca_client_context::messageBytes (
+    unsigned command, double & sent, double & received ) const
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    return this->pServiceContext->messageBytes (
+        guard, command, sent, received );
+}
+
 void ca_client_context::installCASG (
     epicsGuard < epicsMutex > & guard, CASG & sg )
 {
@@ -786,6 +936,9 @@ LIBCA_API int epicsStdCall ca_clear_subscription ( evid pMon )
       epicsGuard < epicsMutex > guard ( cac.mutex );
       pMon->cancel ( cbGuard, guard );
     }
+    if ( cac.pExecutor ) {
+        cac.pExecutor->waitIdle ( & chan, pMon );
+    }
     return ECA_NORMAL;
 }
 
@@ -50,6 +50,7 @@
 #include "net_convert.h"
 #include "autoPtrFreeList.h"
 #include "noopiiu.h"
+#include "cadef.h"
 
 static const char pVersionCAC[] =
     "@(#) " EPICS_VERSION_STRING
@@ -146,7 +147,12 @@ cac::cac (
     initializingThreadsPriority ( epicsThreadGetPrioritySelf() ),
     maxRecvBytesTCP ( MAX_TCP ),
     maxContigFrames ( contiguousMsgCountWhichTriggersFlowControl ),
+    compressThreshold ( 0u ),
+    autoFlushDelay ( -1.0 ),
+    autoFlushBytes ( 0u ),
     beaconAnomalyCount ( 0u ),
+    beaconAnomaliesPending ( 0u ),
+    beaconCount ( 0u ),
     iiuExistenceCount ( 0u ),
     cacShutdownInProgress ( false )
 {
@@ -229,6 +235,41 @@ cac::cac (
                 throw std::bad_alloc ();
             }
         }
+        long compressAsALong;
+        status = envGetLongConfigParam ( &EPICS_CA_COMPRESS_THRESHOLD, &compressAsALong );
+        if ( status || compressAsALong < 0 ) {
+            errlogPrintf ( "cac: EPICS_CA_COMPRESS_THRESHOLD was not a positive integer\n" );
+        }
+        else if ( compressAsALong > 0 ) {
+            // smaller payloads rarely compress well enough to be worth it
+            this->compressThreshold = ( unsigned ) compressAsALong;
+            if ( this->compressThreshold < MAX_TCP / 16u ) {
+                this->compressThreshold = MAX_TCP / 16u;
+            }
+        }
+
+        // requests wait for the application to flush unless
+        // a flush delay or a flush size is configured
+        const char * pFlushDelay = envGetConfigParamPtr ( &EPICS_CA_FLUSH_DELAY );
+        if ( pFlushDelay && *pFlushDelay ) {
+            double delay;
+            status = envGetDoubleConfigParam ( &EPICS_CA_FLUSH_DELAY, &delay );
+            if ( status || ! ( delay >= 0.0 ) ) {
+                errlogPrintf ( "cac: EPICS_CA_FLUSH_DELAY was not a positive number\n" );
+            }
+            else {
+                this->autoFlushDelay = delay;
+            }
+        }
+        long flushBytesAsALong;
+        status = envGetLongConfigParam ( &EPICS_CA_FLUSH_BYTES, &flushBytesAsALong );
+        if ( status || flushBytesAsALong < 0 ) {
+            errlogPrintf ( "cac: EPICS_CA_FLUSH_BYTES was not a positive integer\n" );
+        }
+        else {
+            this->autoFlushBytes = ( unsigned ) flushBytesAsALong;
+        }
+
         unsigned bufsPerArray = this->maxRecvBytesTCP / comBuf::capacityBytes ();
         if ( bufsPerArray > 1u ) {
             maxContigFrames = bufsPerArray *
@@ -397,6 +438,53 @@ void cac::flush ( epicsGuard < epicsMutex > & guard )
     }
 }
 
+int cac::latency ( epicsGuard < epicsMutex > & guard,
+    int select, struct ca_latency_summary & summary ) const
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    const timeHistogram * pTimes;
+    timeHistogram none;
+    switch ( select ) {
+    case ca_latency_get:
+        pTimes = & this->getTimes;
+        break;
+    case ca_latency_put_callback:
+        pTimes = & this->putCallbackTimes;
+        break;
+    case ca_latency_search:
+        pTimes = this->pudpiiu ?
+            & this->pudpiiu->searchResponseTimes ( guard ) : & none;
+        break;
+    case ca_latency_connect:
+        pTimes = & this->connectTimes;
+        break;
+    case ca_latency_echo:
+        pTimes = & this->echoTimes;
+        break;
+    default:
+        return ECA_BADTYPE;
+    }
+    summary.count = pTimes->count ();
+    summary.mean = pTimes->mean ();
+    summary.p50 = pTimes->percentile ( 0.5 );
+    summary.p90 = pTimes->percentile ( 0.9 );
+    summary.p99 = pTimes->percentile ( 0.99 );
+    summary.max = pTimes->maximum ();
+    return ECA_NORMAL;
+}
+
+int cac::messageBytes ( epicsGuard < epicsMutex > & guard,
+    unsigned command, double & sent, double & received ) const
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( command > CA_PROTO_LAST_CMMD ) {
+        return ECA_BADTYPE;
+    }
+    sent = this->bytesSent.bytes ( command );
+    received = this->bytesReceived.bytes ( command );
+    return ECA_NORMAL;
+}
+
 unsigned cac::circuitCount (
     epicsGuard < epicsMutex > & guard ) const
 {
@@ -415,6 +503,24 @@ void cac::show (
     // warning message
     ::printf ( "\trevision \"%s\"\n", pVersionCAC );
 
+    if ( this->pudpiiu ) {
+        this->pudpiiu->showSearchStatistics ( guard );
+        ::printf ( "\tbeacons received %lu from %u servers, "
+            "%u beacon anomalies\n", this->beaconCount,
+            this->beaconTable.numEntriesInstalled (),
+            this->beaconAnomalyCount );
+        this->pudpiiu->showBeaconAnomalyStatistics ( guard );
+    }
+    this->connectTimes.show ( "channels connected after search" );
+    this->getTimes.show ( "get responses" );
+    this->putCallbackTimes.show ( "put callback responses" );
+    this->echoTimes.show ( "echo round trips" );
+
+    if ( level > 0u ) {
+        this->bytesSent.show ( "sent over TCP" );
+        this->bytesReceived.show ( "received over TCP" );
+    }
+
     if ( level > 0u ) {
         this->serverTable.show ( level - 1u );
         ::printf ( "\tconnection time out watchdog period %f\n", this->connTMO );
@@ -461,6 +567,8 @@ void cac::beaconNotify ( const inetAddrID & addr, const epicsTime & currentTime,
         return;
     }
 
+    this->beaconCount++;
+
     /*
      * look for it in the hash table
      */
@@ -495,6 +603,14 @@ void cac::beaconNotify ( const inetAddrID & addr, const epicsTime & currentTime,
 
     this->beaconAnomalyCount++;
 
+    /*
+     * the disconnected channels last connected to this server
+     * are searched for again with the next batch of anomalies
+     */
+    if ( ! pBHE->anomalyPending ( guard ) ) {
+        pBHE->setAnomalyPending ( guard );
+        this->beaconAnomaliesPending++;
+    }
     this->pudpiiu->beaconAnomalyNotify ( guard );
 
 #   ifdef DEBUG
@@ -506,6 +622,27 @@ void cac::beaconNotify ( const inetAddrID & addr, const epicsTime & currentTime,
 #   endif
 }
 
+bool cac::beaconAnomalyPending (
+    epicsGuard < epicsMutex > & guard, const inetAddrID & addr ) const
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( this->beaconAnomaliesPending == 0u ) {
+        return false;
+    }
+    const bhe * pBHE = this->beaconTable.lookup ( addr );
+    return pBHE && pBHE->anomalyPending ( guard );
+}
+
+void cac::beaconAnomalyBatchComplete (
+    epicsGuard < epicsMutex > & guard )
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( this->beaconAnomaliesPending ) {
+        this->beaconTable.traverse ( & bhe::clearAnomalyPending );
+        this->beaconAnomaliesPending = 0u;
+    }
+}
+
 cacChannel & cac::createChannel (
     epicsGuard < epicsMutex > & guard, const char * pName,
     cacChannelNotify & chan, cacChannel::priLev pri )
@@ -831,24 +968,34 @@ bool cac::versionAction ( callbackManager &, tcpiiu & iiu,
     const epicsTime &, const caHdrLargeArray & msg, void * )
 {
     iiu.versionRespNotify ( msg );
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    iiu.roundTripProbe ( guard );
     return true;
 }
 
 bool cac::echoRespAction (
     callbackManager & mgr, tcpiiu & iiu,
-    const epicsTime & /* current */, const caHdrLargeArray &, void * )
+    const epicsTime & currentTime, const caHdrLargeArray &, void * )
 {
+    {
+        epicsGuard < epicsMutex > guard ( this->mutex );
+        iiu.echoRespNotify ( guard, currentTime );
+    }
     iiu.probeResponseNotify ( mgr.cbGuard );
     return true;
 }
 
 bool cac::writeNotifyRespAction (
     callbackManager &, tcpiiu &,
-    const epicsTime &, const caHdrLargeArray & hdr, void * )
+    const epicsTime & currentTime, const caHdrLargeArray & hdr, void * )
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
     baseNMIU * pmiu = this->ioTable.remove ( hdr.m_available );
     if ( pmiu ) {
+        epicsTime begin;
+        if ( pmiu->requestTime ( begin ) ) {
+            this->putCallbackTimes.add ( currentTime - begin );
+        }
         if ( hdr.m_cid == ECA_NORMAL ) {
             pmiu->completion ( guard, *this );
         }
@@ -860,23 +1007,33 @@ bool cac::writeNotifyRespAction (
     return true;
 }
 
-bool cac::readNotifyRespAction ( callbackManager &, tcpiiu & iiu,
-    const epicsTime &, const caHdrLargeArray & hdr, void * pMsgBdy )
+bool cac::readNotifyRespAction ( callbackManager & mgr, tcpiiu & iiu,
+    const epicsTime & currentTime, const caHdrLargeArray & hdr, void * pMsgBdy )
 {
-    epicsGuard < epicsMutex > guard ( this->mutex );
-
     /*
      * the channel id field is abused for
      * read notify status starting with CA V4.1
      */
     int caStatus;
-    if ( iiu.ca_v41_ok ( guard ) ) {
+    if ( iiu.ca_v41_ok ( mgr ) ) {
         caStatus = hdr.m_cid;
     }
     else {
         caStatus = ECA_NORMAL;
     }
 
+    /*
+     * convert the data buffer from net format to host format
+     * before the primary lock is taken - the message body
+     * belongs to this receive thread
+     */
+    if ( caStatus == ECA_NORMAL ) {
+        caStatus = caNetConvert (
+            hdr.m_dataType, pMsgBdy, pMsgBdy, false, hdr.m_count );
+    }
+
+    epicsGuard < epicsMutex > guard ( this->mutex );
+
     baseNMIU * pmiu = this->ioTable.remove ( hdr.m_available );
     //
     // The IO destroy routines take the call back mutex
@@ -892,13 +1049,11 @@ bool cac::readNotifyRespAction ( callbackManager &, tcpiiu & iiu,
             // this does *not* assign a new resource id
             this->ioTable.add ( *pmiu );
         }
-        if ( caStatus == ECA_NORMAL ) {
-            /*
-             * convert the data buffer from net
-             * format to host format
-             */
-            caStatus = caNetConvert (
-                hdr.m_dataType, pMsgBdy, pMsgBdy, false, hdr.m_count );
+        else {
+            epicsTime begin;
+            if ( pmiu->requestTime ( begin ) ) {
+                this->getTimes.add ( currentTime - begin );
+            }
         }
         if ( caStatus == ECA_NORMAL ) {
             pmiu->completion ( guard, *this,
@@ -922,7 +1077,7 @@ bool cac::searchRespAction ( callbackManager &, tcpiiu & iiu,
     return true;
 }
 
-bool cac::eventRespAction ( callbackManager &, tcpiiu &iiu,
+bool cac::eventRespAction ( callbackManager & mgr, tcpiiu &iiu,
     const epicsTime &, const caHdrLargeArray & hdr, void * pMsgBdy )
 {
     int caStatus;
@@ -935,19 +1090,29 @@ bool cac::eventRespAction ( callbackManager &, tcpiiu &iiu,
         return true;
     }
 
-    epicsGuard < epicsMutex > guard ( this->mutex );
-
     /*
      * the channel id field is abused for
      * read notify status starting with CA V4.1
      */
-    if ( iiu.ca_v41_ok ( guard ) ) {
+    if ( iiu.ca_v41_ok ( mgr ) ) {
         caStatus = hdr.m_cid;
     }
     else {
         caStatus = ECA_NORMAL;
     }
 
+    /*
+     * convert the data buffer from net format to host format
+     * before the primary lock is taken - the message body
+     * belongs to this receive thread
+     */
+    if ( caStatus == ECA_NORMAL ) {
+        caStatus = caNetConvert (
+            hdr.m_dataType, pMsgBdy, pMsgBdy, false, hdr.m_count );
+    }
+
+    epicsGuard < epicsMutex > guard ( this->mutex );
+
     //
     // The IO destroy routines take the call back mutex
     // when uninstalling and deleting the baseNMIU so there is
@@ -956,13 +1121,6 @@ bool cac::eventRespAction ( callbackManager &, tcpiiu &iiu,
     //
     baseNMIU * pmiu = this->ioTable.lookup ( hdr.m_available );
     if ( pmiu ) {
-        /*
-         * convert the data buffer from net format to host format
-         */
-        if ( caStatus == ECA_NORMAL ) {
-            caStatus = caNetConvert (
-                hdr.m_dataType, pMsgBdy, pMsgBdy, false, hdr.m_count );
-        }
         if ( caStatus == ECA_NORMAL ) {
             pmiu->completion ( guard, *this,
                 hdr.m_dataType, hdr.m_count, pMsgBdy );
@@ -1134,7 +1292,8 @@ bool cac::accessRightsRespAction (
 
 bool cac::createChannelRespAction (
     callbackManager & mgr, tcpiiu & iiu,
-    const epicsTime &, const caHdrLargeArray & hdr, void * /* pMsgBody */ )
+    const epicsTime & currentTime, const caHdrLargeArray & hdr,
+    void * /* pMsgBody */ )
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
     nciu * pChan = this->chanTable.lookup ( hdr.m_cid );
@@ -1148,6 +1307,8 @@ bool cac::createChannelRespAction (
         }
         bool wasExpected = iiu.connectNotify ( guard, *pChan );
         if ( wasExpected ) {
+            this->connectTimes.add (
+                currentTime - pChan->searchBeginTime ( guard ) );
             pChan->connect ( hdr.m_dataType, hdr.m_count, sidTmp,
                 mgr.cbGuard, guard );
         }
@@ -39,6 +39,8 @@
 #include "netIO.h"
 #include "localHostName.h"
 #include "virtualCircuit.h"
+#include "timeHistogram.h"
+#include "messageByteCounts.h"
 
 class netWriteNotifyIO;
 class netReadNotifyIO;
@@ -112,6 +114,9 @@ public:
         ca_uint32_t beaconNumber, unsigned protocolRevision );
     unsigned beaconAnomaliesSinceProgramStart (
         epicsGuard < epicsMutex > & ) const;
+    bool beaconAnomalyPending (
+        epicsGuard < epicsMutex > &, const inetAddrID & ) const;
+    void beaconAnomalyBatchComplete ( epicsGuard < epicsMutex > & );
 
     // IO management
     void flush ( epicsGuard < epicsMutex > & guard );
@@ -185,8 +190,15 @@ public:
         epicsGuard < epicsMutex > & callbackControl,
         const char *pformat, va_list args ) const;
     double connectionTimeout ( epicsGuard < epicsMutex > & );
+    int latency ( epicsGuard < epicsMutex > &,
+        int select, struct ca_latency_summary & ) const;
+    int messageBytes ( epicsGuard < epicsMutex > &, unsigned command,
+        double & sent, double & received ) const;
 
     unsigned maxContiguousFrames ( epicsGuard < epicsMutex > & ) const;
+    unsigned compressionThreshold ( epicsGuard < epicsMutex > & ) const;
+    double flushDelay () const;
+    unsigned flushBytes () const;
 
     // misc
     const char * userNamePointer () const;
@@ -264,7 +276,18 @@ private:
     unsigned initializingThreadsPriority;
     unsigned maxRecvBytesTCP;
     unsigned maxContigFrames;
+    unsigned compressThreshold;
+    double autoFlushDelay;
+    unsigned autoFlushBytes;
     unsigned beaconAnomalyCount;
+    unsigned beaconAnomaliesPending;
+    unsigned long beaconCount;
+    timeHistogram getTimes;
+    timeHistogram putCallbackTimes;
+    timeHistogram connectTimes;
+    timeHistogram echoTimes;
+    messageByteCounts bytesSent;
+    messageByteCounts bytesReceived;
     unsigned short _serverPort;
     unsigned iiuExistenceCount;
     bool cacShutdownInProgress;
@@ -417,6 +440,22 @@ inline unsigned cac ::
     return maxContigFrames;
 }
 
+inline unsigned cac ::
+    compressionThreshold ( epicsGuard < epicsMutex > & ) const
+{
+    return compressThreshold;
+}
+
+inline double cac :: flushDelay () const
+{
+    return autoFlushDelay;
+}
+
+inline unsigned cac :: flushBytes () const
+{
+    return autoFlushBytes;
+}
+
 inline double cac ::
     connectionTimeout ( epicsGuard < epicsMutex > & guard )
 {
@@ -30,6 +30,7 @@
 #include "iocinf.h"
 #include "localHostName.h"
 #include "cacIO.h"
+#include "caerr.h"
 
 class CACChannelPrivate {
 public:
@@ -137,8 +138,26 @@ const char * cacChannel::pHostName (
     return pCACChannelPrivate->pHostName ();
 }
 
+double cacChannel::roundTripTime (
+    epicsGuard < epicsMutex > & ) const
+{
+    return - DBL_MAX;
+}
+
 cacContext::~cacContext () {}
 
+int cacContext::latency ( epicsGuard < epicsMutex > &,
+    int, struct ca_latency_summary & ) const
+{
+    return ECA_UNAVAILINSERV;
+}
+
+int cacContext::messageBytes ( epicsGuard < epicsMutex > &,
+    unsigned, double &, double & ) const
+{
+    return ECA_UNAVAILINSERV;
+}
+
 cacService::~cacService () {}
 
 
@@ -56,6 +56,7 @@
 
 
 class cacChannel;
+struct ca_latency_summary;
 
 typedef unsigned long arrayElementCount;
 
@@ -246,6 +247,9 @@ public:
     // !! deprecated, avoid use  !!
     virtual const char * pHostName (
         epicsGuard < epicsMutex > & guard ) const throw ();
+    // added last to keep the layout of the table of virtual functions
+    virtual double roundTripTime (
+        epicsGuard < epicsMutex > & ) const; // negative DBL_MAX if UKN
 
     // exceptions
     class badString {};
@@ -286,6 +290,11 @@ public:
         epicsGuard < epicsMutex > & ) const = 0;
     virtual void show (
         epicsGuard < epicsMutex > &, unsigned level ) const = 0;
+    // ECA_XXXX status, see ca_client_latency and ca_client_message_bytes
+    virtual int latency ( epicsGuard < epicsMutex > &,
+        int select, struct ca_latency_summary & ) const;
+    virtual int messageBytes ( epicsGuard < epicsMutex > &,
+        unsigned command, double & sent, double & received ) const;
 };
 
 class LIBCA_API cacContextNotify {
@@ -217,6 +217,33 @@ LIBCA_API int epicsStdCall ca_create_channel
      chid           *pChanID
 );
 
+/*
+ * ca_create_channels ()
+ *
+ * Creates nChannels channels in one call, the same as calling
+ * ca_create_channel() for each name but with less locking overhead.
+ * Channels that can't be created have their id set to NULL, and the
+ * status of the first failure is returned.
+ *
+ * nChannels            R   number of channels
+ * pChanNames           R   array of channel name strings
+ * pConnStateCallback   R   address of connection state change
+ *                          callback function
+ * pUserPrivate         R   array of values for the channels' user private
+ *                          fields, or NULL
+ * priority             R   priority level in the server 0 - 100
+ * pChanIDs             RW  array where the channel ids are written
+ */
+LIBCA_API int epicsStdCall ca_create_channels
+(
+     unsigned           nChannels,
+     const char * const *pChanNames,
+     caCh               *pConnStateCallback,
+     void * const       *pUserPrivate,
+     capri              priority,
+     chid               *pChanIDs
+);
+
 /*
  * ca_change_connection_event()
  *
@@ -492,6 +519,37 @@ LIBCA_API int epicsStdCall ca_create_subscription
      evid *                 pEventID
 );
 
+/*
+ * ca_create_subscriptions ()
+ *
+ * Subscribes to nSubscriptions channels of the same context in one call,
+ * the same as calling ca_create_subscription() for each channel but
+ * with less locking overhead. Failed subscriptions have their event id
+ * set to NULL, and the status of the first failure is returned. A NULL
+ * channel id, as written by ca_create_channels() for a channel that
+ * couldn't be created, fails with ECA_BADCHID.
+ *
+ * nSubscriptions   R   number of subscriptions
+ * type             R   data type from db_access.h
+ * count            R   array element count
+ * pChanIDs         R   array of channel identifiers
+ * mask             R   event mask - one of {DBE_VALUE, DBE_ALARM, DBE_LOG}
+ * pFunc            R   pointer to call-back function
+ * pArgs            R   array of pointers passed to pFunc, or NULL
+ * pEventIDs        W   array where the event ids are written, or NULL
+ */
+LIBCA_API int epicsStdCall ca_create_subscriptions
+(
+     unsigned               nSubscriptions,
+     chtype                 type,
+     unsigned long          count,
+     const chid *           pChanIDs,
+     long                   mask,
+     caEventCallBackFunc *  pFunc,
+     void * const *         pArgs,
+     evid *                 pEventIDs
+);
+
 /************************************************************************/
 /*  Remove a function from a list of those specified to run             */
 /*  whenever significant changes occur to a channel                     */
@@ -509,6 +567,70 @@ LIBCA_API int epicsStdCall ca_clear_subscription
 
 LIBCA_API chid epicsStdCall ca_evid_to_chid ( evid id );
 
+/************************************************************************/
+/*  Limit the updates delivered to a slow subscriber                    */
+/************************************************************************/
+
+enum ca_subscription_policy_select
+{ ca_subscription_lossless, ca_subscription_latest, ca_subscription_windowed };
+
+/*
+ * ca_set_subscription_policy()
+ *
+ * By default every update is delivered (ca_subscription_lossless).
+ * With ca_subscription_latest an update waiting for its callback to run
+ * is replaced by a newer one, and with ca_subscription_windowed at most
+ * one update is delivered each window seconds. Updates for the latter
+ * two that arrive too soon are held, each replacing the one before, and
+ * the last is delivered once allowed. If bytesPerSecond is greater than
+ * zero it also limits the rate of the updates for the latter two.
+ *
+ * eventID          R   event id
+ * policy           R   one of the policies above
+ * window           R   seconds, for ca_subscription_windowed
+ * bytesPerSecond   R   the subscription's budget, or zero for no limit
+ */
+LIBCA_API int epicsStdCall ca_set_subscription_policy
+(
+     evid                                   eventID,
+     enum ca_subscription_policy_select     policy,
+     double                                 window,
+     double                                 bytesPerSecond
+);
+
+/************************************************************************/
+/*  Keep the data passed to a get or subscription callback after the   */
+/*  callback returns, without copying it                                */
+/************************************************************************/
+
+typedef struct ca_pinned_data ca_pinned_data;
+
+/*
+ * ca_pin_event_data()
+ *
+ * May only be called from within a get or subscription callback, with
+ * the dbr pointer passed to that callback. The data stays valid, and may
+ * be modified, until ca_unpin_event_data() is called. Returns NULL if the
+ * data can't be pinned, in which case it must be copied as usual. Pinned
+ * data must be unpinned before the context is destroyed.
+ *
+ * pDbr     R   args.dbr of the callback
+ */
+LIBCA_API ca_pinned_data * epicsStdCall ca_pin_event_data
+(
+     const void *   pDbr
+);
+
+/*
+ * ca_unpin_event_data()
+ *
+ * pPin     R   handle returned by ca_pin_event_data()
+ */
+LIBCA_API void epicsStdCall ca_unpin_event_data
+(
+     ca_pinned_data *   pPin
+);
+
 
 /************************************************************************/
 /*                                                                      */
@@ -825,6 +947,67 @@ LIBCA_API int epicsStdCall ca_replace_printf_handler (
 );
 #endif /*CA_DONT_INCLUDE_STDARGH*/
 
+/************************************************************************/
+/*  Client side performance measurements                                */
+/************************************************************************/
+
+enum ca_latency_select
+{ ca_latency_get, ca_latency_put_callback, ca_latency_search,
+  ca_latency_connect, ca_latency_echo };
+
+struct ca_latency_summary {
+    unsigned    count;  /* number of samples */
+    double      mean;   /* all in seconds */
+    double      p50;
+    double      p90;
+    double      p99;
+    double      max;
+};
+
+/*
+ * ca_client_latency()
+ *
+ * Summarizes the times measured by the current context since it was
+ * created: from a get (with or without callback) or a put callback
+ * request to its response, from the first search for a channel to
+ * its search response or to its connection, and the round trip time
+ * of the echo requests sent to the servers. The percentiles are
+ * upper bounds, at most 25% above the measured times.
+ *
+ * select       R   the times to summarize
+ * pSummary     W   the summary
+ */
+LIBCA_API int epicsStdCall ca_client_latency
+(
+     enum ca_latency_select     select,
+     struct ca_latency_summary  *pSummary
+);
+
+/*
+ * ca_client_message_bytes()
+ *
+ * The bytes sent and received over TCP by the current context in
+ * messages with the given CA_PROTO_XXX command, headers included.
+ *
+ * command      R   the message command
+ * pSent        W   bytes sent
+ * pReceived    W   bytes received
+ */
+LIBCA_API int epicsStdCall ca_client_message_bytes
+(
+     unsigned   command,
+     double     *pSent,
+     double     *pReceived
+);
+
+/*
+ * ca_round_trip_time()
+ *
+ * The mean round trip time of the echo requests sent to the server
+ * of the channel, or a negative number if it is not known yet.
+ */
+LIBCA_API double epicsStdCall ca_round_trip_time (chid chan);
+
 /*
  * (for testing purposes only)
  */
@@ -0,0 +1,374 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <new>
+
+#include "epicsGuard.h"
+#include "epicsStdio.h"
+#include "epicsTypes.h"
+#include "errlog.h"
+
+#include "iocinf.h"
+#include "oldAccess.h"
+#include "callbackExecutor.h"
+
+struct callbackItem : public tsDLNode < callbackItem > {
+    enum callbackType { event, connection, accessRights } type;
+    chid chan;
+    const void * pSource;
+    // the conflating subscription's pointer to this item, if any
+    void ** ppQueued;
+    size_t dataCapacity;
+    union {
+        caEventCallBackFunc * pEventFunc;
+        caCh * pConnFunc;
+        caArh * pAccessRightsFunc;
+    } func;
+    union {
+        event_handler_args event;
+        connection_handler_args connection;
+        access_rights_handler_args accessRights;
+    } args;
+    static callbackItem * create ( size_t dataSize );
+    void call ();
+    void destroy ();
+};
+
+// the data follows the item, suitably aligned for any DBR type
+static const size_t callbackItemSize =
+    ( sizeof ( callbackItem ) + 15u ) & ~ static_cast < size_t > ( 15u );
+
+callbackItem * callbackItem::create ( size_t dataSize )
+{
+    void * pBuf = malloc ( callbackItemSize + dataSize );
+    if ( ! pBuf ) {
+        throw std::bad_alloc ();
+    }
+    callbackItem * pItem = new ( pBuf ) callbackItem;
+    pItem->ppQueued = 0;
+    pItem->dataCapacity = dataSize;
+    return pItem;
+}
+
+void callbackItem::call ()
+{
+    switch ( this->type ) {
+    case event:
+        ( *this->func.pEventFunc ) ( this->args.event );
+        break;
+    case connection:
+        ( *this->func.pConnFunc ) ( this->args.connection );
+        break;
+    case accessRights:
+        ( *this->func.pAccessRightsFunc ) ( this->args.accessRights );
+        break;
+    }
+}
+
+void callbackItem::destroy ()
+{
+    this->~callbackItem ();
+    free ( this );
+}
+
+callbackExecutorThread::callbackExecutorThread (
+        callbackExecutor & executorIn, const char * pName,
+        unsigned priority ) :
+    thread ( *this, pName,
+        epicsThreadGetStackSize ( epicsThreadStackBig ), priority ),
+    executor ( executorIn ), runningChan ( 0 ), pRunningSource ( 0 )
+{
+}
+
+callbackExecutorThread::~callbackExecutorThread ()
+{
+    while ( callbackItem * pItem = this->queue.get () ) {
+        pItem->destroy ();
+    }
+}
+
+void callbackExecutorThread::start ()
+{
+    this->thread.start ();
+}
+
+void callbackExecutorThread::exitWait ()
+{
+    this->wakeup.signal ();
+    this->thread.exitWait ();
+}
+
+void callbackExecutorThread::run ()
+{
+    // so that the callbacks can use the context
+    ca_attach_context ( & this->executor.ctx );
+
+    epicsGuard < epicsMutex > guard ( this->executor.mutex );
+    while ( ! this->executor.shutdownRequested ) {
+        callbackItem * pItem = this->queue.first ();
+        if ( ! pItem ) {
+            epicsGuardRelease < epicsMutex > unguard ( guard );
+            this->wakeup.wait ();
+            continue;
+        }
+        this->executor.dequeue ( *this, *pItem );
+        this->runningChan = pItem->chan;
+        this->pRunningSource = pItem->pSource;
+        {
+            epicsGuardRelease < epicsMutex > unguard ( guard );
+            pItem->call ();
+            pItem->destroy ();
+        }
+        this->runningChan = 0;
+        this->pRunningSource = 0;
+        this->executor.nExecuted++;
+        if ( this->executor.nWaiting ) {
+            this->executor.idle.signal ();
+        }
+    }
+
+    ca_detach_context ();
+}
+
+callbackExecutor::callbackExecutor (
+        ca_client_context & ctxIn, unsigned nThreadsIn ) :
+    ctx ( ctxIn ), pThreads ( new callbackExecutorThread * [nThreadsIn] ),
+    nThreads ( nThreadsIn ), nQueued ( 0u ), maxQueued ( 0u ),
+    nWaiting ( 0u ), nExecuted ( 0u ), nConflated ( 0u ),
+    shutdownRequested ( false )
+{
+    unsigned priority = epicsThreadGetPrioritySelf ();
+    for ( unsigned i = 0u; i < this->nThreads; i++ ) {
+        char name[32];
+        epicsSnprintf ( name, sizeof ( name ), "CAC-callback-%u", i );
+        this->pThreads[i] = new callbackExecutorThread ( *this, name, priority );
+    }
+    for ( unsigned i = 0u; i < this->nThreads; i++ ) {
+        this->pThreads[i]->start ();
+    }
+}
+
+callbackExecutor::~callbackExecutor ()
+{
+    this->shutdown ();
+    for ( unsigned i = 0u; i < this->nThreads; i++ ) {
+        delete this->pThreads[i];
+    }
+    delete [] this->pThreads;
+}
+
+// callbacks still queued are discarded, and no more are accepted
+void callbackExecutor::shutdown ()
+{
+    {
+        epicsGuard < epicsMutex > guard ( this->mutex );
+        if ( this->shutdownRequested ) {
+            return;
+        }
+        this->shutdownRequested = true;
+    }
+    for ( unsigned i = 0u; i < this->nThreads; i++ ) {
+        this->pThreads[i]->exitWait ();
+    }
+}
+
+callbackExecutorThread & callbackExecutor::threadFor ( chid chan ) const
+{
+    // the channels are allocated at a fixed stride, so mix the bits
+    size_t addr = reinterpret_cast < size_t > ( chan );
+    epicsUInt32 hash = static_cast < epicsUInt32 > ( addr ^ ( addr >> 16u >> 16u ) );
+    hash *= 0x9e3779b1u;
+    return * this->pThreads[ ( hash >> 16u ) % this->nThreads ];
+}
+
+void callbackExecutor::post ( callbackItem & item )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    if ( this->shutdownRequested ) {
+        item.destroy ();
+        return;
+    }
+    if ( item.ppQueued ) {
+        *item.ppQueued = & item;
+    }
+    callbackExecutorThread & thr = this->threadFor ( item.chan );
+    bool wasEmpty = thr.queue.count () == 0u;
+    thr.queue.add ( item );
+    this->nQueued++;
+    if ( this->nQueued > this->maxQueued ) {
+        this->maxQueued = this->nQueued;
+    }
+    if ( wasEmpty ) {
+        thr.wakeup.signal ();
+    }
+}
+
+void callbackExecutor::dequeue (
+    callbackExecutorThread & thr, callbackItem & item )
+{
+    thr.queue.remove ( item );
+    this->nQueued--;
+    if ( item.ppQueued ) {
+        *item.ppQueued = 0;
+        item.ppQueued = 0;
+    }
+}
+
+//
+// The data, if any, is copied because the receive buffer is reused.
+// If ppQueued isn't nil then the update replaces the one that it
+// points to. It keeps that update's place in the queue unless other
+// callbacks for the channel were queued since, when it goes at the
+// end to keep them in order. *ppQueued is set to nil once the update
+// is run or discarded.
+//
+void callbackExecutor::postEvent ( caEventCallBackFunc * pFunc,
+    const event_handler_args & args, const void * pSource,
+    void ** ppQueued )
+{
+    size_t dataSize = 0u;
+    if ( args.dbr ) {
+        dataSize = dbr_size_n ( args.type, args.count );
+    }
+    if ( ppQueued ) {
+        epicsGuard < epicsMutex > guard ( this->mutex );
+        callbackItem * pQueued = static_cast < callbackItem * > ( *ppQueued );
+        if ( pQueued && pQueued->dataCapacity >= dataSize ) {
+            // look for later callbacks for the channel
+            tsDLIter < callbackItem > pLater = this->threadFor (
+                pQueued->chan ).queue.lastIter ();
+            while ( pLater.pointer () != pQueued &&
+                    pLater->chan != pQueued->chan ) {
+                pLater--;
+            }
+            if ( pLater.pointer () == pQueued ) {
+                pQueued->func.pEventFunc = pFunc;
+                pQueued->args.event = args;
+                if ( args.dbr ) {
+                    void * pData = reinterpret_cast < char * > ( pQueued ) +
+                        callbackItemSize;
+                    memcpy ( pData, args.dbr, dataSize );
+                    pQueued->args.event.dbr = pData;
+                }
+                this->nConflated++;
+                return;
+            }
+        }
+        if ( pQueued ) {
+            this->dequeue ( this->threadFor ( pQueued->chan ), *pQueued );
+            this->nConflated++;
+            epicsGuardRelease < epicsMutex > unguard ( guard );
+            pQueued->destroy ();
+        }
+    }
+    callbackItem * pItem = callbackItem::create ( dataSize );
+    pItem->type = callbackItem::event;
+    pItem->chan = args.chid;
+    pItem->pSource = pSource;
+    pItem->func.pEventFunc = pFunc;
+    pItem->args.event = args;
+    if ( args.dbr ) {
+        void * pData = reinterpret_cast < char * > ( pItem ) + callbackItemSize;
+        memcpy ( pData, args.dbr, dataSize );
+        pItem->args.event.dbr = pData;
+    }
+    pItem->ppQueued = ppQueued;
+    this->post ( *pItem );
+}
+
+void callbackExecutor::postConnection ( caCh * pFunc,
+    const connection_handler_args & args )
+{
+    callbackItem * pItem = callbackItem::create ( 0u );
+    pItem->type = callbackItem::connection;
+    pItem->chan = args.chid;
+    pItem->pSource = 0;
+    pItem->func.pConnFunc = pFunc;
+    pItem->args.connection = args;
+    this->post ( *pItem );
+}
+
+void callbackExecutor::postAccessRights ( caArh * pFunc,
+    const access_rights_handler_args & args )
+{
+    callbackItem * pItem = callbackItem::create ( 0u );
+    pItem->type = callbackItem::accessRights;
+    pItem->chan = args.chid;
+    pItem->pSource = 0;
+    pItem->func.pAccessRightsFunc = pFunc;
+    pItem->args.accessRights = args;
+    this->post ( *pItem );
+}
+
+//
+// Discards the queued callbacks for a channel, or only those from one
+// of its subscriptions if pSource isn't nil. It may be called with
+// the client library's locks applied.
+//
+void callbackExecutor::purge ( chid chan, const void * pSource )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    callbackExecutorThread & thr = this->threadFor ( chan );
+    tsDLIter < callbackItem > pItem = thr.queue.firstIter ();
+    while ( pItem.valid () ) {
+        tsDLIter < callbackItem > pNext = pItem;
+        pNext++;
+        if ( pItem->chan == chan &&
+                ( ! pSource || pItem->pSource == pSource ) ) {
+            this->dequeue ( thr, *pItem );
+            pItem->destroy ();
+        }
+        pItem = pNext;
+    }
+}
+
+//
+// Waits for a callback for the channel (or subscription) that is
+// running to finish. It must be called without the client library's
+// locks. It doesn't wait when called by the thread that runs the
+// channel's callbacks, which may be running that callback, but a
+// callback on one pool thread waits for a callback on another.
+//
+void callbackExecutor::waitIdle ( chid chan, const void * pSource )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    callbackExecutorThread & thr = this->threadFor ( chan );
+    if ( thr.thread.getId () == epicsThreadGetIdSelf () ) {
+        return;
+    }
+    while ( thr.runningChan == chan &&
+            ( ! pSource || thr.pRunningSource == pSource ) ) {
+        this->nWaiting++;
+        {
+            // the timeout covers a wakeup taken by another waiter
+            epicsGuardRelease < epicsMutex > unguard ( guard );
+            this->idle.wait ( 0.1 );
+        }
+        this->nWaiting--;
+    }
+    // pass the wakeup on to any other waiters
+    if ( this->nWaiting ) {
+        this->idle.signal ();
+    }
+}
+
+void callbackExecutor::show ( unsigned level ) const
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    ::printf ( "\tcallbacks run by %u threads: %lu run, %u queued, at most %u queued\n",
+        this->nThreads, this->nExecuted, this->nQueued, this->maxQueued );
+    ::printf ( "\t%lu queued subscription updates replaced by newer ones\n",
+        this->nConflated );
+    if ( level > 1u ) {
+        for ( unsigned i = 0u; i < this->nThreads; i++ ) {
+            ::printf ( "\t\tthread %u: %u queued\n", i,
+                this->pThreads[i]->queue.count () );
+        }
+    }
+}
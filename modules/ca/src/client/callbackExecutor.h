@@ -0,0 +1,85 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// Runs the user callbacks of a preemptive callback context on a pool
+// of threads (EPICS_CA_CALLBACK_THREADS) so that a slow callback
+// doesn't stall the circuit's receive thread. The receive thread
+// copies the callback's arguments and data into a queue, and all of
+// the callbacks for one channel are run by the same thread in the
+// order that they were queued. An update for a subscription that
+// only wants the latest value replaces its update that is still
+// queued.
+//
+
+#ifndef INC_callbackExecutor_H
+#define INC_callbackExecutor_H
+
+#include "epicsMutex.h"
+#include "epicsEvent.h"
+#include "epicsThread.h"
+#include "tsDLList.h"
+
+#include "cadef.h"
+
+struct ca_client_context;
+class callbackExecutor;
+struct callbackItem;
+
+class callbackExecutorThread : private epicsThreadRunable {
+public:
+    callbackExecutorThread ( callbackExecutor &,
+        const char * pName, unsigned priority );
+    ~callbackExecutorThread ();
+    void start ();
+    void exitWait ();
+private:
+    tsDLList < callbackItem > queue;
+    epicsThread thread;
+    epicsEvent wakeup;
+    callbackExecutor & executor;
+    chid runningChan;
+    const void * pRunningSource;
+    void run ();
+    friend class callbackExecutor;
+    callbackExecutorThread ( const callbackExecutorThread & );
+    callbackExecutorThread & operator = ( const callbackExecutorThread & );
+};
+
+class callbackExecutor {
+public:
+    callbackExecutor ( ca_client_context &, unsigned nThreads );
+    ~callbackExecutor ();
+    void postEvent ( caEventCallBackFunc *,
+        const event_handler_args &, const void * pSource,
+        void ** ppQueued = 0 );
+    void postConnection ( caCh *, const connection_handler_args & );
+    void postAccessRights ( caArh *, const access_rights_handler_args & );
+    void purge ( chid, const void * pSource );
+    void waitIdle ( chid, const void * pSource );
+    void shutdown ();
+    void show ( unsigned level ) const;
+private:
+    mutable epicsMutex mutex;
+    epicsEvent idle;
+    ca_client_context & ctx;
+    callbackExecutorThread ** pThreads;
+    const unsigned nThreads;
+    unsigned nQueued;
+    unsigned maxQueued;
+    unsigned nWaiting;
+    unsigned long nExecuted;
+    unsigned long nConflated;
+    bool shutdownRequested;
+    callbackExecutorThread & threadFor ( chid ) const;
+    void post ( callbackItem & );
+    void dequeue ( callbackExecutorThread &, callbackItem & );
+    friend class callbackExecutorThread;
+    callbackExecutor ( const callbackExecutor & );
+    callbackExecutor & operator = ( const callbackExecutor & );
+};
+
+#endif // ifndef INC_callbackExecutor_H
@@ -79,9 +79,11 @@ const char cacNillBytes [] =
 };
 
 comQueSend::comQueSend ( wireSendAdapter & wireIn,
-    comBufMemoryManager & comBufMemMgrIn ):
+    comBufMemoryManager & comBufMemMgrIn,
+    messageByteCounts & byteCountsIn ):
         comBufMemMgr ( comBufMemMgrIn ), wire ( wireIn ),
-            nBytesPending ( 0u )
+        byteCounts ( byteCountsIn ), nBytesPending ( 0u ),
+        msgRequest ( CA_PROTO_VERSION )
 {
 }
 
@@ -282,6 +284,7 @@ void comQueSend::insertRequestHeader (
     ca_uint16_t dataType, ca_uint32_t nElem, ca_uint32_t cid,
     ca_uint32_t requestDependent, bool v49Ok )
 {
+    this->msgRequest = request;
     if ( payloadSize < 0xffff && nElem < 0xffff ) {
         comBuf * pComBuf = this->bufs.last ();
         if ( ! pComBuf || pComBuf->unoccupiedBytes() < 16u ) {
@@ -384,11 +387,14 @@ void comQueSend::insertRequestWithPayLoad (
 
 void comQueSend::commitMsg ()
 {
+    unsigned nBytesThisMsg = 0u;
     while ( this->pFirstUncommited.valid() ) {
-        this->nBytesPending += this->pFirstUncommited->uncommittedBytes ();
+        nBytesThisMsg += this->pFirstUncommited->uncommittedBytes ();
         this->pFirstUncommited->commitIncomming ();
         this->pFirstUncommited++;
     }
+    this->nBytesPending += nBytesThisMsg;
+    this->byteCounts.add ( this->msgRequest, nBytesThisMsg );
     // printf ( "NBP: %u\n", this->nBytesPending );
 }
 
@@ -31,6 +31,7 @@
 
 #include "tsDLList.h"
 #include "comBuf.h"
+#include "messageByteCounts.h"
 
 #define comQueSendCopyDispatchSize 39
 
@@ -53,7 +54,8 @@ private:
 //
 class comQueSend {
 public:
-    comQueSend ( wireSendAdapter &, comBufMemoryManager & );
+    comQueSend ( wireSendAdapter &, comBufMemoryManager &,
+        messageByteCounts & );
     ~comQueSend ();
     void clear ();
     unsigned occupiedBytes () const;
@@ -77,7 +79,9 @@ private:
     tsDLList < comBuf > bufs;
     tsDLIter < comBuf > pFirstUncommited;
     wireSendAdapter & wire;
+    messageByteCounts & byteCounts;
     unsigned nBytesPending;
+    ca_uint16_t msgRequest; // of the message being built
 
     typedef void ( comQueSend::*copyScalarFunc_t ) (
         const void * pValue );
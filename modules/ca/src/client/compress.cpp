@@ -0,0 +1,169 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+/*
+ *  Compression of CA response payloads (CA_COMPRESS_SHUFFLE_RLE)
+ *
+ *  The payload is treated as an array of elements of stride bytes,
+ *  already in network byte order. Each byte plane (byte k of every
+ *  element) is encoded separately, as the differences between the
+ *  successive bytes in that plane, so that slowly changing values
+ *  and unused high order bytes become runs of zeros. The differences
+ *  are run length encoded using a control byte:
+ *
+ *      0x00 - 0x7f     the next c + 1 bytes are literal differences
+ *      0x80 - 0xff     the next byte is repeated (c & 0x7f) + 3 times
+ *
+ *  A run never crosses from one plane to the next.
+ */
+
+#include "caProto.h"
+#include "caerr.h"
+#include "net_convert.h"
+
+static const unsigned minRun = 3u;
+static const unsigned maxRun = 0x7fu + minRun;
+static const unsigned maxLiteral = 0x80u;
+
+namespace {
+
+// the differences along one byte plane of the source
+class planeReader {
+public:
+    planeReader ( const ca_uint8_t * pPlane, unsigned stride ) :
+        p ( pPlane ), stride ( stride ) {}
+    ca_uint8_t operator [] ( unsigned i ) const
+    {
+        const ca_uint8_t * pi = p + i * stride;
+        return static_cast < ca_uint8_t > ( i ? *pi - *( pi - stride ) : *pi );
+    }
+private:
+    const ca_uint8_t * p;
+    const unsigned stride;
+};
+
+}
+
+/*
+ * Returns the size of the compressed data, or zero if it would
+ * not fit in destSize bytes
+ */
+unsigned caNetCompress ( const void * pSrc, unsigned size, unsigned stride,
+    void * pDest, unsigned destSize )
+{
+    const ca_uint8_t * pIn = static_cast < const ca_uint8_t * > ( pSrc );
+    ca_uint8_t * pOut = static_cast < ca_uint8_t * > ( pDest );
+    ca_uint8_t * pEnd = pOut + destSize;
+
+    if ( stride == 0u || size % stride ) {
+        return 0u;
+    }
+    const unsigned n = size / stride;
+
+    for ( unsigned plane = 0u; plane < stride; plane++ ) {
+        planeReader d ( pIn + plane, stride );
+        unsigned i = 0u;
+        while ( i < n ) {
+            ca_uint8_t b = d[i];
+            unsigned run = 1u;
+            while ( i + run < n && run < maxRun && d[i + run] == b ) {
+                run++;
+            }
+            if ( run >= minRun ) {
+                if ( pEnd - pOut < 2 ) {
+                    return 0u;
+                }
+                *pOut++ = static_cast < ca_uint8_t > ( 0x80u | ( run - minRun ) );
+                *pOut++ = b;
+                i += run;
+                continue;
+            }
+            // literals up to the start of the next run
+            unsigned first = i;
+            unsigned count = 0u;
+            ca_uint8_t b1 = b;
+            ca_uint8_t b2 = i + 1u < n ? d[i + 1u] : 0u;
+            while ( i < n && count < maxLiteral ) {
+                ca_uint8_t b3 = i + 2u < n ? d[i + 2u] : 0u;
+                if ( i + 2u < n && b1 == b2 && b2 == b3 ) {
+                    break;
+                }
+                b1 = b2;
+                b2 = b3;
+                i++;
+                count++;
+            }
+            if ( static_cast < unsigned > ( pEnd - pOut ) < count + 1u ) {
+                return 0u;
+            }
+            *pOut++ = static_cast < ca_uint8_t > ( count - 1u );
+            for ( unsigned k = 0u; k < count; k++ ) {
+                *pOut++ = d[first + k];
+            }
+        }
+    }
+    return static_cast < unsigned > (
+        pOut - static_cast < ca_uint8_t * > ( pDest ) );
+}
+
+/*
+ * Decodes exactly destSize bytes, returns ECA_NORMAL or
+ * ECA_BADCOUNT if the compressed data is malformed
+ */
+int caNetUncompress ( const void * pSrc, unsigned srcSize, unsigned stride,
+    void * pDest, unsigned destSize )
+{
+    const ca_uint8_t * pIn = static_cast < const ca_uint8_t * > ( pSrc );
+    const ca_uint8_t * pEnd = pIn + srcSize;
+
+    if ( stride == 0u || destSize % stride ) {
+        return ECA_BADCOUNT;
+    }
+    const unsigned n = destSize / stride;
+
+    for ( unsigned plane = 0u; plane < stride; plane++ ) {
+        ca_uint8_t * pOut = static_cast < ca_uint8_t * > ( pDest ) + plane;
+        ca_uint8_t prev = 0u;
+        unsigned i = 0u;
+        while ( i < n ) {
+            if ( pIn >= pEnd ) {
+                return ECA_BADCOUNT;
+            }
+            unsigned c = *pIn++;
+            if ( c & 0x80u ) {
+                unsigned run = ( c & 0x7fu ) + minRun;
+                if ( pIn >= pEnd || run > n - i ) {
+                    return ECA_BADCOUNT;
+                }
+                ca_uint8_t b = *pIn++;
+                if ( b == 0u ) {
+                    for ( unsigned k = 0u; k < run; k++ ) {
+                        pOut[( i + k ) * stride] = prev;
+                    }
+                }
+                else {
+                    for ( unsigned k = 0u; k < run; k++ ) {
+                        prev = static_cast < ca_uint8_t > ( prev + b );
+                        pOut[( i + k ) * stride] = prev;
+                    }
+                }
+                i += run;
+            }
+            else {
+                unsigned count = c + 1u;
+                if ( count > n - i ||
+                        static_cast < unsigned > ( pEnd - pIn ) < count ) {
+                    return ECA_BADCOUNT;
+                }
+                for ( unsigned k = 0u; k < count; k++ ) {
+                    prev = static_cast < ca_uint8_t > ( prev + *pIn++ );
+                    pOut[( i + k ) * stride] = prev;
+                }
+                i += count;
+            }
+        }
+    }
+    return ECA_NORMAL;
+}
@@ -97,6 +97,95 @@ inline epicsUInt32 dbr_htonl ( const epicsUInt32 & host )
     return tmp;
 }
 
+/*
+ * Bulk byte swap of arrays for the common little endian IEEE host.
+ * Swapping is its own inverse, so the direction doesn't matter.
+ * Source and destination must be identical or not overlap.
+ * Elements are copied through memcpy() to respect aliasing rules.
+ * GCC turns the scalar 32 and 64 bit swaps into bswap instructions,
+ * but can't vectorize those with SSE2 alone, so x86 gets explicit
+ * SSE2 loops.  SSE2 is always present on x86-64.
+ */
+#if EPICS_BYTE_ORDER == EPICS_ENDIAN_LITTLE && \
+    EPICS_FLOAT_WORD_ORDER == EPICS_ENDIAN_LITTLE
+#   define CA_BULK_SWAP
+
+#if defined ( __SSE2__ ) || defined ( _M_X64 )
+#   include <emmintrin.h>
+#   define CA_BULK_SWAP_SSE2
+#endif
+
+inline epicsUInt32 swap32 ( epicsUInt32 v )
+{
+    return ( v >> 24u ) | ( ( v >> 8u ) & 0xff00u ) |
+        ( ( v << 8u ) & 0xff0000u ) | ( v << 24u );
+}
+
+static void bulkSwap16 ( const void * s, void * d, arrayElementCount num )
+{
+    const char * pSrc = static_cast < const char * > ( s );
+    char * pDest = static_cast < char * > ( d );
+    /* the compiler vectorizes this one without help */
+    for ( arrayElementCount i = 0; i < num; i++ ) {
+        epicsUInt16 v;
+        memcpy ( &v, pSrc + 2 * i, 2 );
+        v = static_cast < epicsUInt16 > ( ( v << 8u ) | ( v >> 8u ) );
+        memcpy ( pDest + 2 * i, &v, 2 );
+    }
+}
+
+static void bulkSwap32 ( const void * s, void * d, arrayElementCount num )
+{
+    const char * pSrc = static_cast < const char * > ( s );
+    char * pDest = static_cast < char * > ( d );
+    arrayElementCount i = 0;
+#ifdef CA_BULK_SWAP_SSE2
+    for ( ; i + 4u <= num; i += 4u ) {
+        __m128i v = _mm_loadu_si128 (
+            reinterpret_cast < const __m128i * > ( pSrc + 4 * i ) );
+        /* swap bytes in each 16 bit word, then the words */
+        v = _mm_or_si128 ( _mm_slli_epi16 ( v, 8 ), _mm_srli_epi16 ( v, 8 ) );
+        v = _mm_shufflelo_epi16 ( v, _MM_SHUFFLE ( 2, 3, 0, 1 ) );
+        v = _mm_shufflehi_epi16 ( v, _MM_SHUFFLE ( 2, 3, 0, 1 ) );
+        _mm_storeu_si128 ( reinterpret_cast < __m128i * > ( pDest + 4 * i ), v );
+    }
+#endif
+    for ( ; i < num; i++ ) {
+        epicsUInt32 v;
+        memcpy ( &v, pSrc + 4 * i, 4 );
+        v = swap32 ( v );
+        memcpy ( pDest + 4 * i, &v, 4 );
+    }
+}
+
+static void bulkSwap64 ( const void * s, void * d, arrayElementCount num )
+{
+    const char * pSrc = static_cast < const char * > ( s );
+    char * pDest = static_cast < char * > ( d );
+    arrayElementCount i = 0;
+#ifdef CA_BULK_SWAP_SSE2
+    for ( ; i + 2u <= num; i += 2u ) {
+        __m128i v = _mm_loadu_si128 (
+            reinterpret_cast < const __m128i * > ( pSrc + 8 * i ) );
+        /* swap bytes in each 16 bit word, then reverse the words */
+        v = _mm_or_si128 ( _mm_slli_epi16 ( v, 8 ), _mm_srli_epi16 ( v, 8 ) );
+        v = _mm_shufflelo_epi16 ( v, _MM_SHUFFLE ( 0, 1, 2, 3 ) );
+        v = _mm_shufflehi_epi16 ( v, _MM_SHUFFLE ( 0, 1, 2, 3 ) );
+        _mm_storeu_si128 ( reinterpret_cast < __m128i * > ( pDest + 8 * i ), v );
+    }
+#endif
+    for ( ; i < num; i++ ) {
+        epicsUInt32 lo, hi;
+        memcpy ( &lo, pSrc + 8 * i, 4 );
+        memcpy ( &hi, pSrc + 8 * i + 4, 4 );
+        lo = swap32 ( lo );
+        hi = swap32 ( hi );
+        memcpy ( pDest + 8 * i, &hi, 4 );
+        memcpy ( pDest + 8 * i + 4, &lo, 4 );
+    }
+}
+#endif
+
 /*
  * if hton is true then it is a host to network conversion
  * otherwise vise-versa
@@ -137,6 +226,12 @@ arrayElementCount   num         /* number of values     */
     dbr_short_t         *pSrc = (dbr_short_t *) s;
     dbr_short_t         *pDest = (dbr_short_t *) d;
 
+#ifdef CA_BULK_SWAP
+    if ( num > 1 ) {
+        bulkSwap16 ( pSrc, pDest, num );
+        return;
+    }
+#endif
     if(encode){
         for(arrayElementCount i=0; i<num; i++){
             pDest[i] = dbr_htons( pSrc[i] );
@@ -187,6 +282,12 @@ arrayElementCount   num         /* number of values     */
     dbr_long_t          *pSrc = (dbr_long_t *) s;
     dbr_long_t          *pDest = (dbr_long_t *) d;
 
+#ifdef CA_BULK_SWAP
+    if ( num > 1 ) {
+        bulkSwap32 ( pSrc, pDest, num );
+        return;
+    }
+#endif
     if(encode){
         for(arrayElementCount i=0; i<num; i++){
             pDest[i] = dbr_htonl( pSrc[i] );
@@ -216,6 +317,12 @@ arrayElementCount   num         /* number of values     */
     dbr_enum_t          *pSrc = (dbr_enum_t *) s;
     dbr_enum_t          *pDest = (dbr_enum_t *) d;
 
+#ifdef CA_BULK_SWAP
+    if ( num > 1 ) {
+        bulkSwap16 ( pSrc, pDest, num );
+        return;
+    }
+#endif
     if(encode){
         for(arrayElementCount i=0; i<num; i++){
             pDest[i] = dbr_htons ( pSrc[i] );
@@ -247,6 +354,12 @@ arrayElementCount   num         /* number of values     */
     const dbr_float_t   *pSrc = (const dbr_float_t *) s;
     dbr_float_t         *pDest = (dbr_float_t *) d;
 
+#ifdef CA_BULK_SWAP
+    if ( num > 1 ) {
+        bulkSwap32 ( pSrc, pDest, num );
+        return;
+    }
+#endif
     if(encode){
         for(arrayElementCount i=0; i<num; i++){
             dbr_htonf ( &pSrc[i], &pDest[i] );
@@ -272,6 +385,12 @@ arrayElementCount   num         /* number of values     */
     dbr_double_t        *pSrc = (dbr_double_t *) s;
     dbr_double_t        *pDest = (dbr_double_t *) d;
 
+#ifdef CA_BULK_SWAP
+    if ( num > 1 ) {
+        bulkSwap64 ( pSrc, pDest, num );
+        return;
+    }
+#endif
     if(encode){
         for(arrayElementCount i=0; i<num; i++){
             dbr_htond ( &pSrc[i], &pDest[i] );
@@ -1080,7 +1199,7 @@ arrayElementCount   num         /* number of values     */
         pDest->value = dbr_ntohl(pSrc->value);
     else        /* array chan-- multiple pts */
     {
-        cvrt_long(&pDest->value, &pSrc->value, encode, num);
+        cvrt_long(&pSrc->value, &pDest->value, encode, num);
     }
 }
 
@@ -1300,7 +1419,7 @@ arrayElementCount   num         /* number of values     */
         pDest->value = dbr_ntohl(pSrc->value);
     else        /* array chan-- multiple pts */
     {
-        cvrt_long(&pDest->value, &pSrc->value, encode, num);
+        cvrt_long(&pSrc->value, &pDest->value, encode, num);
     }
 }
 
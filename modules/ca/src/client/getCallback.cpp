@@ -55,8 +55,12 @@ void getCallback::completion (
     caEventCallBackFunc * pFuncTmp = this->pFunc;
     // fetch client context and destroy prior to releasing
     // the lock and calling cb in case they destroy channel there
+    callbackExecutor * pExecutor = this->chan.getClientCtx().executor ();
     this->chan.getClientCtx().destroyGetCallback ( guard, *this );
-    if ( pFuncTmp ) {
+    if ( pFuncTmp && pExecutor ) {
+        pExecutor->postEvent ( pFuncTmp, args, 0 );
+    }
+    else if ( pFuncTmp ) {
         epicsGuardRelease < epicsMutex > unguard ( guard );
         pFuncTmp ( args );
     }
@@ -78,8 +82,12 @@ void getCallback::exception (
         caEventCallBackFunc * pFuncTmp = this->pFunc;
         // fetch client context and destroy prior to releasing
         // the lock and calling cb in case they destroy channel there
+        callbackExecutor * pExecutor = this->chan.getClientCtx().executor ();
         this->chan.getClientCtx().destroyGetCallback ( guard, *this );
-        {
+        if ( pExecutor ) {
+            pExecutor->postEvent ( pFuncTmp, args, 0 );
+        }
+        else {
             epicsGuardRelease < epicsMutex > unguard ( guard );
             ( *pFuncTmp ) ( args );
         }
@@ -0,0 +1,80 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// Bytes of each type of CA message sent or received, headers included.
+// Adding a message is an indexed addition and no allocation.
+//
+
+#ifndef INC_messageByteCounts_H
+#define INC_messageByteCounts_H
+
+#include <stdio.h>
+#include <string.h>
+
+#include "epicsTypes.h"
+#include "caProto.h"
+
+class messageByteCounts {
+public:
+    messageByteCounts ();
+    void add ( unsigned command, unsigned nBytes );
+    void moveTo ( messageByteCounts & );
+    double bytes ( unsigned command ) const;
+    void show ( const char * pName ) const;
+private:
+    enum { nCommands = CA_PROTO_LAST_CMMD + 1u };
+    epicsUInt64 counts [ nCommands ];
+};
+
+inline messageByteCounts::messageByteCounts ()
+{
+    memset ( this->counts, 0, sizeof ( this->counts ) );
+}
+
+inline void messageByteCounts::add ( unsigned command, unsigned nBytes )
+{
+    if ( command < nCommands ) {
+        this->counts[command] += nBytes;
+    }
+}
+
+// adds these counts to dest and clears them
+inline void messageByteCounts::moveTo ( messageByteCounts & dest )
+{
+    for ( unsigned i = 0u; i < nCommands; i++ ) {
+        dest.counts[i] += this->counts[i];
+        this->counts[i] = 0u;
+    }
+}
+
+inline double messageByteCounts::bytes ( unsigned command ) const
+{
+    return command < nCommands ?
+        static_cast < double > ( this->counts[command] ) : 0.0;
+}
+
+inline void messageByteCounts::show ( const char * pName ) const
+{
+    static const char * const pCommandNames [ nCommands ] = {
+        "version", "event add", "event cancel", "read", "write",
+        "snapshot", "search", "build", "events off", "events on",
+        "read sync", "error", "clear channel", "server is up",
+        "not found", "read notify", "read build", "repeater confirm",
+        "create channel", "write notify", "client name", "host name",
+        "access rights", "echo", "repeater register", "signal",
+        "create channel fail", "server disconnect", "compressed"
+    };
+    ::printf ( "\tbytes %s by message type:\n", pName );
+    for ( unsigned i = 0u; i < nCommands; i++ ) {
+        if ( this->counts[i] ) {
+            ::printf ( "\t\t%-20s %llu\n", pCommandNames[i],
+                static_cast < unsigned long long > ( this->counts[i] ) );
+        }
+    }
+}
+
+#endif // ifndef INC_messageByteCounts_H
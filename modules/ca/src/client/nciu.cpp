@@ -44,6 +44,8 @@ nciu::nciu ( cac & cacIn, netiiu & iiuIn, cacChannelNotify & chanIn,
     cacCtx ( cacIn ),
     piiu ( & iiuIn ),
     sid ( UINT_MAX ),
+    prevServerAddr ( 0u ),
+    prevServerPort ( 0u ),
     count ( 0 ),
     retry ( 0u ),
     nameLength ( 0u ),
@@ -185,6 +187,11 @@ void nciu::setServerAddressUnknown ( netiiu & newiiu,
                                 epicsGuard < epicsMutex > & guard )
 {
     guard.assertIdenticalMutex ( this->cacCtx.mutexRef () );
+    osiSockAddr addr = this->piiu->getNetworkAddress ( guard );
+    if ( addr.sa.sa_family == AF_INET ) {
+        this->prevServerAddr = addr.ia.sin_addr.s_addr;
+        this->prevServerPort = addr.ia.sin_port;
+    }
     this->piiu = & newiiu;
     this->retry = 0;
     this->typeCode = USHRT_MAX;
@@ -194,6 +201,21 @@ void nciu::setServerAddressUnknown ( netiiu & newiiu,
     this->accessRightState.clrWritePermit();
 }
 
+// the address of the server last connected to, if any
+bool nciu::previousServer (
+    epicsGuard < epicsMutex > & guard, struct sockaddr_in & addr ) const
+{
+    guard.assertIdenticalMutex ( this->cacCtx.mutexRef () );
+    if ( this->prevServerPort == 0u ) {
+        return false;
+    }
+    memset ( & addr, 0, sizeof ( addr ) );
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = this->prevServerAddr;
+    addr.sin_port = this->prevServerPort;
+    return true;
+}
+
 void nciu::accessRightsStateChange (
     const caAccessRights & arIn, epicsGuard < epicsMutex > & /* cbGuard */,
     epicsGuard < epicsMutex > & guard )
@@ -464,6 +486,12 @@ double nciu::receiveWatchdogDelay (
     return this->piiu->receiveWatchdogDelay ( guard );
 }
 
+double nciu::roundTripTime (
+    epicsGuard < epicsMutex > & guard ) const
+{
+    return this->piiu->roundTripTime ( guard );
+}
+
 bool nciu::connected ( epicsGuard < epicsMutex > & guard ) const
 {
     guard.assertIdenticalMutex ( this->cacCtx.mutexRef () );
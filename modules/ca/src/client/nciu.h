@@ -29,6 +29,7 @@
 #include "tsDLList.h"
 #include "tsFreeList.h"
 #include "epicsMutex.h"
+#include "epicsTime.h"
 #include "compilerDependencies.h"
 
 #include "libCaAPI.h"
@@ -148,6 +149,8 @@ public:
         epicsGuard < epicsMutex > & guard );
     void setServerAddressUnknown (
         netiiu & newiiu, epicsGuard < epicsMutex > & guard );
+    bool previousServer (
+        epicsGuard < epicsMutex > &, struct sockaddr_in & ) const;
     bool searchMsg (
         epicsGuard < epicsMutex > & );
     void serviceShutdownNotify (
@@ -188,6 +191,10 @@ public:
         int status, const char *pContext, unsigned type, arrayElementCount count );
     cacChannel::priLev getPriority (
         epicsGuard < epicsMutex > & ) const;
+    void setSearchBeginTime (
+        epicsGuard < epicsMutex > &, const epicsTime & );
+    const epicsTime & searchBeginTime (
+        epicsGuard < epicsMutex > & ) const;
     void * operator new (
         size_t size, tsFreeList < class nciu, 1024, epicsMutexNOOP > & );
     epicsPlacementDeleteOperator (
@@ -206,7 +213,10 @@ private:
     cac & cacCtx;
     char * pNameStr;
     netiiu * piiu;
+    epicsTime searchBegin; // when the current search began
     ca_uint32_t sid; // server id
+    ca_uint32_t prevServerAddr; // last server, in network byte order
+    ca_uint16_t prevServerPort; // zero if never connected
     unsigned count;
     unsigned retry; // search retry number
     unsigned short nameLength; // channel name length
@@ -261,6 +271,8 @@ private:
         epicsGuard < epicsMutex > & ) const;
     double receiveWatchdogDelay (
         epicsGuard < epicsMutex > & ) const;
+    double roundTripTime (
+        epicsGuard < epicsMutex > & ) const;
     bool ca_v42_ok (
         epicsGuard < epicsMutex > & ) const;
     arrayElementCount nativeElementCount (
@@ -352,6 +364,18 @@ inline cacChannel::priLev nciu::getPriority (
     return this->priority;
 }
 
+inline void nciu::setSearchBeginTime (
+    epicsGuard < epicsMutex > &, const epicsTime & currentTime )
+{
+    this->searchBegin = currentTime;
+}
+
+inline const epicsTime & nciu::searchBeginTime (
+    epicsGuard < epicsMutex > & ) const
+{
+    return this->searchBegin;
+}
+
 inline channelNode::channelNode () :
     listMember ( cs_none )
 {
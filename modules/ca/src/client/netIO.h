@@ -25,6 +25,7 @@
 #ifndef INC_netIO_H
 #define INC_netIO_H
 
+#include "epicsTime.h"
 #include "nciu.h"
 #include "compilerDependencies.h"
 
@@ -63,6 +64,8 @@ public:
     virtual void forceSubscriptionUpdate (
         epicsGuard < epicsMutex > & guard, nciu & chan ) = 0;
     virtual class netSubscription * isSubscription () = 0;
+    // when a request with a single response was sent
+    virtual bool requestTime ( epicsTime & ) const;
     virtual void show (
         unsigned level ) const = 0;
     virtual void show (
@@ -146,6 +149,7 @@ protected:
 private:
     cacReadNotify & notify;
     class privateInterfaceForIO & privateChanForIO;
+    const epicsTime begin;
     void operator delete ( void * );
     void * operator new ( size_t,
         tsFreeList < class netReadNotifyIO, 1024, epicsMutexNOOP > & );
@@ -167,6 +171,7 @@ private:
         int status, const char * pContext,
         unsigned type, arrayElementCount count );
     class netSubscription * isSubscription ();
+    bool requestTime ( epicsTime & ) const;
     void forceSubscriptionUpdate (
         epicsGuard < epicsMutex > & guard, nciu & chan );
     netReadNotifyIO ( const netReadNotifyIO & );
@@ -188,12 +193,14 @@ protected:
 private:
     cacWriteNotify & notify;
     privateInterfaceForIO & privateChanForIO;
+    const epicsTime begin;
     void operator delete ( void * );
     void * operator new ( size_t,
         tsFreeList < class netWriteNotifyIO, 1024, epicsMutexNOOP > & );
     epicsPlacementDeleteOperator (( void *,
         tsFreeList < class netWriteNotifyIO, 1024, epicsMutexNOOP > & ))
     class netSubscription * isSubscription ();
+    bool requestTime ( epicsTime & ) const;
     void destroy (
         epicsGuard < epicsMutex > &, class cacRecycle & );
     void completion (
@@ -32,7 +32,8 @@
 netReadNotifyIO::netReadNotifyIO (
     privateInterfaceForIO & ioComplIntfIn,
         cacReadNotify & notify ) :
-    notify ( notify ), privateChanForIO ( ioComplIntfIn )
+    notify ( notify ), privateChanForIO ( ioComplIntfIn ),
+    begin ( epicsTime::getCurrent () )
 {
 }
 
@@ -114,6 +115,12 @@ class netSubscription * netReadNotifyIO::isSubscription ()
     return 0;
 }
 
+bool netReadNotifyIO::requestTime ( epicsTime & t ) const
+{
+    t = this->begin;
+    return true;
+}
+
 void netReadNotifyIO::forceSubscriptionUpdate (
     epicsGuard < epicsMutex > &, nciu & )
 {
@@ -31,7 +31,8 @@
 
 netWriteNotifyIO::netWriteNotifyIO (
     privateInterfaceForIO & ioComplIntf, cacWriteNotify & notifyIn ) :
-    notify ( notifyIn ), privateChanForIO ( ioComplIntf )
+    notify ( notifyIn ), privateChanForIO ( ioComplIntf ),
+    begin ( epicsTime::getCurrent () )
 {
 }
 
@@ -112,6 +113,12 @@ class netSubscription * netWriteNotifyIO::isSubscription ()
     return 0;
 }
 
+bool netWriteNotifyIO::requestTime ( epicsTime & t ) const
+{
+    t = this->begin;
+    return true;
+}
+
 void netWriteNotifyIO::forceSubscriptionUpdate (
     epicsGuard < epicsMutex > &, nciu & )
 {
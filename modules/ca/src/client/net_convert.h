@@ -29,6 +29,14 @@ LIBCA_API int caNetConvert (
     unsigned type, const void *pSrc, void *pDest,
     int hton, arrayElementCount count );
 
+/* CA_COMPRESS_SHUFFLE_RLE codec, see compress.cpp */
+LIBCA_API unsigned caNetCompress (
+    const void *pSrc, unsigned size, unsigned stride,
+    void *pDest, unsigned destSize );
+LIBCA_API int caNetUncompress (
+    const void *pSrc, unsigned srcSize, unsigned stride,
+    void *pDest, unsigned destSize );
+
 #ifdef __cplusplus
 }
 #endif
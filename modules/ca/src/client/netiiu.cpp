@@ -157,6 +157,12 @@ double netiiu::receiveWatchdogDelay (
     return - DBL_MAX;
 }
 
+double netiiu::roundTripTime (
+    epicsGuard < epicsMutex > & ) const
+{
+    return - DBL_MAX;
+}
+
 void netiiu::uninstallChanDueToSuccessfulSearchResponse (
     epicsGuard < epicsMutex > &, nciu &, const epicsTime & )
 {
@@ -89,6 +89,8 @@ public:
         const class epicsTime & currentTime ) = 0;
     virtual double receiveWatchdogDelay (
         epicsGuard < epicsMutex > & ) const = 0;
+    virtual double roundTripTime (
+        epicsGuard < epicsMutex > & ) const = 0;
     virtual bool searchMsg (
         epicsGuard < epicsMutex > &, ca_uint32_t id,
             const char * pName, unsigned nameLength ) = 0;
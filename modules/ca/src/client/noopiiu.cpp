@@ -145,6 +145,12 @@ double noopiiu::receiveWatchdogDelay (
     return netiiu::receiveWatchdogDelay ( guard );
 }
 
+double noopiiu::roundTripTime (
+    epicsGuard < epicsMutex > & guard ) const
+{
+    return netiiu::roundTripTime ( guard );
+}
+
 void noopiiu::uninstallChan (
     epicsGuard < epicsMutex > &, nciu & )
 {
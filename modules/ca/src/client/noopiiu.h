@@ -82,6 +82,8 @@ public:
         const class epicsTime & currentTime );
     double receiveWatchdogDelay (
         epicsGuard < epicsMutex > & ) const;
+    double roundTripTime (
+        epicsGuard < epicsMutex > & ) const;
     bool searchMsg (
         epicsGuard < epicsMutex > &, ca_uint32_t id,
             const char * pName, unsigned nameLength );
@@ -37,6 +37,8 @@
 #include "cacIO.h"
 #include "cadef.h"
 #include "syncGroup.h"
+#include "callbackExecutor.h"
+#include "subscriptionPacer.h"
 
 namespace ca {
 #if __cplusplus>=201103L
@@ -104,10 +106,16 @@ public:
         chtype type, arrayElementCount count, chid pChan,
         long mask, caEventCallBackFunc * pCallBack,
         void * pCallBackArg, evid * monixptr );
+    friend int epicsStdCall ca_create_subscriptions (
+        unsigned nSubscriptions, chtype type, arrayElementCount count,
+        const chid * pChans, long mask, caEventCallBackFunc * pCallBack,
+        void * const * pCallBackArgs, evid * monixptrs );
     friend enum channel_state epicsStdCall ca_state (
         chid pChan );
     friend double epicsStdCall ca_receive_watchdog_delay (
         chid pChan );
+    friend double epicsStdCall ca_round_trip_time (
+        chid pChan );
 
     unsigned getName (
         epicsGuard < epicsMutex > &,
@@ -165,6 +173,10 @@ private:
     void writeException ( epicsGuard < epicsMutex > &,
         int status, const char * pContext,
         unsigned type, arrayElementCount count );
+    static int subscribe ( epicsGuard < epicsMutex > &,
+        unsigned type, arrayElementCount count, chid pChan,
+        long mask, caEventCallBackFunc * pCallBack,
+        void * pCallBackArg, evid * monixptr );
     oldChannelNotify ( const oldChannelNotify & );
     oldChannelNotify & operator = ( const oldChannelNotify & );
     void operator delete ( void * );
@@ -250,7 +262,8 @@ private:
     void operator delete ( void * );
 };
 
-struct oldSubscription : private cacStateNotify {
+struct oldSubscription : public tsDLNode < oldSubscription >,
+        private cacStateNotify {
 public:
     oldSubscription (
         epicsGuard < epicsMutex > & guard,
@@ -270,6 +283,11 @@ public:
     void cancel (
         CallbackGuard & callbackGuard,
         epicsGuard < epicsMutex > & mutualExclusionGuard );
+    void setPolicy ( epicsGuard < epicsMutex > &,
+        ca_subscription_policy_select, double window,
+        double bytesPerSecond );
+    void deliverHeld ( epicsGuard < epicsMutex > &,
+        const epicsTime & currentTime );
     void * operator new ( size_t size,
         tsFreeList < struct oldSubscription, 1024, epicsMutexNOOP > & );
     epicsPlacementDeleteOperator (( void *,
@@ -279,6 +297,25 @@ private:
     cacChannel::ioid id;
     caEventCallBackFunc * pFunc;
     void * pPrivate;
+    // the update, if any, held back until nextDue by a rate limit
+    void * pHeld;
+    size_t heldCapacity;
+    unsigned heldType;
+    arrayElementCount heldCount;
+    // this subscription's update queued by the callback executor
+    void * pQueued;
+    tsDLList < oldSubscription > * pPacerList;
+    epicsTime nextDue;
+    double window;
+    double budget;
+    ca_subscription_policy_select policy;
+    bool holding;
+    bool paced () const;
+    double interval ( unsigned type, arrayElementCount count ) const;
+    void hold ( epicsGuard < epicsMutex > &, unsigned type,
+        arrayElementCount count, const void * pData );
+    void deliver ( epicsGuard < epicsMutex > &, unsigned type,
+        arrayElementCount count, const void * pData );
     void current (
         epicsGuard < epicsMutex > &, unsigned type,
         arrayElementCount count, const void *pData );
@@ -288,6 +325,7 @@ private:
     oldSubscription ( const oldSubscription & );
     oldSubscription & operator = ( const oldSubscription & );
     void operator delete ( void * );
+    friend class subscriptionPacer;
 };
 
 extern "C" void cacOnceFunc ( void * );
@@ -316,6 +354,9 @@ public:
     unsigned sequenceNumberOfOutstandingIO (
         epicsGuard < epicsMutex > & ) const;
     unsigned beaconAnomaliesSinceProgramStart () const;
+    int latency ( int select, struct ca_latency_summary & ) const;
+    int messageBytes ( unsigned command,
+        double & sent, double & received ) const;
     void incrementOutstandingIO (
         epicsGuard < epicsMutex > &, unsigned ioSeqNo );
     void decrementOutstandingIO (
@@ -347,6 +388,8 @@ public:
     void destroyPutCallback ( epicsGuard < epicsMutex > &, putCallback & );
     void destroySubscription ( epicsGuard < epicsMutex > &, oldSubscription & );
     epicsMutex & mutexRef () const;
+    callbackExecutor * executor () const;
+    subscriptionPacer & pacer ( epicsGuard < epicsMutex > & );
 
     template < class T >
     void whenThereIsAnExceptionDestroySyncGroupIO ( epicsGuard < epicsMutex > &, T & );
@@ -355,6 +398,9 @@ public:
     friend int epicsStdCall ca_create_channel (
         const char * name_str, caCh * conn_func, void * puser,
         capri priority, chid * chanptr );
+    friend int epicsStdCall ca_create_channels ( unsigned nChannels,
+        const char * const * pNames, caCh * conn_func,
+        void * const * pUsers, capri priority, chid * pChanIds );
     friend int epicsStdCall ca_clear_channel ( chid pChan );
     friend int epicsStdCall ca_array_get ( chtype type,
         arrayElementCount count, chid pChan, void * pValue );
@@ -366,10 +412,7 @@ public:
     friend int epicsStdCall ca_array_put_callback ( chtype type,
         arrayElementCount count, chid pChan, const void * pValue,
         caEventCallBackFunc *pfunc, void *usrarg );
-    friend int epicsStdCall ca_create_subscription (
-        chtype type, arrayElementCount count, chid pChan,
-        long mask, caEventCallBackFunc * pCallBack, void * pCallBackArg,
-        evid *monixptr );
+    friend struct oldChannelNotify;
     friend int epicsStdCall ca_flush_io ();
     friend int epicsStdCall ca_clear_subscription ( evid pMon );
     friend int epicsStdCall ca_sg_create ( CA_SYNC_GID * pgid );
@@ -388,6 +431,7 @@ public:
                                 ca_client_context & cac, const CA_SYNC_GID gid );
     friend void sync_group_reset ( ca_client_context & client,
                                                   CASG & sg );
+    friend class subscriptionPacer;
 
     // exceptions
     class noSocket {};
@@ -406,6 +450,9 @@ private:
     epicsThreadId createdByThread;
     ca::auto_ptr < CallbackGuard > pCallbackGuard;
     ca::auto_ptr < cacContext > pServiceContext;
+    callbackExecutor * pExecutor;
+    epicsTimerQueueActive * pPacerQueue;
+    subscriptionPacer * pPacer;
     caExceptionHandler * ca_exception_func;
     void * ca_exception_arg;
     caPrintfFunc * pVPrintfFunc;
@@ -425,6 +472,11 @@ private:
     cacContext & createNetworkContext (
         epicsMutex & mutualExclusion, epicsMutex & callbackControl );
     void _sendWakeupMsg ();
+    void destroyPacer ();
+    void fdRegistration ();
+    int createChannelNotify ( epicsGuard < epicsMutex > &,
+        const char * pName, caCh * pConnCallBack, void * pPrivate,
+        capri priority, chid * pChanId );
 
     ca_client_context ( const ca_client_context & );
     ca_client_context & operator = ( const ca_client_context & );
@@ -437,6 +489,12 @@ private:
 
 int fetchClientContext ( ca_client_context * * ppcac );
 
+// nil unless user callbacks are run by a pool of threads
+inline callbackExecutor * ca_client_context::executor () const
+{
+    return this->pExecutor;
+}
+
 inline ca_client_context & oldChannelNotify::getClientCtx ()
 {
     return this->cacCtx;
@@ -87,7 +87,10 @@ void oldChannelNotify::connectNotify (
         args.chid = this;
         args.op = CA_OP_CONN_UP;
         caCh * pFunc = this->pConnCallBack;
-        {
+        if ( callbackExecutor * pExecutor = this->cacCtx.executor () ) {
+            pExecutor->postConnection ( pFunc, args );
+        }
+        else {
             epicsGuardRelease < epicsMutex > unguard ( guard );
             ( *pFunc ) ( args );
         }
@@ -106,7 +109,10 @@ void oldChannelNotify::disconnectNotify (
         args.chid = this;
         args.op = CA_OP_CONN_DOWN;
         caCh * pFunc = this->pConnCallBack;
-        {
+        if ( callbackExecutor * pExecutor = this->cacCtx.executor () ) {
+            pExecutor->postConnection ( pFunc, args );
+        }
+        else {
             epicsGuardRelease < epicsMutex > unguard ( guard );
             ( *pFunc ) ( args );
         }
@@ -131,7 +137,10 @@ void oldChannelNotify::accessRightsNotify (
     args.ar.read_access = ar.readPermit();
     args.ar.write_access = ar.writePermit();
     caArh * pFunc = this->pAccessRightsFunc;
-    {
+    if ( callbackExecutor * pExecutor = this->cacCtx.executor () ) {
+        pExecutor->postAccessRights ( pFunc, args );
+    }
+    else {
         epicsGuardRelease < epicsMutex > unguard ( guard );
         ( *pFunc ) ( args );
     }
@@ -528,15 +537,12 @@ int epicsStdCall ca_array_put ( chtype type, arrayElementCount count,
     return caStatus;
 }
 
-int epicsStdCall ca_create_subscription (
-        chtype type, arrayElementCount count, chid pChan,
-        long mask, caEventCallBackFunc * pCallBack, void * pCallBackArg,
-        evid * monixptr )
+static int checkSubscriptionArgs ( chtype type,
+    long mask, caEventCallBackFunc * pCallBack )
 {
     if ( type < 0 ) {
         return ECA_BADTYPE;
     }
-    unsigned tmpType = static_cast < unsigned > ( type );
 
     if ( INVALID_DB_REQ (type) ) {
         return ECA_BADTYPE;
@@ -555,8 +561,15 @@ int epicsStdCall ca_create_subscription (
         return ECA_BADMASK;
     }
 
+    return ECA_NORMAL;
+}
+
+int oldChannelNotify::subscribe ( epicsGuard < epicsMutex > & guard,
+        unsigned type, arrayElementCount count, chid pChan,
+        long mask, caEventCallBackFunc * pCallBack, void * pCallBackArg,
+        evid * monixptr )
+{
     try {
-        epicsGuard < epicsMutex > guard ( pChan->cacCtx.mutexRef () );
         try {
             // if this stalls out on a live circuit then an exception
             // can be forthcoming which we must ignore (this is a
@@ -569,7 +582,7 @@ int epicsStdCall ca_create_subscription (
         }
         new ( pChan->getClientCtx().subscriptionFreeList )
             oldSubscription  (
-                guard, *pChan, pChan->io, tmpType, count, mask,
+                guard, *pChan, pChan->io, type, count, mask,
                 pCallBack, pCallBackArg, monixptr );
         // don't touch object created after above new because
         // the first callback might have canceled, and therefore
@@ -609,6 +622,83 @@ int epicsStdCall ca_create_subscription (
     }
 }
 
+int epicsStdCall ca_create_subscription (
+        chtype type, arrayElementCount count, chid pChan,
+        long mask, caEventCallBackFunc * pCallBack, void * pCallBackArg,
+        evid * monixptr )
+{
+    int caStatus = checkSubscriptionArgs ( type, mask, pCallBack );
+    if ( caStatus != ECA_NORMAL ) {
+        return caStatus;
+    }
+
+    epicsGuard < epicsMutex > guard ( pChan->cacCtx.mutexRef () );
+    return oldChannelNotify::subscribe ( guard,
+        static_cast < unsigned > ( type ), count, pChan, mask,
+        pCallBack, pCallBackArg, monixptr );
+}
+
+/*
+ * ca_create_subscriptions ()
+ *
+ * All of the channels must belong to the same context. A NULL channel
+ * id, as ca_create_channels() writes for a channel it couldn't create,
+ * fails with ECA_BADCHID. The arguments
+ * are checked once and the context lock is taken once for all of the
+ * subscriptions, so the requests for connected channels are queued
+ * back to back in the circuit's send queue, and are sent when it is
+ * next flushed.
+ */
+int epicsStdCall ca_create_subscriptions ( unsigned nSubscriptions,
+        chtype type, arrayElementCount count, const chid * pChans,
+        long mask, caEventCallBackFunc * pCallBack,
+        void * const * pCallBackArgs, evid * monixptrs )
+{
+    int caStatus = checkSubscriptionArgs ( type, mask, pCallBack );
+    if ( caStatus != ECA_NORMAL || nSubscriptions == 0u ) {
+        return caStatus;
+    }
+
+    // the context is that of the first channel that exists
+    unsigned first = 0u;
+    while ( first < nSubscriptions && ! pChans[first] ) {
+        first++;
+    }
+    if ( first == nSubscriptions ) {
+        if ( monixptrs ) {
+            for ( unsigned i = 0u; i < nSubscriptions; i++ ) {
+                monixptrs[i] = 0;
+            }
+        }
+        return ECA_BADCHID;
+    }
+
+    epicsMutex & mutex = pChans[first]->cacCtx.mutexRef ();
+    epicsGuard < epicsMutex > guard ( mutex );
+    for ( unsigned i = 0u; i < nSubscriptions; i++ ) {
+        int status;
+        if ( ! pChans[i] ||
+                & pChans[i]->cacCtx.mutexRef () != & mutex ) {
+            status = ECA_BADCHID;
+        }
+        else {
+            status = oldChannelNotify::subscribe ( guard,
+                static_cast < unsigned > ( type ), count, pChans[i], mask,
+                pCallBack, pCallBackArgs ? pCallBackArgs[i] : 0,
+                monixptrs ? & monixptrs[i] : 0 );
+        }
+        if ( status != ECA_NORMAL ) {
+            if ( monixptrs ) {
+                monixptrs[i] = 0;
+            }
+            if ( caStatus == ECA_NORMAL ) {
+                caStatus = status;
+            }
+        }
+    }
+    return caStatus;
+}
+
 void oldChannelNotify::write (
     epicsGuard < epicsMutex > & guard, unsigned type, arrayElementCount count,
     const void * pValue, cacWriteNotify & notify, cacChannel::ioid * pId )
@@ -696,6 +786,12 @@ double epicsStdCall ca_receive_watchdog_delay ( chid pChan )
     return pChan->io.receiveWatchdogDelay ( guard );
 }
 
+double epicsStdCall ca_round_trip_time ( chid pChan )
+{
+    epicsGuard < epicsMutex > guard ( pChan->cacCtx.mutexRef () );
+    return pChan->io.roundTripTime ( guard );
+}
+
 /*
  * ca_v42_ok(chid chan)
  */
@@ -20,6 +20,8 @@
  */
 
 #include <stdexcept>
+#include <stdlib.h>
+#include <string.h>
 
 #include "errlog.h"
 
@@ -33,7 +35,10 @@ oldSubscription::oldSubscription  (
     caEventCallBackFunc * pFuncIn, void * pPrivateIn,
     evid * pEventId ) :
     chan ( chanIn ), id ( UINT_MAX ), pFunc ( pFuncIn ),
-        pPrivate ( pPrivateIn )
+        pPrivate ( pPrivateIn ), pHeld ( 0 ), heldCapacity ( 0u ),
+        heldType ( 0u ), heldCount ( 0u ), pQueued ( 0 ), pPacerList ( 0 ),
+        window ( 0.0 ), budget ( 0.0 ),
+        policy ( ca_subscription_lossless ), holding ( false )
 {
     // The users event id *must* be set prior to potentially
     // calling his callback from within subscribe.
@@ -48,11 +53,115 @@ oldSubscription::oldSubscription  (
 
 oldSubscription::~oldSubscription ()
 {
+    free ( this->pHeld );
 }
 
+void oldSubscription::setPolicy ( epicsGuard < epicsMutex > & guard,
+    ca_subscription_policy_select policyIn, double windowIn,
+    double bytesPerSecond )
+{
+    this->policy = policyIn;
+    this->window = windowIn;
+    this->budget = bytesPerSecond;
+    if ( this->holding ) {
+        // the update held under the old policy is delivered now
+        this->chan.getClientCtx().pacer ( guard ).flush ( guard, *this );
+    }
+    else if ( this->paced () ) {
+        // so that allocation failures are reported now
+        this->chan.getClientCtx().pacer ( guard );
+    }
+}
+
+bool oldSubscription::paced () const
+{
+    return this->policy == ca_subscription_windowed ||
+        ( this->policy == ca_subscription_latest && this->budget > 0.0 );
+}
+
+// the time that must pass after delivering an update
+double oldSubscription::interval (
+    unsigned type, arrayElementCount count ) const
+{
+    double delay = 0.0;
+    if ( this->policy == ca_subscription_windowed ) {
+        delay = this->window;
+    }
+    if ( this->budget > 0.0 ) {
+        double bytes = static_cast < double > ( dbr_size_n ( type, count ) );
+        if ( bytes / this->budget > delay ) {
+            delay = bytes / this->budget;
+        }
+    }
+    return delay;
+}
+
+//
+// Updates that arrive before the subscription's next update is due
+// are held, each replacing the one before, and the last is delivered
+// when it is due.
+//
 void oldSubscription::current (
     epicsGuard < epicsMutex > & guard,
     unsigned type, arrayElementCount count, const void * pData )
+{
+    if ( this->holding && ! this->paced () ) {
+        // superseded, it must not be delivered after this update
+        this->chan.getClientCtx().pacer ( guard ).remove ( guard, *this );
+        this->holding = false;
+    }
+    if ( this->paced () ) {
+        epicsTime current = epicsTime::getCurrent ();
+        if ( this->holding || current < this->nextDue ) {
+            this->hold ( guard, type, count, pData );
+            return;
+        }
+        this->nextDue = current + this->interval ( type, count );
+    }
+    this->deliver ( guard, type, count, pData );
+}
+
+void oldSubscription::hold ( epicsGuard < epicsMutex > & guard,
+    unsigned type, arrayElementCount count, const void * pData )
+{
+    size_t size = dbr_size_n ( type, count );
+    if ( size > this->heldCapacity ) {
+        void * pBuf = malloc ( size );
+        if ( ! pBuf ) {
+            // better late than never
+            this->deliver ( guard, type, count, pData );
+            return;
+        }
+        free ( this->pHeld );
+        this->pHeld = pBuf;
+        this->heldCapacity = size;
+    }
+    memcpy ( this->pHeld, pData, size );
+    this->heldType = type;
+    this->heldCount = count;
+    this->holding = true;
+    this->chan.getClientCtx().pacer ( guard ).hold ( guard, *this );
+}
+
+// called by the pacer, with the callback lock, once the update is due
+void oldSubscription::deliverHeld (
+    epicsGuard < epicsMutex > & guard, const epicsTime & currentTime )
+{
+    // the callback might cancel this subscription
+    void * pData = this->pHeld;
+    unsigned type = this->heldType;
+    arrayElementCount count = this->heldCount;
+    this->pHeld = 0;
+    this->heldCapacity = 0u;
+    this->holding = false;
+    this->nextDue = currentTime + this->interval ( type, count );
+    this->deliver ( guard, type, count, pData );
+    free ( pData );
+}
+
+void oldSubscription::deliver (
+    epicsGuard < epicsMutex > & guard,
+    unsigned type, arrayElementCount count, const void * pData )
 {
     struct event_handler_args args;
     args.usr = this->pPrivate;
@@ -62,7 +171,11 @@ void oldSubscription::current (
     args.status = ECA_NORMAL;
     args.dbr = pData;
     caEventCallBackFunc * pFuncTmp = this->pFunc;
-    {
+    if ( callbackExecutor * pExecutor = this->chan.getClientCtx().executor () ) {
+        pExecutor->postEvent ( pFuncTmp, args, this,
+            this->policy == ca_subscription_lossless ? 0 : & this->pQueued );
+    }
+    else {
         epicsGuardRelease < epicsMutex > unguard ( guard );
         ( *pFuncTmp ) ( args );
     }
@@ -86,7 +199,10 @@ void oldSubscription::exception (
         args.status = status;
         args.dbr = 0;
         caEventCallBackFunc * pFuncTmp = this->pFunc;
-        {
+        if ( callbackExecutor * pExecutor = this->chan.getClientCtx().executor () ) {
+            pExecutor->postEvent ( pFuncTmp, args, this );
+        }
+        else {
             epicsGuardRelease < epicsMutex > unguard ( guard );
             ( *pFuncTmp ) ( args );
         }
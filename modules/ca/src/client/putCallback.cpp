@@ -55,8 +55,12 @@ void putCallback::completion ( epicsGuard < epicsMutex > & guard  )
     caEventCallBackFunc * pFuncTmp = this->pFunc;
     // fetch client context and destroy prior to releasing
     // the lock and calling cb in case they destroy channel there
+    callbackExecutor * pExecutor = this->chan.getClientCtx().executor ();
     this->chan.getClientCtx().destroyPutCallback ( guard, *this );
-    if ( pFuncTmp ) {
+    if ( pFuncTmp && pExecutor ) {
+        pExecutor->postEvent ( pFuncTmp, args, 0 );
+    }
+    else if ( pFuncTmp ) {
         epicsGuardRelease < epicsMutex > unguard ( guard );
         pFuncTmp ( args );
     }
@@ -78,8 +82,12 @@ void putCallback::exception (
         caEventCallBackFunc * pFuncTmp = this->pFunc;
         // fetch client context and destroy prior to releasing
         // the lock and calling cb in case they destroy channel there
+        callbackExecutor * pExecutor = this->chan.getClientCtx().executor ();
         this->chan.getClientCtx().destroyPutCallback ( guard, *this );
-        {
+        if ( pExecutor ) {
+            pExecutor->postEvent ( pFuncTmp, args, 0 );
+        }
+        else {
             epicsGuardRelease < epicsMutex > unguard ( guard );
             ( *pFuncTmp ) ( args );
         }
@@ -100,21 +100,57 @@ void searchTimer::shutdown (
 void searchTimer::installChannel (
     epicsGuard < epicsMutex > & guard, nciu & chan )
 {
-    this->chanListReqPending.add ( chan );
+    // channels created with a raised priority are searched for first
+    if ( chan.getPriority ( guard ) > cacChannel::priorityDefault ) {
+        this->chanListReqPending.push ( chan );
+    }
+    else {
+        this->chanListReqPending.add ( chan );
+    }
     chan.channelNode::setReqPendingState ( guard, this->index );
 }
 
+//
+// Moves the channels to the dest timer, or with matchedOnly
+// set only those whose previous server has a beacon anomaly
+//
 void searchTimer::moveChannels (
-    epicsGuard < epicsMutex > & guard, searchTimer & dest )
+    epicsGuard < epicsMutex > & guard, searchTimer & dest,
+    bool matchedOnly, unsigned & nMoved, unsigned & nSkipped )
 {
-    while ( nciu * pChan = this->chanListRespPending.get () ) {
-        if ( this->searchAttempts > 0 ) {
-            this->searchAttempts--;
-        }
-        dest.installChannel ( guard, *pChan );
+    unsigned nMovedRespPending = nMoved;
+    this->moveChannels ( guard, this->chanListRespPending, dest,
+        matchedOnly, nMoved, nSkipped );
+    nMovedRespPending = nMoved - nMovedRespPending;
+    if ( this->searchAttempts > nMovedRespPending ) {
+        this->searchAttempts -= nMovedRespPending;
     }
-    while ( nciu * pChan = this->chanListReqPending.get () ) {
-        dest.installChannel ( guard, *pChan );
+    else {
+        this->searchAttempts = 0u;
+    }
+    this->moveChannels ( guard, this->chanListReqPending, dest,
+        matchedOnly, nMoved, nSkipped );
+}
+
+void searchTimer::moveChannels (
+    epicsGuard < epicsMutex > & guard, tsDLList < nciu > & list,
+    searchTimer & dest, bool matchedOnly,
+    unsigned & nMoved, unsigned & nSkipped )
+{
+    tsDLIter < nciu > pChan = list.firstIter ();
+    while ( pChan.valid () ) {
+        tsDLIter < nciu > pNext = pChan;
+        pNext++;
+        if ( ! matchedOnly ||
+                this->iiu.beaconAnomalyMatch ( guard, *pChan ) ) {
+            list.remove ( *pChan );
+            dest.installChannel ( guard, *pChan );
+            nMoved++;
+        }
+        else {
+            nSkipped++;
+        }
+        pChan = pNext;
     }
 }
 
@@ -287,6 +323,22 @@ epicsTimerNotify::expireStatus searchTimer::expire (
     return expireStatus ( restart, this->period ( guard ) );
 }
 
+unsigned searchTimer :: channelCount (
+    epicsGuard < epicsMutex > & guard ) const
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    return this->chanListReqPending.count () +
+        this->chanListRespPending.count ();
+}
+
+// the number of UDP frames sent each time the timer expires
+double searchTimer :: window (
+    epicsGuard < epicsMutex > & guard ) const
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    return this->framesPerTry;
+}
+
 void searchTimer :: show ( unsigned level ) const
 {
     epicsGuard < epicsMutex > guard ( this->mutex );
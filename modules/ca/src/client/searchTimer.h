@@ -48,6 +48,8 @@ public:
         const epicsTime & currentTime ) = 0;
     virtual ca_uint32_t datagramSeqNumber (
         epicsGuard < epicsMutex > & ) const = 0;
+    virtual bool beaconAnomalyMatch (
+        epicsGuard < epicsMutex > &, const nciu & ) const = 0;
 };
 
 class searchTimer : private epicsTimerNotify {
@@ -62,7 +64,8 @@ public:
         epicsGuard < epicsMutex > & cbGuard,
         epicsGuard < epicsMutex > & guard );
     void moveChannels (
-        epicsGuard < epicsMutex > &, searchTimer & dest );
+        epicsGuard < epicsMutex > &, searchTimer & dest,
+        bool matchedOnly, unsigned & nMoved, unsigned & nSkipped );
     void installChannel (
         epicsGuard < epicsMutex > &, nciu & );
     void uninstallChan (
@@ -71,6 +74,10 @@ public:
         epicsGuard < epicsMutex > &, nciu &,
         ca_uint32_t respDatagramSeqNo, bool seqNumberIsValid,
         const epicsTime & currentTime );
+    unsigned channelCount (
+        epicsGuard < epicsMutex > & ) const;
+    double window (
+        epicsGuard < epicsMutex > & ) const;
     void show ( unsigned level ) const;
 private:
     tsDLList < nciu > chanListReqPending;
@@ -91,6 +98,9 @@ private:
     bool stopped;
 
     expireStatus expire ( const epicsTime & currentTime );
+    void moveChannels (
+        epicsGuard < epicsMutex > &, tsDLList < nciu > &, searchTimer & dest,
+        bool matchedOnly, unsigned & nMoved, unsigned & nSkipped );
     double period ( epicsGuard < epicsMutex > & ) const;
     searchTimer ( const searchTimer & ); // not implemented
     searchTimer & operator = ( const searchTimer & ); // not implemented
@@ -0,0 +1,126 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+
+#include "iocinf.h"
+#include "cac.h"
+#include "oldAccess.h"
+
+subscriptionPacer::subscriptionPacer (
+        ca_client_context & ctxIn, epicsTimerQueue & queueIn ) :
+    timer ( queueIn.createTimer () ), ctx ( ctxIn ),
+    nDelivered ( 0u ), nReplaced ( 0u ), armed ( false )
+{
+}
+
+// must not be called with the locks applied
+subscriptionPacer::~subscriptionPacer ()
+{
+    this->timer.destroy ();
+}
+
+// the subscription's update is held until its nextDue time
+void subscriptionPacer::hold (
+    epicsGuard < epicsMutex > & guard, oldSubscription & subscr )
+{
+    guard.assertIdenticalMutex ( this->ctx.mutex );
+    if ( subscr.pPacerList ) {
+        this->nReplaced++;
+        return;
+    }
+    this->held.add ( subscr );
+    subscr.pPacerList = & this->held;
+    this->schedule ( guard, subscr.nextDue );
+}
+
+void subscriptionPacer::remove (
+    epicsGuard < epicsMutex > & guard, oldSubscription & subscr )
+{
+    guard.assertIdenticalMutex ( this->ctx.mutex );
+    if ( subscr.pPacerList ) {
+        subscr.pPacerList->remove ( subscr );
+        subscr.pPacerList = 0;
+    }
+}
+
+// the subscription's held update is delivered as soon as possible
+void subscriptionPacer::flush (
+    epicsGuard < epicsMutex > & guard, oldSubscription & subscr )
+{
+    guard.assertIdenticalMutex ( this->ctx.mutex );
+    if ( subscr.pPacerList == & this->held ) {
+        subscr.nextDue = epicsTime::getCurrent ();
+        this->schedule ( guard, subscr.nextDue );
+    }
+}
+
+void subscriptionPacer::schedule (
+    epicsGuard < epicsMutex > &, const epicsTime & due )
+{
+    if ( ! this->armed || due < this->nextExpire ) {
+        this->armed = true;
+        this->nextExpire = due;
+        this->timer.start ( *this, due );
+    }
+}
+
+//
+// The callback lock is taken first, as in the receive threads, so
+// the held updates are delivered like any other.
+//
+epicsTimerNotify::expireStatus subscriptionPacer::expire (
+                 const epicsTime & /* currentTime */ )
+{
+    callbackManager mgr ( this->ctx, this->ctx.cbMutex );
+    epicsGuard < epicsMutex > guard ( this->ctx.mutex );
+    this->armed = false;
+
+    epicsTime current = epicsTime::getCurrent ();
+    tsDLIter < oldSubscription > pSubscr = this->held.firstIter ();
+    while ( pSubscr.valid () ) {
+        tsDLIter < oldSubscription > pNext = pSubscr;
+        pNext++;
+        if ( pSubscr->nextDue <= current ) {
+            this->held.remove ( *pSubscr );
+            this->ready.add ( *pSubscr );
+            pSubscr->pPacerList = & this->ready;
+        }
+        pSubscr = pNext;
+    }
+
+    // the lock is released while each callback runs, and the callback
+    // may cancel any of the subscriptions that are still ready
+    while ( oldSubscription * pReady = this->ready.get () ) {
+        pReady->pPacerList = 0;
+        this->nDelivered++;
+        pReady->deliverHeld ( guard, current );
+    }
+
+    tsDLIter < oldSubscription > pFirst = this->held.firstIter ();
+    if ( pFirst.valid () ) {
+        epicsTime due = pFirst->nextDue;
+        for ( pFirst++; pFirst.valid (); pFirst++ ) {
+            if ( pFirst->nextDue < due ) {
+                due = pFirst->nextDue;
+            }
+        }
+        // a start() while expire runs overrides the restart status
+        this->armed = false;
+        this->schedule ( guard, due );
+    }
+    return noRestart;
+}
+
+void subscriptionPacer::show (
+    epicsGuard < epicsMutex > & guard, unsigned /* level */ ) const
+{
+    guard.assertIdenticalMutex ( this->ctx.mutex );
+    ::printf ( "\tpaced subscriptions: %u holding an update, "
+        "%lu held updates delivered, %lu replaced by newer ones\n",
+        this->held.count () + this->ready.count (),
+        this->nDelivered, this->nReplaced );
+}
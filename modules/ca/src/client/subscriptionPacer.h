@@ -0,0 +1,45 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// Delivers the latest update held back by each subscription whose
+// policy limits its rate (see ca_set_subscription_policy) once the
+// subscription is allowed another update
+//
+
+#ifndef INC_subscriptionPacer_H
+#define INC_subscriptionPacer_H
+
+#include "epicsTimer.h"
+#include "tsDLList.h"
+
+struct ca_client_context;
+struct oldSubscription;
+
+class subscriptionPacer : private epicsTimerNotify {
+public:
+    subscriptionPacer ( ca_client_context &, epicsTimerQueue & );
+    virtual ~subscriptionPacer ();
+    void hold ( epicsGuard < epicsMutex > &, oldSubscription & );
+    void remove ( epicsGuard < epicsMutex > &, oldSubscription & );
+    void flush ( epicsGuard < epicsMutex > &, oldSubscription & );
+    void show ( epicsGuard < epicsMutex > &, unsigned level ) const;
+private:
+    tsDLList < oldSubscription > held;
+    tsDLList < oldSubscription > ready;
+    epicsTime nextExpire;
+    epicsTimer & timer;
+    ca_client_context & ctx;
+    unsigned long nDelivered;
+    unsigned long nReplaced;
+    bool armed;
+    void schedule ( epicsGuard < epicsMutex > &, const epicsTime & due );
+    expireStatus expire ( const epicsTime & currentTime );
+    subscriptionPacer ( const subscriptionPacer & );
+    subscriptionPacer & operator = ( const subscriptionPacer & );
+};
+
+#endif // #ifndef INC_subscriptionPacer_H
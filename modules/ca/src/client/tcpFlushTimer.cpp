@@ -0,0 +1,48 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include "iocinf.h"
+#include "cac.h"
+#include "virtualCircuit.h"
+
+tcpFlushTimer::tcpFlushTimer ( epicsMutex & mutexIn, tcpiiu & iiuIn,
+        double delayIn, epicsTimerQueue & queueIn ) :
+    delay ( delayIn ), timer ( queueIn.createTimer () ),
+    mutex ( mutexIn ), iiu ( iiuIn ), armed ( false )
+{
+}
+
+tcpFlushTimer::~tcpFlushTimer ()
+{
+    this->timer.destroy ();
+}
+
+// called with the lock after each request is queued, the timer
+// is not restarted while it is running so the first request queued
+// since the last expiry sets the deadline for all of them
+void tcpFlushTimer::requestNotify ( epicsGuard < epicsMutex > & guard )
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( ! this->armed ) {
+        this->armed = true;
+        this->timer.start ( *this, this->delay );
+    }
+}
+
+epicsTimerNotify::expireStatus tcpFlushTimer::expire (
+                 const epicsTime & /* currentTime */ )
+{
+    epicsGuard < epicsMutex > guard ( this->mutex );
+    this->armed = false;
+    this->iiu.flushRequest ( guard );
+    return noRestart;
+}
+
+// must not be called with the lock applied
+void tcpFlushTimer::cancel ()
+{
+    this->timer.cancel ();
+}
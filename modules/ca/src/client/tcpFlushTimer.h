@@ -0,0 +1,37 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+//
+// Bounds the time that requests wait in a circuit's send queue
+// when the application doesn't flush (EPICS_CA_FLUSH_DELAY)
+//
+
+#ifndef INC_tcpFlushTimer_H
+#define INC_tcpFlushTimer_H
+
+#include "epicsTimer.h"
+
+class tcpiiu;
+
+class tcpFlushTimer : private epicsTimerNotify {
+public:
+    tcpFlushTimer ( epicsMutex & mutex, tcpiiu &,
+        double delayIn, epicsTimerQueue & );
+    virtual ~tcpFlushTimer ();
+    void requestNotify ( epicsGuard < epicsMutex > & );
+    void cancel ();
+private:
+    const double delay;
+    epicsTimer & timer;
+    epicsMutex & mutex;
+    tcpiiu & iiu;
+    bool armed;
+    expireStatus expire ( const epicsTime & currentTime );
+    tcpFlushTimer ( const tcpFlushTimer & );
+    tcpFlushTimer & operator = ( const tcpFlushTimer & );
+};
+
+#endif // #ifndef INC_tcpFlushTimer_H
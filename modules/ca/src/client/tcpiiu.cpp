@@ -29,8 +29,10 @@
 #include <string>
 
 #include <stdlib.h>
+#include <float.h>
 
 #include "errlog.h"
+#include "osiWireFormat.h"
 
 #include "localHostName.h"
 #include "iocinf.h"
@@ -47,6 +49,9 @@
 
 using namespace std;
 
+// most comBufs filled from the socket before each pass of processIncoming
+static const unsigned maxRecvBatch = 64u;
+
 tcpSendThread::tcpSendThread (
         class tcpiiu & iiuIn, const char * pName,
         unsigned stackSize, unsigned priority ) :
@@ -200,6 +205,7 @@ void tcpSendThread::run ()
     }
 
     this->iiu.sendDog.cancel ();
+    this->iiu.flushTimer.cancel ();
     this->iiu.recvDog.shutdown ();
 
     while ( ! this->iiu.recvThread.exitWait ( 30.0 ) ) {
@@ -242,6 +248,7 @@ unsigned tcpiiu::sendBytes ( const void *pBuf,
             static_cast < const char * > (pBuf), (int) nBytesInBuf, 0 );
         if ( status > 0 ) {
             nBytes = static_cast <unsigned> ( status );
+            this->sendCallCount++;
             // printf("SEND: %u\n", nBytes );
             break;
         }
@@ -457,6 +464,7 @@ void tcpRecvThread::run ()
 
         this->iiu.sendThread.start ();
         epicsThreadPrivateSet ( caClientCallbackThreadId, &this->iiu );
+        epicsThreadPrivateSet ( caClientRecvCircuitId, &this->iiu );
         this->iiu.cacRef.attachToClientCtx ();
 
         comBuf * pComBuf = 0;
@@ -474,6 +482,7 @@ void tcpRecvThread::run ()
             }
 
             statusWireIO stat;
+            bool bufferFull = false;
             pComBuf->fillFromWire ( this->iiu, stat );
 
             epicsTime currentTime = epicsTime::getCurrent ();
@@ -488,12 +497,35 @@ void tcpRecvThread::run ()
                     continue;
                 }
 
+                bufferFull = pComBuf->unoccupiedBytes () == 0u;
                 this->iiu.recvQue.pushLastComBufReceived ( *pComBuf );
                 pComBuf = 0;
 
                 this->iiu._receiveThreadIsBusy = true;
             }
 
+            //
+            // when the circuit is busy gather more of the bytes already
+            // pending in the OS so that they are all processed during one
+            // cycle of the callback lock, the OS has these bytes so
+            // recv will not block
+            //
+            unsigned nBufs = 1u;
+            while ( bufferFull && nBufs < this->iiu.recvBatchLimit &&
+                    this->iiu.bytesArePendingInOS () ) {
+                pComBuf = new ( this->iiu.comBufMemMgr ) comBuf;
+                pComBuf->fillFromWire ( this->iiu, stat );
+                if ( stat.circuitState != swioConnected ||
+                        stat.bytesCopied == 0u ) {
+                    break;
+                }
+                bufferFull = pComBuf->unoccupiedBytes () == 0u;
+                epicsGuard < epicsMutex > guard ( this->iiu.mutex );
+                this->iiu.recvQue.pushLastComBufReceived ( *pComBuf );
+                pComBuf = 0;
+                nBufs++;
+            }
+
             bool sendWakeupNeeded = false;
             {
                 // only one recv thread at a time may call callbacks
@@ -524,6 +556,8 @@ void tcpRecvThread::run ()
                     break;
                 }
                 this->iiu._receiveThreadIsBusy = false;
+                this->iiu.recvBatchCount++;
+                this->iiu.recvBufCount += nBufs;
                 // reschedule connection activity watchdog
                 this->iiu.recvDog.messageArrivalNotify ( guard );
                 //
@@ -542,12 +576,29 @@ void tcpRecvThread::run ()
             // recv with the new MSG_DONTWAIT flag set, but there isn't
             // universal support
             //
+            if ( stat.circuitState != swioConnected ) {
+                // the circuit failed while gathering the batch
+                epicsGuard < epicsMutex > guard ( this->iiu.mutex );
+                this->validFillStatus ( guard, stat );
+                break;
+            }
+
             bool bytesArePending = this->iiu.bytesArePendingInOS ();
             {
                 epicsGuard < epicsMutex > guard ( this->iiu.mutex );
+                // grow the batch while the receiver is falling behind
+                // and shrink it again when it catches up
+                if ( bytesArePending ) {
+                    if ( this->iiu.recvBatchLimit < maxRecvBatch ) {
+                        this->iiu.recvBatchLimit *= 2u;
+                    }
+                }
+                else if ( this->iiu.recvBatchLimit > 1u ) {
+                    this->iiu.recvBatchLimit /= 2u;
+                }
                 if ( bytesArePending ) {
                     if ( ! this->iiu.busyStateDetected ) {
-                        this->iiu.contigRecvMsgCount++;
+                        this->iiu.contigRecvMsgCount += nBufs;
                         if ( this->iiu.contigRecvMsgCount >=
                             this->iiu.cacRef.maxContiguousFrames ( guard ) ) {
                             this->iiu.busyStateDetected = true;
@@ -684,13 +735,16 @@ tcpiiu::tcpiiu (
         *this, connectionTimeout, timerQueue ),
     sendDog ( cbMutexIn, ctxNotifyIn, mutexIn,
         *this, connectionTimeout, timerQueue ),
-    sendQue ( *this, comBufMemMgrIn ),
+    flushTimer ( mutexIn, *this, cac.flushDelay (), timerQueue ),
+    sendQue ( *this, comBufMemMgrIn, cac.bytesSent ),
     recvQue ( comBufMemMgrIn ),
     curDataMax ( MAX_TCP ),
     curDataBytes ( 0ul ),
+    unzipDataMax ( 0ul ),
     comBufMemMgr ( comBufMemMgrIn ),
     cacRef ( cac ),
     pCurData ( (char*) freeListMalloc(this->cacRef.tcpSmallRecvBufFreeList) ),
+    pUnzipData ( 0 ),
     pSearchDest ( pSearchDestIn ),
     mutex ( mutexIn ),
     cbMutex ( cbMutexIn ),
@@ -698,6 +752,12 @@ tcpiiu::tcpiiu (
     state ( iiucs_connecting ),
     sock ( INVALID_SOCKET ),
     contigRecvMsgCount ( 0u ),
+    recvBatchLimit ( 1u ),
+    recvBatchCount ( 0u ),
+    recvBufCount ( 0u ),
+    sendFlushCount ( 0u ),
+    sendCallCount ( 0u ),
+    sendByteCount ( 0u ),
     blockingForFlush ( 0u ),
     socketLibrarySendBufferSize ( 0x1000 ),
     unacknowledgedSendBytes ( 0u ),
@@ -706,6 +766,7 @@ tcpiiu::tcpiiu (
     busyStateDetected ( false ),
     flowControlActive ( false ),
     echoRequestPending ( false ),
+    echoTimePending ( false ),
     oldMsgHeaderAvailable ( false ),
     msgHeaderAvailable ( false ),
     earlyFlush ( false ),
@@ -1021,6 +1082,7 @@ tcpiiu :: ~tcpiiu ()
     this->sendThread.exitWait ();
     this->recvThread.exitWait ();
     this->sendDog.cancel ();
+    this->flushTimer.cancel ();
     this->recvDog.shutdown ();
 
     if ( ! this->socketHasBeenClosed ) {
@@ -1039,6 +1101,7 @@ tcpiiu :: ~tcpiiu ()
             free ( this->pCurData );
         }
     }
+    free ( this->pUnzipData );
 }
 
 void tcpiiu::show ( unsigned level ) const
@@ -1049,6 +1112,9 @@ void tcpiiu::show ( unsigned level ) const
     ::printf ( "Virtual circuit to \"%s\" at version V%u.%u state %u\n",
         buf, CA_MAJOR_PROTOCOL_REVISION,
         this->minorProtocolVersion, this->state );
+    ::printf ( "\t%llu bytes sent in %u flushes using %u send calls\n",
+        static_cast < unsigned long long > ( this->sendByteCount ),
+        this->sendFlushCount, this->sendCallCount );
     if ( level > 1u ) {
         ::printf ( "\tcurrent data cache pointer = %p current data cache size = %lu\n",
             static_cast < void * > ( this->pCurData ), this->curDataMax );
@@ -1056,6 +1122,9 @@ void tcpiiu::show ( unsigned level ) const
             this->contigRecvMsgCount, this->busyStateDetected, this->flowControlActive );
         ::printf ( "\receive thread is busy=%u\n",
             this->_receiveThreadIsBusy );
+        ::printf ( "\treceive batch limit=%u, %u buffers received in %u batches\n",
+            this->recvBatchLimit, this->recvBufCount, this->recvBatchCount );
+        this->echoTimes.show ( "echo round trips" );
     }
     if ( level > 2u ) {
         ::printf ( "\tvirtual circuit socket identifier %d\n", (int)this->sock );
@@ -1135,6 +1204,15 @@ bool tcpiiu::setEchoRequestPending ( epicsGuard < epicsMutex > & guard )
     }
 }
 
+// the receive buffer is empty, so update the totals
+// while the lock is held
+void tcpiiu::recvProcessComplete (
+    epicsGuard < epicsMutex > & guard )
+{
+    this->recvByteCounts.moveTo ( this->cacRef.bytesReceived );
+    this->flushIfRecvProcessRequested ( guard );
+}
+
 void tcpiiu::flushIfRecvProcessRequested (
     epicsGuard < epicsMutex > & guard )
 {
@@ -1161,7 +1239,7 @@ bool tcpiiu::processIncoming (
                     this->recvQue.popOldMsgHeader ( this->curMsg );
                 if ( ! this->oldMsgHeaderAvailable ) {
                     epicsGuard < epicsMutex > guard ( this->mutex );
-                    this->flushIfRecvProcessRequested ( guard );
+                    this->recvProcessComplete ( guard );
                     return true;
                 }
             }
@@ -1171,7 +1249,7 @@ bool tcpiiu::processIncoming (
                     sizeof ( this->curMsg.m_count );
                 if ( this->recvQue.occupiedBytes () < annexSize ) {
                     epicsGuard < epicsMutex > guard ( this->mutex );
-                    this->flushIfRecvProcessRequested ( guard );
+                    this->recvProcessComplete ( guard );
                     return true;
                 }
                 this->curMsg.m_postsize = this->recvQue.popUInt32 ();
@@ -1256,12 +1334,18 @@ bool tcpiiu::processIncoming (
                             this->curMsg.m_postsize - this->curDataBytes );
                 if ( this->curDataBytes < this->curMsg.m_postsize ) {
                     epicsGuard < epicsMutex > guard ( this->mutex );
-                    this->flushIfRecvProcessRequested ( guard );
+                    this->recvProcessComplete ( guard );
                     return true;
                 }
             }
-            bool msgOK = this->cacRef.executeResponse ( mgr, *this,
+            bool msgOK;
+            if ( this->curMsg.m_cmmd == CA_PROTO_COMPRESSED ) {
+                msgOK = this->uncompressResponse ( currentTime, mgr );
+            }
+            else {
+                msgOK = this->cacRef.executeResponse ( mgr, *this,
                                 currentTime, this->curMsg, this->pCurData );
+            }
             if ( ! msgOK ) {
                 return false;
             }
@@ -1278,17 +1362,137 @@ bool tcpiiu::processIncoming (
                     this->curMsg.m_postsize - this->curDataBytes );
             if ( this->curDataBytes < this->curMsg.m_postsize  ) {
                 epicsGuard < epicsMutex > guard ( this->mutex );
-                this->flushIfRecvProcessRequested ( guard );
+                this->recvProcessComplete ( guard );
                 return true;
             }
         }
 
+        unsigned hdrSize = sizeof ( caHdr );
+        if ( this->curMsg.m_postsize >= 0xffff ||
+                this->curMsg.m_count >= 0xffff ) {
+            hdrSize += 2 * sizeof ( ca_uint32_t );
+        }
+        this->recvByteCounts.add ( this->curMsg.m_cmmd,
+            hdrSize + this->curMsg.m_postsize );
+
         this->oldMsgHeaderAvailable = false;
         this->msgHeaderAvailable = false;
         this->curDataBytes = 0u;
     }
 }
 
+//
+// expand a CA_PROTO_COMPRESSED response in the message body
+// cache and execute the original response
+//
+bool tcpiiu::uncompressResponse (
+    const epicsTime & currentTime,
+    callbackManager & mgr )
+{
+    caHdrLargeArray msg = this->curMsg;
+    const caCompressedHdr * pHdr =
+        reinterpret_cast < const caCompressedHdr * > ( this->pCurData );
+
+    {
+        epicsGuard < epicsMutex > guard ( this->mutex );
+        if ( ! this->cacRef.compressionThreshold ( guard ) ) {
+            this->printFormated ( mgr.cbGuard,
+                "CAC: server sent unrequested compressed response\n" );
+            return false;
+        }
+    }
+    if ( this->curMsg.m_postsize < sizeof ( *pHdr ) ||
+            pHdr->m_codec != CA_COMPRESS_SHUFFLE_RLE ) {
+        this->printFormated ( mgr.cbGuard,
+            "CAC: server sent unknown compressed response format\n" );
+        return false;
+    }
+    msg.m_cmmd = AlignedWireRef < const epicsUInt16 > ( pHdr->m_cmmd );
+    msg.m_postsize = AlignedWireRef < const epicsUInt32 > ( pHdr->m_postsize );
+    if ( msg.m_cmmd != CA_PROTO_READ && msg.m_cmmd != CA_PROTO_READ_NOTIFY &&
+            msg.m_cmmd != CA_PROTO_EVENT_ADD ) {
+        this->printFormated ( mgr.cbGuard,
+            "CAC: server sent compressed response %u\n", msg.m_cmmd );
+        return false;
+    }
+    if ( msg.m_postsize & 0x7 ) {
+        this->printFormated ( mgr.cbGuard,
+            "CAC: server sent missaligned payload 0x%x\n",
+            msg.m_postsize );
+        return false;
+    }
+
+    if ( msg.m_postsize > this->unzipDataMax ) {
+        if ( this->cacRef.tcpLargeRecvBufFreeList &&
+                msg.m_postsize > this->cacRef.maxRecvBytesTCP ) {
+            this->printFormated ( mgr.cbGuard,
+    "CAC: response with payload size=%u > EPICS_CA_MAX_ARRAY_BYTES ignored\n",
+                msg.m_postsize );
+            return true;
+        }
+        // round size up to multiple of 4K
+        arrayElementCount newsize = ( ( msg.m_postsize - 1 ) | 0xfff ) + 1;
+        char * newbuf = ( char * ) realloc ( this->pUnzipData, newsize );
+        if ( ! newbuf ) {
+            this->printFormated ( mgr.cbGuard,
+                "CAC: not enough memory for message body cache (ignoring response message)\n");
+            return true;
+        }
+        this->pUnzipData = newbuf;
+        this->unzipDataMax = newsize;
+    }
+
+    if ( caNetUncompress ( pHdr + 1, this->curMsg.m_postsize - sizeof ( *pHdr ),
+            pHdr->m_stride, this->pUnzipData, msg.m_postsize ) != ECA_NORMAL ) {
+        this->printFormated ( mgr.cbGuard,
+            "CAC: server sent corrupt compressed response\n" );
+        return false;
+    }
+    return this->cacRef.executeResponse ( mgr, *this,
+        currentTime, msg, this->pUnzipData );
+}
+
+//
+// Called by the receive thread from a callback to take ownership of
+// the message body cache holding the data at pData, which must be
+// the start of the current response's payload. A new cache replaces
+// it, and the caller must free the returned buffer using pFreeList,
+// or using free() when pFreeList is nil.
+//
+void * tcpiiu::pinResponseData (
+    const void * pData, void * & pFreeList )
+{
+    if ( pData == 0 ) {
+        return 0;
+    }
+    if ( pData == this->pUnzipData ) {
+        void * pPinned = this->pUnzipData;
+        this->pUnzipData = 0;
+        this->unzipDataMax = 0u;
+        pFreeList = 0;
+        return pPinned;
+    }
+    if ( pData == this->pCurData ) {
+        char * pNew = static_cast < char * > (
+            freeListMalloc ( this->cacRef.tcpSmallRecvBufFreeList ) );
+        if ( ! pNew ) {
+            return 0;
+        }
+        void * pPinned = this->pCurData;
+        if ( this->curDataMax <= MAX_TCP ) {
+            pFreeList = this->cacRef.tcpSmallRecvBufFreeList;
+        }
+        else {
+            // large buffers came from realloc() if there is no free list
+            pFreeList = this->cacRef.tcpLargeRecvBufFreeList;
+        }
+        this->pCurData = pNew;
+        this->curDataMax = MAX_TCP;
+        return pPinned;
+    }
+    return 0;
+}
+
 void tcpiiu::hostNameSetRequest ( epicsGuard < epicsMutex > & guard )
 {
     guard.assertIdenticalMutex ( this->mutex );
@@ -1393,7 +1597,8 @@ void tcpiiu::versionMessage ( epicsGuard < epicsMutex > & guard,
     this->sendQue.insertRequestHeader (
         CA_PROTO_VERSION, 0u,
         static_cast < ca_uint16_t > ( priority ),
-        CA_MINOR_PROTOCOL_REVISION, 0u, 0u,
+        CA_MINOR_PROTOCOL_REVISION, 0u,
+        this->cacRef.compressionThreshold ( guard ),
         CA_V49 ( this->minorProtocolVersion ) );
     minder.commit ();
 }
@@ -1417,6 +1622,39 @@ void tcpiiu::echoRequest ( epicsGuard < epicsMutex > & guard )
         0u, 0u, 0u, 0u,
         CA_V49 ( this->minorProtocolVersion ) );
     minder.commit ();
+    if ( ! this->echoTimePending ) {
+        this->echoBegin = epicsTime::getCurrent ();
+        this->echoTimePending = true;
+    }
+}
+
+// The time from queuing an echo request to the response includes
+// waiting for the send thread, as every other request does. Echo
+// responses are not matched to the requests, so a second request
+// sent before the response to the first arrives is not timed.
+void tcpiiu::echoRespNotify (
+    epicsGuard < epicsMutex > & guard, const epicsTime & currentTime )
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( this->echoTimePending ) {
+        double delay = currentTime - this->echoBegin;
+        this->echoTimes.add ( delay );
+        this->cacRef.echoTimes.add ( delay );
+        this->echoTimePending = false;
+    }
+}
+
+// measure the round trip time once when the circuit connects,
+// the receive watchdog sends echo requests only when it is idle
+void tcpiiu::roundTripProbe (
+    epicsGuard < epicsMutex > & guard )
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( this->echoTimes.count () == 0u && ! this->echoTimePending &&
+            CA_V43 ( this->minorProtocolVersion ) ) {
+        this->echoRequestPending = true;
+        this->sendThreadFlushEvent.signal ();
+    }
 }
 
 void tcpiiu::writeRequest ( epicsGuard < epicsMutex > & guard,
@@ -1431,6 +1669,7 @@ void tcpiiu::writeRequest ( epicsGuard < epicsMutex > & guard,
         type, nElem, chan.getSID(guard), chan.getCID(guard), pValue,
         CA_V49 ( this->minorProtocolVersion ) );
     minder.commit ();
+    this->flushPolicyNotify ( guard );
 }
 
 
@@ -1451,6 +1690,7 @@ void tcpiiu::writeNotifyRequest ( epicsGuard < epicsMutex > & guard,
         type, nElem, chan.getSID(guard), io.getId(), pValue,
         CA_V49 ( this->minorProtocolVersion ) );
     minder.commit ();
+    this->flushPolicyNotify ( guard );
 }
 
 void tcpiiu::readNotifyRequest ( epicsGuard < epicsMutex > & guard,
@@ -1483,6 +1723,7 @@ void tcpiiu::readNotifyRequest ( epicsGuard < epicsMutex > & guard,
         chan.getSID(guard), io.getId(),
         CA_V49 ( this->minorProtocolVersion ) );
     minder.commit ();
+    this->flushPolicyNotify ( guard );
 }
 
 void tcpiiu::createChannelRequest (
@@ -1549,6 +1790,7 @@ void tcpiiu::clearChannelRequest ( epicsGuard < epicsMutex > & guard,
         0u, 0u, sid, cid,
         CA_V49 ( this->minorProtocolVersion ) );
     minder.commit ();
+    this->flushPolicyNotify ( guard );
 }
 
 //
@@ -1601,6 +1843,7 @@ void tcpiiu::subscriptionRequest (
     this->sendQue.pushUInt16 ( static_cast < ca_uint16_t > ( mask ) ); // m_mask
     this->sendQue.pushUInt16 ( 0u ); // m_pad
     minder.commit ();
+    this->flushPolicyNotify ( guard );
 }
 
 //
@@ -1661,6 +1904,7 @@ void tcpiiu::subscriptionCancelRequest ( epicsGuard < epicsMutex > & guard,
         chan.getSID(guard), subscr.getId(),
         CA_V49 ( this->minorProtocolVersion ) );
     minder.commit ();
+    this->flushPolicyNotify ( guard );
 }
 
 bool tcpiiu::sendThreadFlush ( epicsGuard < epicsMutex > & guard )
@@ -1668,6 +1912,16 @@ bool tcpiiu::sendThreadFlush ( epicsGuard < epicsMutex > & guard )
     guard.assertIdenticalMutex ( this->mutex );
 
     if ( this->sendQue.occupiedBytes() > 0 ) {
+        this->sendFlushCount++;
+#if defined ( TCP_CORK )
+        // hold back the partial segment at the end of each
+        // comBuf so that they are coalesced
+        bool corked = this->sendQue.occupiedBytes () >
+            comBuf::capacityBytes ();
+        if ( corked ) {
+            this->setCork ( true );
+        }
+#endif
         while ( comBuf * pBuf = this->sendQue.popNextComBufToSend () ) {
             epicsTime current = epicsTime::getCurrent ();
 
@@ -1691,12 +1945,18 @@ bool tcpiiu::sendThreadFlush ( epicsGuard < epicsMutex > & guard )
 
             // set it here with this odd order because we must have
             // the lock and we must have already sent the bytes
+            this->sendByteCount += bytesToBeSent;
             this->unacknowledgedSendBytes += bytesToBeSent;
             if ( this->unacknowledgedSendBytes >
                 this->socketLibrarySendBufferSize ) {
                 this->recvDog.sendBacklogProgressNotify ( guard );
             }
         }
+#if defined ( TCP_CORK )
+        if ( corked ) {
+            this->setCork ( false );
+        }
+#endif
     }
 
     this->earlyFlush = false;
@@ -1756,6 +2016,24 @@ unsigned tcpiiu::requestMessageBytesPending (
     return sendQue.occupiedBytes ();
 }
 
+// the flush policy, applied after each user request is queued
+void tcpiiu::flushPolicyNotify ( epicsGuard < epicsMutex > & guard )
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( ! this->earlyFlush ) {
+        unsigned flushBytes = this->cacRef.flushBytes ();
+        double flushDelay = this->cacRef.flushDelay ();
+        if ( flushDelay == 0.0 || ( flushBytes > 0u &&
+                this->sendQue.occupiedBytes () >= flushBytes ) ) {
+            this->earlyFlush = true;
+            this->sendThreadFlushEvent.signal ();
+        }
+        else if ( flushDelay > 0.0 ) {
+            this->flushTimer.requestNotify ( guard );
+        }
+    }
+}
+
 void tcpiiu::decrementBlockingForFlushCount (
     epicsGuard < epicsMutex > & guard )
 {
@@ -2036,6 +2314,22 @@ int tcpiiu :: printFormated (
     return status;
 }
 
+#if defined ( TCP_CORK )
+void tcpiiu::setCork ( bool cork )
+{
+    int flag = cork;
+    int status = setsockopt ( this->sock, IPPROTO_TCP, TCP_CORK,
+                (char *) &flag, sizeof ( flag ) );
+    if ( status < 0 ) {
+        char sockErrBuf[64];
+        epicsSocketConvertErrnoToString (
+            sockErrBuf, sizeof ( sockErrBuf ) );
+        errlogPrintf ( "CAC: problems setting socket option TCP_CORK = \"%s\"\n",
+            sockErrBuf );
+    }
+}
+#endif
+
 void tcpiiu::flushRequest ( epicsGuard < epicsMutex > & )
 {
     if ( this->sendQue.occupiedBytes () > 0 ) {
@@ -2078,6 +2372,16 @@ double tcpiiu::receiveWatchdogDelay (
     return this->recvDog.delay ();
 }
 
+double tcpiiu::roundTripTime (
+    epicsGuard < epicsMutex > & guard ) const
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( this->echoTimes.count () ) {
+        return this->echoTimes.mean ();
+    }
+    return - DBL_MAX;
+}
+
 /*
  * Certain OS, such as HPUX, do not unblock a socket system call
  * when another thread asynchronously calls both shutdown() and
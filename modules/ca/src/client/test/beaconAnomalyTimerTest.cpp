@@ -0,0 +1,147 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS Base is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+/*
+ *  Tests of the beacon anomaly batches: anomalies arriving close
+ *  together must not lose the search for the channels that do not
+ *  match them, it is deferred to the end of the unmatched period.
+ */
+
+#include "epicsThread.h"
+#include "epicsTimer.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#include "beaconAnomalyTimer.h"
+
+// a short unmatched period, the batches are at least 1 sec apart
+static const double period = 3.0;
+
+namespace {
+
+struct batch {
+    epicsTime time;
+    bool matchedOnly;
+};
+
+class notify : public beaconAnomalyTimerNotify {
+public:
+    notify ( epicsMutex & mutexIn ) :
+        mutex ( mutexIn ), nBatches ( 0u ), skip ( false ) {}
+    bool beaconAnomalyBatchNotify ( epicsGuard < epicsMutex > &,
+        const epicsTime & currentTime, bool matchedOnly )
+    {
+        if ( this->nBatches < 16u ) {
+            this->batches[this->nBatches].time = currentTime;
+            this->batches[this->nBatches].matchedOnly = matchedOnly;
+        }
+        this->nBatches++;
+        return matchedOnly && this->skip;
+    }
+    // number of batches, and the last, with the lock
+    unsigned last ( batch & lastBatch )
+    {
+        epicsGuard < epicsMutex > guard ( this->mutex );
+        if ( this->nBatches && this->nBatches <= 16u ) {
+            lastBatch = this->batches[this->nBatches - 1u];
+        }
+        return this->nBatches;
+    }
+    void setSkip ( bool skipIn )
+    {
+        epicsGuard < epicsMutex > guard ( this->mutex );
+        this->skip = skipIn;
+    }
+    batch batches[16];
+private:
+    epicsMutex & mutex;
+    unsigned nBatches;
+    bool skip;
+};
+
+}
+
+static void anomaly ( beaconAnomalyTimer & tmr, epicsMutex & mutex )
+{
+    epicsGuard < epicsMutex > guard ( mutex );
+    tmr.request ( guard );
+}
+
+MAIN(beaconAnomalyTimerTest)
+{
+    testPlan(13);
+
+    epicsTimerQueueActive & queue =
+        epicsTimerQueueActive::allocate ( true );
+    epicsMutex mutex;
+    notify iiu ( mutex );
+    beaconAnomalyTimer tmr ( iiu, queue, mutex, period );
+    batch first, b;
+    unsigned n;
+
+    testDiag("Two anomalies close together");
+    iiu.setSkip ( true );
+    anomaly ( tmr, mutex );
+    epicsThreadSleep ( 0.3 );
+    n = iiu.last ( first );
+    testOk ( n == 1u && ! first.matchedOnly,
+        "First batch includes every channel" );
+
+    anomaly ( tmr, mutex );
+    epicsThreadSleep ( 1.0 );
+    n = iiu.last ( b );
+    testOk ( n == 2u && b.matchedOnly,
+        "Second batch is for the matching channels only" );
+
+    epicsThreadSleep ( period - 1.0 );
+    n = iiu.last ( b );
+    testOk ( n == 3u, "Deferred batch ran (%u batches)", n );
+    testOk ( ! b.matchedOnly, "It includes every channel" );
+    testOk ( b.time - first.time >= period - 0.05,
+        "At the end of the period (%.3f sec)", b.time - first.time );
+    first = b;
+
+    testDiag("An anomaly during the deferral is not delayed by it");
+    anomaly ( tmr, mutex );
+    epicsThreadSleep ( 1.0 );
+    n = iiu.last ( b );
+    testOk ( n == 4u && b.matchedOnly, "Matching channels searched" );
+
+    anomaly ( tmr, mutex );
+    epicsThreadSleep ( 1.0 );
+    n = iiu.last ( b );
+    testOk ( n == 5u && b.matchedOnly, "Matching channels searched again" );
+    testOk ( b.time - first.time < period - 0.5,
+        "Before the deferred batch (%.3f sec)", b.time - first.time );
+
+    epicsThreadSleep ( period - 1.5 );
+    n = iiu.last ( b );
+    testOk ( n == 6u && ! b.matchedOnly,
+        "Deferred batch includes every channel (%u batches)", n );
+    testOk ( b.time - first.time >= period - 0.05,
+        "At the end of the period (%.3f sec)", b.time - first.time );
+    first = b;
+
+    testDiag("Nothing is deferred when no channel was skipped");
+    iiu.setSkip ( false );
+    anomaly ( tmr, mutex );
+    epicsThreadSleep ( 1.0 );
+    n = iiu.last ( b );
+    testOk ( n == 7u && b.matchedOnly, "Matching channels searched" );
+    epicsThreadSleep ( period );
+    n = iiu.last ( b );
+    testOk ( n == 7u, "No deferred batch (%u batches)", n );
+
+    {
+        epicsGuard < epicsMutex > cbGuard ( mutex );
+        epicsGuard < epicsMutex > guard ( mutex );
+        tmr.shutdown ( cbGuard, guard );
+        tmr.request ( guard );
+    }
+    epicsThreadSleep ( 0.3 );
+    testOk ( iiu.last ( b ) == 7u, "No batches after shutdown" );
+
+    return testDone();
+}
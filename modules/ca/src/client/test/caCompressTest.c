@@ -0,0 +1,202 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS Base is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+/*
+ *  Tests of the CA_COMPRESS_SHUFFLE_RLE codec: caNetCompress() and
+ *  caNetUncompress() must round-trip any data, must never write past
+ *  the end of their destination buffers, and the decoder must reject
+ *  truncated and corrupt input.
+ */
+
+#include <string.h>
+
+#include "dbDefs.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+#include "caerr.h"
+#include "net_convert.h"
+
+#define MAX_SIZE 2048
+#define GUARD 16
+
+static unsigned char src[MAX_SIZE];
+static unsigned char packed[2 * MAX_SIZE + GUARD];
+static unsigned char unpacked[MAX_SIZE + GUARD];
+
+static unsigned seed = 1u;
+
+static unsigned char nextRandom(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (unsigned char) (seed >> 16);
+}
+
+typedef enum {
+    patZero, patRamp, patRandom, patRuns, patNumPatterns
+} pattern;
+
+static const char * const patternName[] = {
+    "zeros", "ramp", "random", "runs"
+};
+
+static void fill(pattern pat, unsigned size)
+{
+    unsigned i;
+
+    for (i = 0; i < size; i++) {
+        switch (pat) {
+        case patZero:   src[i] = 0; break;
+        case patRamp:   src[i] = (unsigned char) (i / 3); break;
+        case patRandom: src[i] = nextRandom(); break;
+        /* runs of all lengths around the codec's limits, then literals */
+        case patRuns:   src[i] = (i % 300) < 140 ? 7 : nextRandom(); break;
+        default:        break;
+        }
+    }
+}
+
+static int guardOk(const unsigned char *p)
+{
+    unsigned i;
+
+    for (i = 0; i < GUARD; i++)
+        if (p[i] != 0xa5)
+            return 0;
+    return 1;
+}
+
+static void testRoundTrip(void)
+{
+    static const unsigned strides[] = {1, 2, 4, 8};
+    static const unsigned sizes[] = {8, 64, 128, 136, 1024, MAX_SIZE};
+    unsigned s, z, nFail = 0, nCompressed = 0;
+    int pat;
+
+    for (pat = 0; pat < patNumPatterns; pat++) {
+        for (s = 0; s < NELEMENTS(strides); s++) {
+            for (z = 0; z < NELEMENTS(sizes); z++) {
+                unsigned stride = strides[s], size = sizes[z];
+                unsigned csize;
+
+                fill(pat, size);
+                memset(packed, 0xa5, sizeof(packed));
+                csize = caNetCompress(src, size, stride, packed,
+                    2 * MAX_SIZE);
+                if (csize == 0 || csize > 2 * MAX_SIZE ||
+                    !guardOk(packed + 2 * MAX_SIZE)) {
+                    testDiag("%s, stride %u, %u bytes: compress failed",
+                        patternName[pat], stride, size);
+                    nFail++;
+                    continue;
+                }
+                if (csize < size)
+                    nCompressed++;
+                memset(unpacked, 0xa5, sizeof(unpacked));
+                if (caNetUncompress(packed, csize, stride, unpacked,
+                        size) != ECA_NORMAL ||
+                    memcmp(unpacked, src, size) ||
+                    !guardOk(unpacked + size)) {
+                    testDiag("%s, stride %u, %u bytes: round trip failed",
+                        patternName[pat], stride, size);
+                    nFail++;
+                }
+            }
+        }
+    }
+    testOk(nFail == 0, "Data round-trips (%u failures)", nFail);
+    testOk(nCompressed > 0, "Compressible data gets smaller (%u cases)",
+        nCompressed);
+}
+
+static void testDestSize(void)
+{
+    unsigned csize, limit, nFail = 0;
+
+    fill(patRandom, MAX_SIZE);
+    csize = caNetCompress(src, MAX_SIZE, 2, packed, 2 * MAX_SIZE);
+    testOk(csize > MAX_SIZE, "Random data grows (%u to %u bytes)",
+        MAX_SIZE, csize);
+
+    /* every smaller destination must be refused without overrunning it */
+    for (limit = 0; limit < csize; limit++) {
+        memset(packed, 0xa5, sizeof(packed));
+        if (caNetCompress(src, MAX_SIZE, 2, packed, limit) != 0 ||
+            !guardOk(packed + limit))
+            nFail++;
+    }
+    testOk(nFail == 0, "Destinations too small are refused (%u failures)",
+        nFail);
+
+    testOk1(caNetCompress(src, 10, 4, packed, sizeof(packed)) == 0);
+    testOk1(caNetCompress(src, 8, 0, packed, sizeof(packed)) == 0);
+}
+
+static void testTruncated(void)
+{
+    unsigned csize, len, nFail = 0;
+
+    fill(patRuns, MAX_SIZE);
+    csize = caNetCompress(src, MAX_SIZE, 4, packed, 2 * MAX_SIZE);
+    testOk(csize > 0, "Compressed %u bytes to %u", MAX_SIZE, csize);
+
+    for (len = 0; len < csize; len++) {
+        memset(unpacked, 0xa5, sizeof(unpacked));
+        if (caNetUncompress(packed, len, 4, unpacked, MAX_SIZE) !=
+                ECA_BADCOUNT ||
+            !guardOk(unpacked + MAX_SIZE))
+            nFail++;
+    }
+    testOk(nFail == 0, "Truncated input is rejected (%u failures)", nFail);
+
+    testOk1(caNetUncompress(packed, csize, 4, unpacked, MAX_SIZE - 2) ==
+        ECA_BADCOUNT);
+    testOk1(caNetUncompress(packed, csize, 0, unpacked, MAX_SIZE) ==
+        ECA_BADCOUNT);
+}
+
+static void testCorrupt(void)
+{
+    static const unsigned char longRun[] = {0xff, 0x01};
+    static const unsigned char longLiteral[] = {0x03, 1, 2};
+    unsigned i, nFail = 0;
+
+    /* a run longer than the plane, and a literal longer than the input */
+    memset(unpacked, 0xa5, sizeof(unpacked));
+    testOk(caNetUncompress(longRun, sizeof(longRun), 1, unpacked, 16) ==
+        ECA_BADCOUNT && guardOk(unpacked + 16),
+        "Run past the end of the plane is rejected");
+    memset(unpacked, 0xa5, sizeof(unpacked));
+    testOk(caNetUncompress(longLiteral, sizeof(longLiteral), 1, unpacked,
+        16) == ECA_BADCOUNT && guardOk(unpacked + 16),
+        "Literal past the end of the input is rejected");
+
+    /* random input may decode or not, but must stay in bounds */
+    for (i = 0; i < 1000; i++) {
+        unsigned len = 1 + nextRandom() % 64;
+        unsigned k;
+        int status;
+
+        for (k = 0; k < len; k++)
+            packed[k] = nextRandom();
+        memset(unpacked, 0xa5, sizeof(unpacked));
+        status = caNetUncompress(packed, len, 1u << (i % 4), unpacked, 64);
+        if ((status != ECA_NORMAL && status != ECA_BADCOUNT) ||
+            !guardOk(unpacked + 64))
+            nFail++;
+    }
+    testOk(nFail == 0, "Random input stays in bounds (%u failures)", nFail);
+}
+
+MAIN(caCompressTest)
+{
+    testPlan(13);
+
+    testRoundTrip();
+    testDestSize();
+    testTruncated();
+    testCorrupt();
+
+    return testDone();
+}
@@ -0,0 +1,111 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS Base is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+/*
+ *  Benchmark of caNetConvert(), the network byte order conversion
+ *  used by the CA client library and by the RSRV server.
+ *
+ *  usage: caConvertBench [<max elements>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "epicsTime.h"
+#include "caerr.h"
+#include "net_convert.h"
+
+static const struct {
+    unsigned type;
+    const char *name;
+} types[] = {
+    {DBR_SHORT, "DBR_SHORT"},
+    {DBR_LONG, "DBR_LONG"},
+    {DBR_FLOAT, "DBR_FLOAT"},
+    {DBR_DOUBLE, "DBR_DOUBLE"},
+    {DBR_TIME_SHORT, "DBR_TIME_SHORT"},
+    {DBR_TIME_LONG, "DBR_TIME_LONG"},
+    {DBR_TIME_FLOAT, "DBR_TIME_FLOAT"},
+    {DBR_TIME_DOUBLE, "DBR_TIME_DOUBLE"},
+};
+
+/* Checks that a conversion from the network and back is unchanged */
+static void checkConvert(unsigned type, const char *src, char *dst,
+                         char *chk, unsigned long count)
+{
+    unsigned off = dbr_value_offset[type];
+    size_t size = count * dbr_value_size[type];
+
+    if (caNetConvert(type, src, dst, 0, count) != ECA_NORMAL ||
+        caNetConvert(type, dst, chk, 1, count) != ECA_NORMAL ||
+        memcmp(src + off, chk + off, size)) {
+        fprintf(stderr, "caNetConvert(%u) of %lu elements is wrong\n",
+                type, count);
+        exit(1);
+    }
+}
+
+/* returns ns per element */
+static double timeConvert(unsigned type, const void *src, void *dst,
+                          int hton, unsigned long count)
+{
+    unsigned long niter = 20000000ul / count + 1, i;
+    epicsUInt64 start = epicsMonotonicGet();
+
+    for (i = 0; i < niter; i++) {
+        if (caNetConvert(type, src, dst, hton, count) != ECA_NORMAL) {
+            fprintf(stderr, "caNetConvert(%u) fails\n", type);
+            exit(1);
+        }
+    }
+    return (epicsMonotonicGet() - start) / (double) (niter * count);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long maxCount = 1000000;
+    unsigned long count;
+    size_t maxSize;
+    char *src, *dst, *chk;
+    unsigned i;
+
+    if (argc > 1)
+        maxCount = strtoul(argv[1], NULL, 0);
+    if (maxCount < 1)
+        maxCount = 1;
+
+    maxSize = dbr_size_n(DBR_TIME_DOUBLE, maxCount);
+    src = calloc(1, maxSize);
+    dst = calloc(1, maxSize);
+    chk = calloc(1, maxSize);
+    if (!src || !dst || !chk) {
+        fprintf(stderr, "no memory\n");
+        return 1;
+    }
+    for (i = 0; i < maxSize; i++)
+        src[i] = (char) i;
+
+    printf("ns/element  %-16s %10s %10s %10s %10s\n",
+           "type", "elements", "hton", "ntoh", "in place");
+    for (count = 1; count <= maxCount; count *= 10) {
+        for (i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+            double enc, dec, inp;
+
+            checkConvert(types[i].type, src, dst, chk, count);
+            enc = timeConvert(types[i].type, src, dst, 1, count);
+            dec = timeConvert(types[i].type, src, dst, 0, count);
+            inp = timeConvert(types[i].type, dst, dst, 0, count);
+
+            printf("            %-16s %10lu %10.3f %10.3f %10.3f\n",
+                   types[i].name, count, enc, dec, inp);
+        }
+    }
+
+    free(src);
+    free(dst);
+    free(chk);
+    return 0;
+}
@@ -0,0 +1,123 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS Base is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+/*
+ *  Tests of caNetConvert() for the numeric array types, comparing the
+ *  bulk byte swap loops with a byte by byte reference for odd lengths
+ *  and unaligned buffers, in both directions and in place.
+ */
+
+#include <string.h>
+
+#include "epicsEndian.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+#include "caerr.h"
+#include "net_convert.h"
+
+#define MAX_COUNT 67
+#define MAX_OFFSET 8
+
+static const struct {
+    unsigned type;
+    const char *name;
+} types[] = {
+    {DBR_SHORT, "DBR_SHORT"},
+    {DBR_ENUM, "DBR_ENUM"},
+    {DBR_LONG, "DBR_LONG"},
+    {DBR_FLOAT, "DBR_FLOAT"},
+    {DBR_DOUBLE, "DBR_DOUBLE"},
+};
+
+static char src[MAX_COUNT * 8 + MAX_OFFSET];
+static char dst[MAX_COUNT * 8 + MAX_OFFSET];
+static char expect[MAX_COUNT * 8];
+
+/* network byte order is big endian, swap each element on other hosts */
+static void reference(const char *pSrc, char *pDest, unsigned size,
+    unsigned long count)
+{
+    unsigned long i;
+    unsigned k;
+
+    for (i = 0; i < count; i++) {
+        for (k = 0; k < size; k++) {
+#if EPICS_BYTE_ORDER == EPICS_ENDIAN_BIG
+            pDest[i * size + k] = pSrc[i * size + k];
+#else
+            pDest[i * size + k] = pSrc[i * size + size - 1 - k];
+#endif
+        }
+    }
+}
+
+/* Returns the number of failed conversions for one type */
+static unsigned testType(unsigned type)
+{
+    unsigned size = dbr_value_size[type];
+    unsigned nFail = 0;
+    unsigned long count;
+    unsigned srcOff, dstOff;
+    int hton;
+
+    for (count = 1; count <= MAX_COUNT; count++) {
+        size_t nBytes = size * count;
+
+        for (srcOff = 0; srcOff < MAX_OFFSET; srcOff++) {
+            for (dstOff = 0; dstOff < MAX_OFFSET; dstOff++) {
+                /* a single element is converted in place by type */
+                if (count == 1 && (srcOff % size || dstOff % size))
+                    continue;
+                for (hton = 0; hton < 2; hton++) {
+                    memset(dst, 0x5a, sizeof(dst));
+                    reference(src + srcOff, expect, size, count);
+                    if (caNetConvert(type, src + srcOff, dst + dstOff,
+                            hton, count) != ECA_NORMAL ||
+                        memcmp(dst + dstOff, expect, nBytes) ||
+                        (dstOff && dst[dstOff - 1] != 0x5a) ||
+                        dst[dstOff + nBytes] != 0x5a) {
+                        if (!nFail)
+                            testDiag("%lu elements, offsets %u and %u fail",
+                                count, srcOff, dstOff);
+                        nFail++;
+                    }
+                }
+            }
+            /* in place */
+            memcpy(dst + srcOff, src, nBytes);
+            reference(src, expect, size, count);
+            if (count > 1 || srcOff % size == 0) {
+                if (caNetConvert(type, dst + srcOff, dst + srcOff, 0,
+                        count) != ECA_NORMAL ||
+                    memcmp(dst + srcOff, expect, nBytes)) {
+                    if (!nFail)
+                        testDiag("%lu elements in place, offset %u fails",
+                            count, srcOff);
+                    nFail++;
+                }
+            }
+        }
+    }
+    return nFail;
+}
+
+MAIN(caConvertTest)
+{
+    unsigned i;
+
+    testPlan(sizeof(types) / sizeof(types[0]));
+
+    for (i = 0; i < sizeof(src); i++)
+        src[i] = (char) (i * 7 + 1);
+
+    for (i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        unsigned nFail = testType(types[i].type);
+
+        testOk(nFail == 0, "%s matches byte by byte swap (%u failures)",
+            types[i].name, nFail);
+    }
+
+    return testDone();
+}
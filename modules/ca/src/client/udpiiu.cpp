@@ -131,9 +131,14 @@ udpiiu::udpiiu (
     repeaterSubscribeTmr (
         m_repeaterTimerNotify, timerQueue, cbMutexIn, ctxNotifyIn ),
     govTmr ( *this, timerQueue, cacMutexIn ),
+    anomalyTmr ( *this, timerQueue, cacMutexIn,
+        beaconAnomalyUnmatchedPeriod ),
     maxPeriod ( getMaxPeriod() ),
     rtteMean ( minRoundTripEstimate ),
     rtteMeanDev ( 0 ),
+    anomalyBatches ( 0u ),
+    anomalyChansSearched ( 0u ),
+    anomalyChansSkipped ( 0u ),
     cacRef ( cac ),
     cbMutex ( cbMutexIn ),
     cacMutex ( cacMutexIn ),
@@ -337,6 +342,7 @@ void udpiiu::shutdown (
     // stop all of the timers
     this->repeaterSubscribeTmr.shutdown ( cbGuard, guard );
     this->govTmr.shutdown ( cbGuard, guard );
+    this->anomalyTmr.shutdown ( cbGuard, guard );
     for ( unsigned i =0; i < this->nTimers; i++ ) {
         this->ppSearchTmr[i]->shutdown ( cbGuard, guard );
     }
@@ -1174,6 +1180,39 @@ void udpiiu :: show ( unsigned level ) const
     }
 }
 
+const timeHistogram & udpiiu :: searchResponseTimes (
+    epicsGuard < epicsMutex > & guard ) const
+{
+    guard.assertIdenticalMutex ( this->cacMutex );
+    return this->searchTimes;
+}
+
+void udpiiu :: showSearchStatistics (
+    epicsGuard < epicsMutex > & guard ) const
+{
+    guard.assertIdenticalMutex ( this->cacMutex );
+
+    unsigned pending = 0u;
+    for ( unsigned i = 0; i < this->nTimers; i++ ) {
+        pending += this->ppSearchTmr[i]->channelCount ( guard );
+    }
+    ::printf ( "\tchannels waiting for a search response %u, "
+        "search round trip estimate %.3f ms\n", pending,
+        this->getRTTE ( guard ) * 1e3 );
+    ::printf ( "\tsearch window %g datagrams\n",
+        this->ppSearchTmr[0]->window ( guard ) );
+    this->searchTimes.show ( "channels found by search" );
+}
+
+void udpiiu :: showBeaconAnomalyStatistics (
+    epicsGuard < epicsMutex > & guard ) const
+{
+    guard.assertIdenticalMutex ( this->cacMutex );
+    ::printf ( "\tbeacon anomalies handled in %lu batches, "
+        "%lu channels searched again, %lu not\n", this->anomalyBatches,
+        this->anomalyChansSearched, this->anomalyChansSkipped );
+}
+
 bool udpiiu::wakeupMsg ()
 {
     caHdr msg;
@@ -1198,11 +1237,44 @@ bool udpiiu::wakeupMsg ()
 void udpiiu::beaconAnomalyNotify (
     epicsGuard < epicsMutex > & cacGuard )
 {
+    this->anomalyTmr.request ( cacGuard );
+}
+
+//
+// Search again without delay for the disconnected channels last
+// connected to a server with a beacon anomaly in this batch. The
+// other channels are included only once per unmatched period (see
+// beaconAnomalyTimer), so that servers restarting one after the
+// other do not keep all of the channels that cannot be found on the
+// fastest search timers. Returns true if any of them were skipped.
+//
+bool udpiiu::beaconAnomalyBatchNotify (
+    epicsGuard < epicsMutex > & cacGuard, const epicsTime & /* currentTime */,
+    bool matchedOnly )
+{
+    unsigned nMoved = 0u;
+    unsigned nSkipped = 0u;
     for ( unsigned i = this->beaconAnomalyTimerIndex+1u;
             i < this->nTimers; i++ ) {
         this->ppSearchTmr[i]->moveChannels ( cacGuard,
-            *this->ppSearchTmr[this->beaconAnomalyTimerIndex] );
+            *this->ppSearchTmr[this->beaconAnomalyTimerIndex],
+            matchedOnly, nMoved, nSkipped );
+    }
+    this->anomalyBatches++;
+    this->anomalyChansSearched += nMoved;
+    this->anomalyChansSkipped += nSkipped;
+    this->cacRef.beaconAnomalyBatchComplete ( cacGuard );
+    return nSkipped > 0u;
+}
+
+bool udpiiu::beaconAnomalyMatch (
+    epicsGuard < epicsMutex > & guard, const nciu & chan ) const
+{
+    struct sockaddr_in addr;
+    if ( ! chan.previousServer ( guard, addr ) ) {
+        return false;
     }
+    return this->cacRef.beaconAnomalyPending ( guard, inetAddrID ( addr ) );
 }
 
 void udpiiu::uninstallChanDueToSuccessfulSearchResponse (
@@ -1215,6 +1287,8 @@ void udpiiu::uninstallChanDueToSuccessfulSearchResponse (
         this->govTmr.uninstallChan ( guard, chan );
     }
     else {
+        this->searchTimes.add (
+            currentTime - chan.searchBeginTime ( guard ) );
         this->ppSearchTmr[ chan.getSearchTimerIndex ( guard ) ]->
             uninstallChanDueToSuccessfulSearchResponse (
             guard, chan, this->lastReceivedSeqNo,
@@ -1254,6 +1328,7 @@ void udpiiu::installNewChannel (
     epicsGuard < epicsMutex > & guard, nciu & chan, netiiu * & piiu )
 {
     piiu = this;
+    chan.setSearchBeginTime ( guard, epicsTime::getCurrent () );
     this->ppSearchTmr[0]->installChannel ( guard, chan );
 }
 
@@ -1287,6 +1362,7 @@ void udpiiu::boostChannel (
 void udpiiu::govExpireNotify (
     epicsGuard < epicsMutex > & guard, nciu & chan )
 {
+    chan.setSearchBeginTime ( guard, epicsTime::getCurrent () );
     this->ppSearchTmr[0]->installChannel ( guard, chan );
 }
 
@@ -1442,6 +1518,12 @@ double udpiiu::receiveWatchdogDelay (
     return netiiu::receiveWatchdogDelay ( guard );
 }
 
+double udpiiu::roundTripTime (
+    epicsGuard < epicsMutex > & guard ) const
+{
+    return netiiu::roundTripTime ( guard );
+}
+
 ca_uint32_t udpiiu::datagramSeqNumber (
     epicsGuard < epicsMutex > & ) const
 {
@@ -37,8 +37,10 @@
 #include "netiiu.h"
 #include "searchTimer.h"
 #include "disconnectGovernorTimer.h"
+#include "beaconAnomalyTimer.h"
 #include "repeaterSubscribeTimer.h"
 #include "SearchDest.h"
+#include "timeHistogram.h"
 
 namespace ca {
 #if __cplusplus>=201103L
@@ -87,11 +89,15 @@ static const double maxRoundTripEstimate = 30; // seconds
 static const double maxSearchPeriodDefault = 5.0 * 60.0; // seconds
 static const double maxSearchPeriodLowerLimit = 60.0; // seconds
 static const double beaconAnomalySearchPeriod = 5.0; // seconds
+// channels not last connected to a server with a beacon anomaly
+// are searched for again because of an anomaly no more often than
+static const double beaconAnomalyUnmatchedPeriod = 30.0; // seconds
 
 class udpiiu :
     private netiiu,
     private searchTimerNotify,
-    private disconnectGovernorNotify {
+    private disconnectGovernorNotify,
+    private beaconAnomalyTimerNotify {
 public:
     udpiiu (
         epicsGuard < epicsMutex > & cacGuard,
@@ -112,6 +118,12 @@ public:
     void shutdown ( epicsGuard < epicsMutex > & cbGuard,
         epicsGuard < epicsMutex > & guard );
     void show ( unsigned level ) const;
+    void showSearchStatistics (
+        epicsGuard < epicsMutex > & ) const;
+    void showBeaconAnomalyStatistics (
+        epicsGuard < epicsMutex > & ) const;
+    const timeHistogram & searchResponseTimes (
+        epicsGuard < epicsMutex > & ) const;
 
     // exceptions
     class noSocket {};
@@ -163,10 +175,15 @@ private:
     M_repeaterTimerNotify m_repeaterTimerNotify;
     repeaterSubscribeTimer repeaterSubscribeTmr;
     disconnectGovernorTimer govTmr;
+    beaconAnomalyTimer anomalyTmr;
     tsDLList < SearchDest > _searchDestList;
     const double maxPeriod;
     double rtteMean;
     double rtteMeanDev;
+    timeHistogram searchTimes;
+    unsigned long anomalyBatches;
+    unsigned long anomalyChansSearched;
+    unsigned long anomalyChansSkipped;
     cac & cacRef;
     epicsMutex & cbMutex;
     epicsMutex & cacMutex;
@@ -285,6 +302,8 @@ private:
     const class epicsTime & currentTime );
         double receiveWatchdogDelay (
         epicsGuard < epicsMutex > & ) const;
+    double roundTripTime (
+        epicsGuard < epicsMutex > & ) const;
     bool searchMsg (
         epicsGuard < epicsMutex > &, ca_uint32_t id,
             const char * pName, unsigned nameLength );
@@ -301,11 +320,18 @@ private:
         epicsGuard < epicsMutex > &, const epicsTime & currentTime );
     ca_uint32_t datagramSeqNumber (
         epicsGuard < epicsMutex > & ) const;
+    bool beaconAnomalyMatch (
+        epicsGuard < epicsMutex > &, const nciu & ) const;
 
     // disconnectGovernorNotify
     void govExpireNotify (
         epicsGuard < epicsMutex > &, nciu & );
 
+    // beaconAnomalyTimerNotify
+    bool beaconAnomalyBatchNotify (
+        epicsGuard < epicsMutex > &, const epicsTime & currentTime,
+        bool matchedOnly );
+
     udpiiu ( const udpiiu & );
     udpiiu & operator = ( const udpiiu & );
 
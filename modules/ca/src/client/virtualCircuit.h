@@ -35,8 +35,11 @@
 #include "comQueRecv.h"
 #include "tcpRecvWatchdog.h"
 #include "tcpSendWatchdog.h"
+#include "tcpFlushTimer.h"
 #include "hostNameCache.h"
 #include "SearchDest.h"
+#include "timeHistogram.h"
+#include "messageByteCounts.h"
 #include "compilerDependencies.h"
 
 class callbackManager;
@@ -109,6 +112,9 @@ private:
     bool _active;
 };
 
+// the circuit whose receive thread is running, if any
+extern epicsThreadPrivateId caClientRecvCircuitId;
+
 class tcpiiu :
         public netiiu, public tsDLNode < tcpiiu >,
         public tsSLNode < tcpiiu >, public caServerID,
@@ -139,6 +145,10 @@ public:
         epicsGuard < epicsMutex > & );
     void probeResponseNotify (
         epicsGuard < epicsMutex > & );
+    void echoRespNotify (
+        epicsGuard < epicsMutex > &, const epicsTime & currentTime );
+    void roundTripProbe (
+        epicsGuard < epicsMutex > & );
 
     void flushRequest (
         epicsGuard < epicsMutex > & );
@@ -148,6 +158,8 @@ public:
         epicsGuard < epicsMutex > & mutualExclusionGuard );
 
     void show ( unsigned level ) const;
+    void * pinResponseData (
+        const void * pData, void * & pFreeList );
     bool setEchoRequestPending (
         epicsGuard < epicsMutex > & );
     void requestRecvProcessPostponedFlush (
@@ -158,6 +170,8 @@ public:
 
     bool ca_v41_ok (
         epicsGuard < epicsMutex > & ) const;
+    bool ca_v41_ok (
+        callbackManager & ) const;
     bool ca_v42_ok (
         epicsGuard < epicsMutex > & ) const;
     bool ca_v44_ok (
@@ -210,6 +224,7 @@ private:
     tcpSendThread sendThread;
     tcpRecvWatchdog recvDog;
     tcpSendWatchdog sendDog;
+    tcpFlushTimer flushTimer;
     comQueSend sendQue;
     comQueRecv recvQue;
     // nciu state field tells us which list
@@ -222,11 +237,16 @@ private:
     tsDLList < nciu > unrespCircuit;
     tsDLList < nciu > subscripUpdateReqPend;
     caHdrLargeArray curMsg;
+    messageByteCounts recvByteCounts; // only modified by the recv thread
+    timeHistogram echoTimes;
+    epicsTime echoBegin;
     arrayElementCount curDataMax;
     arrayElementCount curDataBytes;
+    arrayElementCount unzipDataMax;
     comBufMemoryManager & comBufMemMgr;
     cac & cacRef;
     char * pCurData;
+    char * pUnzipData;
     SearchDestTCP * pSearchDest;
     epicsMutex & mutex;
     epicsMutex & cbMutex;
@@ -242,6 +262,12 @@ private:
     epicsEvent flushBlockEvent;
     SOCKET sock;
     unsigned contigRecvMsgCount;
+    unsigned recvBatchLimit; // only modified by the recv thread
+    unsigned recvBatchCount;
+    unsigned recvBufCount;
+    unsigned sendFlushCount;
+    unsigned sendCallCount;
+    epicsUInt64 sendByteCount;
     unsigned blockingForFlush;
     unsigned socketLibrarySendBufferSize;
     unsigned unacknowledgedSendBytes;
@@ -250,6 +276,7 @@ private:
     bool busyStateDetected; // only modified by the recv thread
     bool flowControlActive; // only modified by the send process thread
     bool echoRequestPending;
+    bool echoTimePending;
     bool oldMsgHeaderAvailable;
     bool msgHeaderAvailable;
     bool earlyFlush;
@@ -260,6 +287,8 @@ private:
 
     bool processIncoming (
         const epicsTime & currentTime, callbackManager & );
+    bool uncompressResponse (
+        const epicsTime & currentTime, callbackManager & );
     unsigned sendBytes ( const void *pBuf,
         unsigned nBytesInBuf, const epicsTime & currentTime );
     void recvBytes (
@@ -268,6 +297,8 @@ private:
         epicsGuard < epicsMutex > & ) const throw ();
     double receiveWatchdogDelay (
         epicsGuard < epicsMutex > & ) const;
+    double roundTripTime (
+        epicsGuard < epicsMutex > & ) const;
     void unresponsiveCircuitNotify (
         epicsGuard < epicsMutex > & cbGuard,
         epicsGuard < epicsMutex > & guard );
@@ -278,6 +309,10 @@ private:
     void disconnectNotify (
         epicsGuard < epicsMutex > & );
     bool bytesArePendingInOS () const;
+    void flushPolicyNotify ( epicsGuard < epicsMutex > & );
+#if defined ( TCP_CORK )
+    void setCork ( bool cork );
+#endif
     void decrementBlockingForFlushCount (
         epicsGuard < epicsMutex > & guard );
     bool isNameService () const;
@@ -317,6 +352,8 @@ private:
     void subscriptionCancelRequest (
         epicsGuard < epicsMutex > &,
         nciu & chan, netSubscription & subscr );
+    void recvProcessComplete (
+        epicsGuard < epicsMutex > & );
     void flushIfRecvProcessRequested (
         epicsGuard < epicsMutex > & );
     bool sendThreadFlush (
@@ -357,6 +394,14 @@ inline bool tcpiiu::ca_v41_ok (
     return CA_V41 ( this->minorProtocolVersion );
 }
 
+// the minor version is only changed by the receive thread, which
+// may check it without the primary lock while processing messages
+inline bool tcpiiu::ca_v41_ok (
+    callbackManager & ) const
+{
+    return CA_V41 ( this->minorProtocolVersion );
+}
+
 inline bool tcpiiu::ca_v44_ok (
     epicsGuard < epicsMutex > & ) const
 {
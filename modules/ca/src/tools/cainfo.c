@@ -41,7 +41,8 @@ void usage (void)
     "  -V: Version: Show EPICS and CA versions\n"
     "Channel Access options:\n"
     "  -w <sec>:   Wait time, specifies CA timeout, default is %f second(s)\n"
-    "  -s <level>: Call ca_client_status with the specified interest level\n"
+    "  -s <level>: Read the PVs, print their server round trip times and call\n"
+    "              ca_client_status with the specified interest level\n"
     "  -p <prio>:  CA priority (0-%u, default 0=lowest)\n"
     "\nExample: cainfo my_channel another_channel\n\n"
              , DEFAULT_TIMEOUT, CA_PRIORITY_MAX);
@@ -75,6 +76,32 @@ int cainfo (pv *pvs, int nPvs)
     char *boolStrings[] = { "no ", "" };
 
     if (statLevel) {
+                                /* Read each channel once, so that the */
+                                /* latency statistics include a get    */
+                                /* ----------------------------------- */
+        for (n = 0; n < nPvs; n++) {
+            if (ca_state(pvs[n].chid) != cs_conn)
+                continue;
+            pvs[n].nElems  = ca_element_count(pvs[n].chid);
+            pvs[n].dbrType = dbf_type_to_DBR(ca_field_type(pvs[n].chid));
+            pvs[n].value   = calloc(1, dbr_size_n(pvs[n].dbrType,
+                                                  pvs[n].nElems));
+            if (pvs[n].value)
+                ca_array_get(pvs[n].dbrType, pvs[n].nElems,
+                             pvs[n].chid, pvs[n].value);
+        }
+        ca_pend_io(caTimeout);
+
+        for (n = 0; n < nPvs; n++) {
+            double rtt = ca_round_trip_time(pvs[n].chid);
+
+            free(pvs[n].value);
+            pvs[n].value = NULL;
+            if (rtt >= 0)
+                printf("%s\n"
+                       "    Round trip time:  %.3f ms\n"
+                       , pvs[n].name, rtt * 1e3);
+        }
         ca_client_status(statLevel);
 
     } else {
@@ -901,6 +901,21 @@ long dbGetField(DBADDR *paddr,short dbrType,
     dbCommon *precord = paddr->precord;
     long status = 0;
 
+    if (dbLockReadable(paddr, dbrType, options ? *options : 0, pflin)) {
+        dbLockReader reader;
+        long saveOptions = options ? *options : 0;
+        long saveRequest = nRequest ? *nRequest : 0;
+
+        if (dbLockReadBegin(precord, &reader)) {
+            status = dbGet(paddr, dbrType, pbuffer, options, nRequest, pflin);
+            if (dbLockReadEnd(&reader))
+                return status;
+            /* raced with a writer, try again with the lock */
+            if (options) *options = saveOptions;
+            if (nRequest) *nRequest = saveRequest;
+        }
+    }
+
     dbScanLock(precord);
     status = dbGet(paddr, dbrType, pbuffer, options, nRequest, pflin);
     dbScanUnlock(precord);
@@ -215,6 +215,10 @@ private:
         epicsGuard < epicsMutex > & ) const;
     void show (
         epicsGuard < epicsMutex > &, unsigned level ) const;
+    int latency ( epicsGuard < epicsMutex > &,
+        int select, struct ca_latency_summary & ) const;
+    int messageBytes ( epicsGuard < epicsMutex > &,
+        unsigned command, double & sent, double & received ) const;
 
     dbContext ( const dbContext & );
     dbContext & operator = ( const dbContext & );
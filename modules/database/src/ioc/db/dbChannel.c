@@ -638,13 +638,8 @@ long dbChannelGet(dbChannel *chan, short type, void *pbuffer,
 long dbChannelGetField(dbChannel *chan, short dbrType, void *pbuffer,
         long *options, long *nRequest, void *pfl)
 {
-    dbCommon *precord = chan->addr.precord;
-    long status = 0;
-
-    dbScanLock(precord);
-    status = dbChannelGet(chan, dbrType, pbuffer, options, nRequest, pfl);
-    dbScanUnlock(precord);
-    return status;
+    /* same as dbChannelGet(), including optimistic reads */
+    return dbGetField(&chan->addr, dbrType, pbuffer, options, nRequest, pfl);
 }
 
 /* Only use dbChannelPut() if the record is already locked.
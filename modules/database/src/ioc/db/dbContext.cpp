@@ -432,4 +432,30 @@ unsigned dbContext::beaconAnomaliesSinceProgramStart (
     }
 }
 
+// the database has no network requests to measure
+int dbContext::latency ( epicsGuard < epicsMutex > & guard,
+    int select, struct ca_latency_summary & summary ) const
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( this->pNetContext.get() ) {
+        return this->pNetContext->latency ( guard, select, summary );
+    }
+    else {
+        return ECA_UNAVAILINSERV;
+    }
+}
+
+int dbContext::messageBytes ( epicsGuard < epicsMutex > & guard,
+    unsigned command, double & sent, double & received ) const
+{
+    guard.assertIdenticalMutex ( this->mutex );
+    if ( this->pNetContext.get() ) {
+        return this->pNetContext->messageBytes (
+            guard, command, sent, received );
+    }
+    else {
+        return ECA_UNAVAILINSERV;
+    }
+}
+
 
@@ -60,22 +60,39 @@ static void copyNoConvert(const void *pfrom,
 #define COPYNOCONVERT(N, FROM, TO, NREQ, NO_ELEM, OFFSET) \
     copyNoConvert(FROM, TO, (N)*(NREQ), (N)*(NO_ELEM), (N)*(OFFSET))
 
+/* Number of elements to convert before wrapping back to the start
+ * of a ring buffer array field.  An offset outside of the array never
+ * wraps, and at most one wrap is made.
+ */
+static long wrapSpan(long nRequest, long no_elements, long offset)
+{
+    if (offset >= 0 && offset < no_elements && offset + nRequest > no_elements)
+        return no_elements - offset;
+    return nRequest;
+}
+
+/* The array conversions are done in two contiguous spans, before and
+ * after the wrap.  With no test inside the loops the compiler is free
+ * to vectorize them for the target instruction set.
+ */
 #define GET(typea, typeb) (const dbAddr *paddr, \
     void *pto, long nRequest, long no_elements, long offset) \
 { \
-    typea *psrc = (typea *) paddr->pfield; \
+    const typea *pfield = (const typea *) paddr->pfield; \
+    const typea *psrc = pfield + offset; \
     typeb *pdst = (typeb *) pto; \
+    long i, n; \
     \
     if (nRequest==1 && offset==0) { \
-        *pdst = (typeb) *psrc; \
+        *pdst = (typeb) *pfield; \
         return 0; \
     } \
-    psrc += offset; \
-    while (nRequest--) { \
-        *pdst++ = (typeb) *psrc++; \
-        if (++offset == no_elements) \
-            psrc = (typea *) paddr->pfield; \
-    } \
+    n = wrapSpan(nRequest, no_elements, offset); \
+    for (i = 0; i < n; i++) \
+        pdst[i] = (typeb) psrc[i]; \
+    pdst += n; \
+    for (i = 0; i < nRequest - n; i++) \
+        pdst[i] = (typeb) pfield[i]; \
     return 0; \
 }
 
@@ -97,18 +114,20 @@ static void copyNoConvert(const void *pfrom,
     const void *pfrom, long nRequest, long no_elements, long offset) \
 { \
     const typea *psrc = (const typea *) pfrom; \
-    typeb *pdst = (typeb *) paddr->pfield; \
+    typeb *pfield = (typeb *) paddr->pfield; \
+    typeb *pdst = pfield + offset; \
+    long i, n; \
     \
     if (nRequest==1 && offset==0) { \
-        *pdst = (typeb) *psrc; \
+        *pfield = (typeb) *psrc; \
         return 0; \
     } \
-    pdst += offset; \
-    while (nRequest--) { \
-        *pdst++ = (typeb) *psrc++; \
-        if (++offset == no_elements) \
-            pdst = (typeb *) paddr->pfield; \
-    } \
+    n = wrapSpan(nRequest, no_elements, offset); \
+    for (i = 0; i < n; i++) \
+        pdst[i] = (typeb) psrc[i]; \
+    psrc += n; \
+    for (i = 0; i < nRequest - n; i++) \
+        pfield[i] = (typeb) psrc[i]; \
     return 0; \
 }
 
@@ -810,20 +829,21 @@ static long getDoubleUInt64 GET(epicsFloat64, epicsUInt64)
 static long getDoubleFloat(const dbAddr *paddr,
     void *pto, long nRequest, long no_elements, long offset)
 {
-    epicsFloat64 *psrc = (epicsFloat64 *) paddr->pfield;
+    const epicsFloat64 *pfield = (const epicsFloat64 *) paddr->pfield;
+    const epicsFloat64 *psrc = pfield + offset;
     epicsFloat32 *pdst = (epicsFloat32 *) pto;
+    long i, n;
 
     if (nRequest==1 && offset==0) {
-        *pdst = epicsConvertDoubleToFloat(*psrc);
+        *pdst = epicsConvertDoubleToFloat(*pfield);
         return 0;
     }
-    psrc += offset;
-    while (nRequest--) {
-        *pdst = epicsConvertDoubleToFloat(*psrc);
-        ++psrc; ++pdst;
-        if (++offset == no_elements)
-            psrc = (epicsFloat64 *) paddr->pfield;
-    }
+    n = wrapSpan(nRequest, no_elements, offset);
+    for (i = 0; i < n; i++)
+        pdst[i] = epicsConvertDoubleToFloat(psrc[i]);
+    pdst += n;
+    for (i = 0; i < nRequest - n; i++)
+        pdst[i] = epicsConvertDoubleToFloat(pfield[i]);
     return 0;
 }
 
@@ -1640,18 +1660,20 @@ static long putDoubleFloat(dbAddr *paddr,
     const void *pfrom, long nRequest, long no_elements, long offset)
 {
     const epicsFloat64 *psrc = (const epicsFloat64 *) pfrom;
-    epicsFloat32 *pdst = (epicsFloat32 *) paddr->pfield;
+    epicsFloat32 *pfield = (epicsFloat32 *) paddr->pfield;
+    epicsFloat32 *pdst = pfield + offset;
+    long i, n;
 
     if (nRequest==1 && offset==0) {
-        *pdst = epicsConvertDoubleToFloat(*psrc);
+        *pfield = epicsConvertDoubleToFloat(*psrc);
         return 0;
     }
-    pdst += offset;
-    while (nRequest--) {
-        *pdst++ = epicsConvertDoubleToFloat(*psrc++);
-        if (++offset == no_elements)
-            pdst = (epicsFloat32 *) paddr->pfield;
-    }
+    n = wrapSpan(nRequest, no_elements, offset);
+    for (i = 0; i < n; i++)
+        pdst[i] = epicsConvertDoubleToFloat(psrc[i]);
+    psrc += n;
+    for (i = 0; i < nRequest - n; i++)
+        pfield[i] = epicsConvertDoubleToFloat(psrc[i]);
     return 0;
 }
 
@@ -85,6 +85,51 @@ static long processTarget(dbCommon *psrc, dbCommon *pdst);
 
 #define linkChannel(plink) ((dbChannel *) (plink)->value.pv_link.pvt)
 
+/* True if the target is a plain scalar which the bound getCvt/putCvt
+ * routines can access directly, bypassing dbChannelGet()/dbPut().
+ * Callers must still check the field type against the conversion tables.
+ */
+static int isSimpleScalar(dbChannel *chan)
+{
+    return dbChannelFinalElements(chan) == 1
+        && dbChannelSpecial(chan) != SPC_DBADDR
+        && dbChannelSpecial(chan) != SPC_ATTRIBUTE
+        && ellCount(&chan->filters) == 0;
+}
+
+/* Identity and widening copies for the most common scalar pairs,
+ * inlined to avoid the indirect call through the conversion table.
+ * DBF_ and DBR_ codes share values, so this serves gets and puts.
+ * Returns 0 if the pair is not handled here.
+ */
+static EPICS_ALWAYS_INLINE
+int copyScalar(short toType, short fromType, const void *from, void *to)
+{
+    if (toType == DBR_DOUBLE) {
+        epicsFloat64 *pto = (epicsFloat64 *) to;
+
+        switch (fromType) {
+        case DBF_DOUBLE: *pto = *(const epicsFloat64 *) from; return 1;
+        case DBF_FLOAT:  *pto = *(const epicsFloat32 *) from; return 1;
+        case DBF_LONG:   *pto = *(const epicsInt32 *) from;   return 1;
+        case DBF_ULONG:  *pto = *(const epicsUInt32 *) from;  return 1;
+        case DBF_SHORT:  *pto = *(const epicsInt16 *) from;   return 1;
+        case DBF_USHORT: *pto = *(const epicsUInt16 *) from;  return 1;
+        case DBF_CHAR:   *pto = *(const epicsInt8 *) from;    return 1;
+        case DBF_UCHAR:  *pto = *(const epicsUInt8 *) from;   return 1;
+        }
+    }
+    else if (toType == DBR_LONG && fromType == DBF_LONG) {
+        *(epicsInt32 *) to = *(const epicsInt32 *) from;
+        return 1;
+    }
+    else if (toType == DBR_FLOAT && fromType == DBF_FLOAT) {
+        *(epicsFloat32 *) to = *(const epicsFloat32 *) from;
+        return 1;
+    }
+    return 0;
+}
+
 long dbDbInitLink(struct link *plink, short dbfType)
 {
     long status;
@@ -104,11 +149,10 @@ long dbDbInitLink(struct link *plink, short dbfType)
     plink->type = DB_LINK;
     plink->value.pv_link.pvt = chan;
     ellAdd(&precord->bklnk, &plink->value.pv_link.backlinknode);
-    /* merging into the same lockset is deferred to the caller.
-     * cf. initPVLinks()
+    /* merging into the same lockset is deferred until
+     * all links are initialized, cf. dbLockInitSets()
      */
     dbLockSetMerge(NULL, plink->precord, precord);
-    assert(plink->precord->lset->plockSet == precord->lset->plockSet);
     return 0;
 }
 
@@ -137,6 +181,8 @@ static void dbDbRemoveLink(struct dbLocker *locker, struct link *plink)
         plink->value.pv_link.getCvt = 0;
         plink->value.pv_link.pvlMask = 0;
         plink->value.pv_link.lastGetdbrType = 0;
+        plink->value.pv_link.putCvt = 0;
+        plink->value.pv_link.lastPutdbrType = 0;
         ellDelete(&precord->bklnk, &plink->value.pv_link.backlinknode);
         dbLockSetSplit(locker, plink->precord, precord);
     }
@@ -181,12 +227,13 @@ static long dbDbGetValue(struct link *plink, short dbrType, void *pbuffer,
     if (ppv_link->getCvt && ppv_link->lastGetdbrType == dbrType)
     {
         /* shortcut: scalar with known conversion, no filter */
-        status = ppv_link->getCvt(dbChannelField(chan), pbuffer, paddr);
+        if (copyScalar(dbrType, dbChannelFieldType(chan),
+                dbChannelField(chan), pbuffer))
+            status = 0;
+        else
+            status = ppv_link->getCvt(dbChannelField(chan), pbuffer, paddr);
     }
-    else if (dbChannelFinalElements(chan) == 1 && (!pnRequest || *pnRequest == 1)
-                && dbChannelSpecial(chan) != SPC_DBADDR
-                && dbChannelSpecial(chan) != SPC_ATTRIBUTE
-                && ellCount(&chan->filters) == 0)
+    else if ((!pnRequest || *pnRequest == 1) && isSimpleScalar(chan))
     {
         /* Simple scalar w/o filters, so *Final* type has no additional information.
          * Needed to correctly handle DBF_MENU fields, which become DBF_ENUM during
@@ -374,7 +421,45 @@ static long dbDbPutValue(struct link *plink, short dbrType,
     struct dbCommon *psrce = plink->precord;
     DBADDR *paddr = &chan->addr;
     dbCommon *pdest = dbChannelRecord(chan);
-    long status = dbPut(paddr, dbrType, pbuffer, nRequest);
+    long status;
+
+    if (ppv_link->putCvt && ppv_link->lastPutdbrType == dbrType
+            && nRequest == 1)
+    {
+        /* shortcut: scalar with no special processing, known conversion.
+         * Does what dbPut() would, without re-checking the target.
+         */
+        dbFldDes *pfldDes = paddr->pfldDes;
+        int isValueField = dbIsValueField(pfldDes);
+
+        if (copyScalar(dbChannelFieldType(chan), dbrType, pbuffer,
+                dbChannelField(chan)))
+            status = 0;
+        else
+            status = ppv_link->putCvt(pbuffer, dbChannelField(chan), paddr);
+
+        if (!status) {
+            if (isValueField)
+                pdest->udf = FALSE;
+            if (pdest->mlis.count &&
+                !(isValueField && pfldDes->process_passive))
+                db_post_events(pdest, dbChannelField(chan),
+                    DBE_VALUE | DBE_LOG);
+            if (pdest->mlis.count && pfldDes->prop)
+                db_post_events(pdest, NULL, DBE_PROPERTY);
+        }
+    }
+    else {
+        if (nRequest == 1 && dbChannelSpecial(chan) == 0
+                && dbrType >= 0 && dbrType <= DBR_ENUM
+                && dbChannelFieldType(chan) <= DBF_DEVICE
+                && isSimpleScalar(chan)) {
+            ppv_link->putCvt =
+                dbFastPutConvertRoutine[dbrType][dbChannelFieldType(chan)];
+            ppv_link->lastPutdbrType = dbrType;
+        }
+        status = dbPut(paddr, dbrType, pbuffer, nRequest);
+    }
 
     recGblInheritSevr(ppv_link->pvlMask & pvlOptMsMode, pdest, psrce->nsta,
         psrce->nsev);
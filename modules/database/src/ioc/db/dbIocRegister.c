@@ -347,6 +347,29 @@ static const iocshFuncDef dbLockShowLockedFuncDef =
 static void dbLockShowLockedCallFunc(const iocshArgBuf *args)
 { dbLockShowLocked(args[0].ival);}
 
+/* dbLockShowStats */
+static const iocshArg dbLockShowStatsArg0 = { "count",iocshArgInt};
+static const iocshArg dbLockShowStatsArg1 = { "sort by",iocshArgString};
+static const iocshArg dbLockShowStatsArg2 = { "interest level",iocshArgInt};
+static const iocshArg * const dbLockShowStatsArgs[3] =
+    {&dbLockShowStatsArg0,&dbLockShowStatsArg1,&dbLockShowStatsArg2};
+static const iocshFuncDef dbLockShowStatsFuncDef =
+    {"dbLockShowStats",3,dbLockShowStatsArgs,
+     "Show the Locksets with the most contention, collected while\n"
+     "the variable dbLockStats is non-zero.\n"
+     "  count - number of Locksets to show, default 10\n"
+     "  sort by - contended (default), acquire, wait or hold\n"
+     "  interest level - 1 adds wait and hold time histograms\n"};
+static void dbLockShowStatsCallFunc(const iocshArgBuf *args)
+{ dbLockShowStats(args[0].ival,args[1].sval,args[2].ival);}
+
+/* dbLockResetStats */
+static const iocshFuncDef dbLockResetStatsFuncDef =
+    {"dbLockResetStats",0,0,
+     "Clear the statistics shown by dbLockShowStats.\n"};
+static void dbLockResetStatsCallFunc(const iocshArgBuf *args)
+{ dbLockResetStats();}
+
 /* scanOnceSetQueueSize */
 static const iocshArg scanOnceSetQueueSizeArg0 = { "size",iocshArgInt};
 static const iocshArg * const scanOnceSetQueueSizeArgs[1] =
@@ -543,6 +566,8 @@ void dbIocRegister(void)
     iocshRegister(&tpnFuncDef,tpnCallFunc);
     iocshRegister(&dblsrFuncDef,dblsrCallFunc);
     iocshRegister(&dbLockShowLockedFuncDef,dbLockShowLockedCallFunc);
+    iocshRegister(&dbLockShowStatsFuncDef,dbLockShowStatsCallFunc);
+    iocshRegister(&dbLockResetStatsFuncDef,dbLockResetStatsCallFunc);
 
     iocshRegister(&scanOnceSetQueueSizeFuncDef,scanOnceSetQueueSizeCallFunc);
     iocshRegister(&scanOnceQueueShowFuncDef,scanOnceQueueShowCallFunc);
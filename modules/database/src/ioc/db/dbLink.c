@@ -229,6 +229,13 @@ int dbLinkIsVolatile(const struct link *plink)
     return plset && plset->isVolatile;
 }
 
+int dbLinkReadHasEffects(const struct link *plink)
+{
+    if (plink->type != DB_LINK && plink->type != CA_LINK)
+        return 1;
+    return (plink->value.pv_link.pvlMask & (pvlOptPP | pvlOptMsMode)) != 0;
+}
+
 long dbLoadLink(struct link *plink, short dbrType, void *pbuffer)
 {
     lset *plset = plink->lset;
@@ -401,6 +401,8 @@ DBCORE_API void dbRemoveLink(struct dbLocker *locker, struct link *plink);
 DBCORE_API int dbLinkIsDefined(const struct link *plink);  /* 0 or 1 */
 DBCORE_API int dbLinkIsConstant(const struct link *plink); /* 0 or 1 */
 DBCORE_API int dbLinkIsVolatile(const struct link *plink); /* 0 or 1 */
+/* Reading a PP or MS link can process or alarm a record */
+DBCORE_API int dbLinkReadHasEffects(const struct link *plink); /* 0 or 1 */
 
 DBCORE_API long dbLoadLink(struct link *plink, short dbrType,
         void *pbuffer);
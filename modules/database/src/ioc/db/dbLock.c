@@ -23,7 +23,9 @@
 #include "epicsSpin.h"
 #include "epicsStdio.h"
 #include "epicsThread.h"
+#include "epicsTime.h"
 #include "errMdef.h"
+#include "epicsExport.h"
 
 #include "dbAccessDefs.h"
 #include "dbAddr.h"
@@ -34,6 +36,7 @@
 #include "dbLockPvt.h"
 #include "dbStaticLib.h"
 #include "link.h"
+#include "special.h"
 
 typedef struct dbScanLockNode dbScanLockNode;
 
@@ -56,6 +59,15 @@ static epicsMutexId lockSetsGuard;
 static size_t recomputeCnt;
 #endif
 
+/* Non-zero between dbLockInitRecords() and dbLockInitSets() */
+static int lockSetsDeferred;
+
+int dbLockOptimisticRead = 0;
+epicsExportAddress(int, dbLockOptimisticRead);
+
+int dbLockStats = 0;
+epicsExportAddress(int, dbLockStats);
+
 /*private routines */
 static void dbLockOnce(void* ignore)
 {
@@ -90,6 +102,9 @@ static lockSet* makeSet(void)
         epicsMutexMustLock(lockSetsGuard);
     }
 #endif
+    if(ls->stats)
+        memset(ls->stats, 0, sizeof(*ls->stats));
+
     /* the initial reference for the first lockRecord */
     iref = epicsAtomicIncrIntT(&ls->refcount);
     ellAdd(&lockSetsActive, &ls->node);
@@ -102,6 +117,99 @@ static lockSet* makeSet(void)
     return ls;
 }
 
+static unsigned statBucket(epicsUInt64 ns)
+{
+    epicsUInt64 us = ns/1000u;
+    unsigned i = 0;
+    while(us && i<DBLOCK_NHIST-1) {
+        us >>= 1;
+        i++;
+    }
+    return i;
+}
+
+/* Lock and record contention.  Caller must check dbLockStats */
+static void lockSetLockStats(lockSet *ls)
+{
+    epicsUInt64 start = 0, now;
+    lockSetStats *stats;
+
+    if(epicsMutexTryLock(ls->lock)!=epicsMutexLockOK) {
+        start = epicsMonotonicGet();
+        epicsMutexMustLock(ls->lock);
+    }
+    now = epicsMonotonicGet();
+
+    stats = ls->stats;
+    if(!stats)
+        stats = ls->stats = calloc(1, sizeof(*stats));
+    if(!stats)
+        return;
+
+    if(start) {
+        epicsUInt64 wait = now-start;
+        stats->nContended++;
+        stats->waitTotal += wait;
+        if(wait>stats->waitMax)
+            stats->waitMax = wait;
+        stats->waitHist[statBucket(wait)]++;
+    }
+    if(ls->holdcount==0)
+        ls->holdStart = now;
+}
+
+/* Counted once the lockSet locked is known to be the record's,
+ * not for the attempts retried because it changed.
+ */
+static void lockSetCountAcquire(lockSet *ls)
+{
+    if(dbLockStats && ls->stats)
+        ls->stats->nAcquire++;
+}
+
+static void lockSetHoldDone(lockSet *ls)
+{
+    epicsUInt64 hold = epicsMonotonicGet()-ls->holdStart;
+    lockSetStats *stats = ls->stats;
+
+    ls->holdStart = 0;
+    stats->nHold++;
+    stats->holdTotal += hold;
+    if(hold>stats->holdMax)
+        stats->holdMax = hold;
+    stats->holdHist[statBucket(hold)]++;
+}
+
+/* When dbLockStats is zero the cost is the branch here,
+ * and the test of holdStart in lockSetReleasing().
+ */
+static void lockSetLock(lockSet *ls)
+{
+    if(!dbLockStats) {
+        epicsMutexMustLock(ls->lock);
+    } else {
+        lockSetLockStats(ls);
+    }
+}
+
+/* Called by the thread which has just locked ls->lock */
+static void lockSetAcquired(lockSet *ls)
+{
+    if(ls->holdcount++==0)
+        epicsAtomicIncrSizeT(&ls->seq);
+}
+
+/* Called by the thread which is about to unlock ls->lock */
+static void lockSetReleasing(lockSet *ls)
+{
+    assert(ls->holdcount>0);
+    if(--ls->holdcount==0) {
+        epicsAtomicIncrSizeT(&ls->seq);
+        if(ls->holdStart)
+            lockSetHoldDone(ls);
+    }
+}
+
 unsigned long dbLockGetRefs(struct dbCommon* prec)
 {
     return (unsigned long)epicsAtomicGetIntT(&prec->lset->plockSet->refcount);
@@ -156,6 +264,7 @@ void dbLockDecRef(lockSet *ls)
     ellAdd(&lockSetsFree, &ls->node);
 #else
     epicsMutexDestroy(ls->lock);
+    free(ls->stats);
     memset(ls, 0, sizeof(*ls)); /* paranoia */
     free(ls);
 #endif
@@ -193,7 +302,7 @@ void dbScanLock(dbCommon *precord)
     assert(epicsAtomicGetIntT(&ls->refcount)>0);
 
 retry:
-    epicsMutexMustLock(ls->lock);
+    lockSetLock(ls);
 
     epicsSpinLock(lr->spin);
     if(ls!=lr->plockSet) {
@@ -205,6 +314,8 @@ retry:
         assert(newcnt>=2); /* at least lockRecord and us */
         epicsSpinUnlock(lr->spin);
 
+        if(ls->holdcount==0)
+            ls->holdStart = 0;
         epicsMutexUnlock(ls->lock);
         dbLockDecRef(ls);
 
@@ -221,6 +332,9 @@ retry:
     cnt = epicsAtomicDecrIntT(&ls->refcount);
     assert(cnt>0);
 
+    lockSetCountAcquire(ls);
+    lockSetAcquired(ls);
+
 #ifdef LOCKSET_DEBUG
     if(ls->owner) {
         assert(ls->owner==epicsThreadGetIdSelf());
@@ -245,10 +359,71 @@ void dbScanUnlock(dbCommon *precord)
     if(ls->ownercount==0)
         ls->owner = NULL;
 #endif
+    lockSetReleasing(ls);
     epicsMutexUnlock(ls->lock);
     dbLockDecRef(ls);
 }
 
+int dbLockReadBegin(dbCommon *precord, dbLockReader *reader)
+{
+    lockRecord *lr = precord->lset;
+    lockSet *ls = dbLockGetRef(lr);
+    size_t seq = epicsAtomicGetSizeT(&ls->seq);
+    int moved;
+
+    if(seq&1) {
+        /* held now */
+        dbLockDecRef(ls);
+        return 0;
+    }
+    epicsAtomicReadMemoryBarrier();
+
+    /* The record may have been moved to another lockSet after
+     * dbLockGetRef(), with ls released again before seq was read.
+     */
+    epicsSpinLock(lr->spin);
+    moved = lr->plockSet!=ls;
+    epicsSpinUnlock(lr->spin);
+    if(moved) {
+        dbLockDecRef(ls);
+        return 0;
+    }
+
+    reader->plockSet = ls;
+    reader->seq = seq;
+    return 1;
+}
+
+/* dbLockReadBegin() found the record in this lockSet after reading seq.
+ * It can only be moved to another while this lockSet is held, which
+ * changes seq, so an unchanged seq also means that it was not moved.
+ */
+int dbLockReadEnd(dbLockReader *reader)
+{
+    lockSet *ls = reader->plockSet;
+    int ok;
+
+    epicsAtomicReadMemoryBarrier();
+    ok = epicsAtomicGetSizeT(&ls->seq)==reader->seq;
+
+    reader->plockSet = NULL;
+    dbLockDecRef(ls);
+    return ok;
+}
+
+int dbLockReadable(const struct dbAddr *paddr, short dbrType,
+                   long options, const void *pfl)
+{
+    /* Field logs may reference record storage, and the other options
+     * call into record support.  Strings may be copied unterminated.
+     */
+    return dbLockOptimisticRead && !pfl &&
+        paddr->no_elements==1 && paddr->special!=SPC_DBADDR &&
+        paddr->field_type>=DBF_CHAR && paddr->field_type<=DBF_ENUM &&
+        dbrType>=DBR_CHAR && dbrType<=DBR_ENUM &&
+        !(options & ~(DBR_STATUS|DBR_AMSG|DBR_TIME|DBR_UTAG));
+}
+
 static
 int lrrcompare(const void *rawA, const void *rawB)
 {
@@ -409,7 +584,8 @@ retry:
             continue;
         plock = ref->plockSet;
 
-        epicsMutexMustLock(plock->lock);
+        lockSetLock(plock);
+        lockSetAcquired(plock);
         assert(plock->ownerlocker==NULL);
         plock->ownerlocker = locker;
         ellAdd(&locker->locked, &plock->lockernode);
@@ -437,6 +613,11 @@ retry:
         dbScanUnlockMany(locker);
         goto retry;
     }
+    if(dbLockStats) {
+        ELLNODE *cur;
+        for(cur=ellFirst(&locker->locked); cur; cur=ellNext(cur))
+            lockSetCountAcquire(CONTAINER(cur, lockSet, lockernode));
+    }
     if(nlock!=0 && ellCount(&locker->locked)<=0) {
         /* if we have at least one lockRecord, then we will always lock
          * at least its present lockSet
@@ -465,6 +646,7 @@ void dbScanUnlockMany(dbLocker* locker)
             plock->owner = NULL;
 #endif
 
+        lockSetReleasing(plock);
         epicsMutexUnlock(plock->lock);
         /* release ref for locked list */
         dbLockDecRef(plock);
@@ -516,6 +698,8 @@ static int createLockRecord(void* junk, DBENTRY* pdbentry)
         cantProceed("no memory for spinlock in lockRecord");
 
     lrec->precord = prec;
+    lrec->ufparent = lrec;
+    lrec->ufsize = 1;
 
     prec->lset = lrec;
 
@@ -530,6 +714,70 @@ void dbLockInitRecords(dbBase *pdbbase)
 
     /* create all lockRecords and lockSets */
     forEachRecord(NULL, pdbbase, &createLockRecord);
+    lockSetsDeferred = 1;
+}
+
+/* Union-find over lockRecords, with union by size and path halving.
+ * Only used from the thread initializing the IOC.
+ */
+static lockRecord* ufFind(lockRecord *lr)
+{
+    while(lr->ufparent!=lr) {
+        lr->ufparent = lr->ufparent->ufparent;
+        lr = lr->ufparent;
+    }
+    return lr;
+}
+
+static void ufUnion(lockRecord *A, lockRecord *B)
+{
+    A = ufFind(A);
+    B = ufFind(B);
+    if(A==B)
+        return;
+    if(A->ufsize < B->ufsize) {
+        lockRecord *temp = A;
+        A = B;
+        B = temp;
+    }
+    B->ufparent = A;
+    A->ufsize += B->ufsize;
+}
+
+static int joinLockSet(void* junk, DBENTRY* pdbentry)
+{
+    lockRecord *lr = ((dbCommon*)pdbentry->precnode->precord)->lset;
+    lockRecord *root = ufFind(lr);
+    lockSet *A = root->plockSet, *B = lr->plockSet;
+
+    if(A!=B) {
+        /* No other thread can hold B yet, see dbLockSetMerge() */
+        ellDelete(&B->lockRecordList, &lr->node);
+        ellAdd(&A->lockRecordList, &lr->node);
+        dbLockIncRef(A);
+
+        epicsSpinLock(lr->spin);
+        lr->plockSet = A;
+#ifndef LOCKSET_NOCNT
+        epicsAtomicIncrSizeT(&recomputeCnt);
+#endif
+        epicsSpinUnlock(lr->spin);
+
+        dbLockDecRef(B);
+    }
+    return 0;
+}
+
+/* Build the lockSets from the merges recorded by dbLockSetMerge()
+ * while links were initialized.  Each record is visited once.
+ */
+void dbLockInitSets(dbBase *pdbbase)
+{
+    if(!lockSetsDeferred)
+        return;
+    /* roots keep their own lockSet, all others join it */
+    forEachRecord(NULL, pdbbase, &joinLockSet);
+    lockSetsDeferred = 0;
 }
 
 static int freeLockRecord(void* junk, DBENTRY* pdbentry)
@@ -559,6 +807,7 @@ void dbLockCleanupRecords(dbBase *pdbbase)
     epicsThreadOnce(&dbLockOnceInit, &dbLockOnce, NULL);
 
     forEachRecord(NULL, pdbbase, &freeLockRecord);
+    lockSetsDeferred = 0;
     if(ellCount(&lockSetsActive)) {
         printf("Warning: dbLockCleanupRecords() leaking lockSets\n");
         dblsr(NULL,2);
@@ -578,8 +827,10 @@ void dbLockCleanupRecords(dbBase *pdbbase)
 
 /* Called in two modes.
  * During dbLockInitRecords w/ locker==NULL, then no mutex are locked.
+ * Until dbLockInitSets() is called the merge is only recorded.
  * After dbLockInitRecords w/ locker!=NULL, then
  * the caller must lock both pfirst and psecond.
+ * The records of the smaller lockSet are moved into the larger.
  *
  * Assumes that pfirst has been modified
  * to link to psecond.
@@ -596,6 +847,11 @@ void dbLockSetMerge(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
 
     assert(A && B);
 
+    if(!locker && lockSetsDeferred) {
+        ufUnion(pfirst->lset, psecond->lset);
+        return;
+    }
+
 #ifdef LOCKSET_DEBUG
     if(locker && (A->owner!=myself || B->owner!=myself)) {
         cantProceed("dbLockSetMerge(%p,\"%s\",\"%s\") ownership violation %p %p (%p)\n",
@@ -612,6 +868,13 @@ void dbLockSetMerge(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
     if(A==B)
         return; /* already in the same lockSet */
 
+    if(ellCount(&B->lockRecordList) > ellCount(&A->lockRecordList)) {
+        /* both are locked, so either may be emptied */
+        lockSet *temp = A;
+        A = B;
+        B = temp;
+    }
+
     Nb = ellCount(&B->lockRecordList);
     assert(Nb>0);
 
@@ -657,6 +920,9 @@ void dbLockSetMerge(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
         B->ownerlocker = NULL;
         epicsAtomicDecrIntT(&B->refcount);
 
+        /* B is released fully, as with ownercount above */
+        B->holdcount = 1;
+        lockSetReleasing(B);
         epicsMutexUnlock(B->lock);
     }
 
@@ -665,6 +931,66 @@ void dbLockSetMerge(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
     assert(A==psecond->lset->plockSet);
 }
 
+/* Mark a record reached by the search from one side of a split.
+ * Returns non-zero if it was already reached from the other side,
+ * in which case both records remain connected.
+ */
+static int splitMark(lockRecord *lr, unsigned int side, ELLLIST *toInspect)
+{
+    if(lr->compflag==side)
+        return 0;
+    if(lr->compflag)
+        return 1;
+    lr->compflag = side;
+    ellAdd(toInspect, &lr->compnode);
+    return 0;
+}
+
+/* Visit the next record on one side of the search */
+static int splitStep(unsigned int side, ELLLIST *toInspect, ELLLIST *visited)
+{
+    ELLNODE *cur = ellGet(toInspect);
+    lockRecord *lr = CONTAINER(cur,lockRecord,compnode);
+    dbCommon *prec = lr->precord;
+    dbRecordType *rtype = prec->rdes;
+    size_t i;
+    ELLNODE *bcur;
+
+    ellAdd(visited, cur);
+
+    /* Visit all the links originating from prec */
+    for(i=0; i<rtype->no_links; i++) {
+        dbFldDes *pdesc = rtype->papFldDes[rtype->link_ind[i]];
+        DBLINK *plink = (DBLINK*)((char*)prec + pdesc->offset);
+        dbChannel *chan;
+        lockRecord *lr;
+
+        if(plink->type!=DB_LINK)
+            continue;
+
+        chan = plink->value.pv_link.pvt;
+        lr = dbChannelRecord(chan)->lset;
+        assert(lr);
+
+        if(splitMark(lr, side, toInspect))
+            return 1;
+    }
+
+    /* Visit all links terminating at prec */
+    for(bcur=ellFirst(&prec->bklnk); bcur; bcur=ellNext(bcur))
+    {
+        struct pv_link *plink1 = CONTAINER(bcur, struct pv_link, backlinknode);
+        union value *plink2 = CONTAINER(plink1, union value, pv_link);
+        DBLINK *plink = CONTAINER(plink2, DBLINK, value);
+
+        /* plink->type==DB_LINK is implied.  Only DB_LINKs are tracked from BKLNK */
+
+        if(splitMark(plink->precord->lset, side, toInspect))
+            return 1;
+    }
+    return 0;
+}
+
 /* recompute assuming a link from pfirst to psecond
  * may have been removed.
  * pfirst and psecond must currently be in the same lockset,
@@ -675,7 +1001,8 @@ void dbLockSetMerge(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
 void dbLockSetSplit(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
 {
     lockSet *ls = pfirst->lset->plockSet;
-    ELLLIST toInspect, newLS;
+    ELLLIST toInspect[2], visited[2];
+    unsigned int side;
 #ifdef LOCKSET_DEBUG
     const epicsThreadId myself = epicsThreadGetIdSelf();
 #endif
@@ -704,98 +1031,49 @@ void dbLockSetSplit(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
      */
     assert(epicsAtomicGetIntT(&ls->refcount)>=ellCount(&ls->lockRecordList)+1);
 
-    ellInit(&toInspect);
-    ellInit(&newLS);
+    for(side=0; side<2; side++) {
+        ellInit(&toInspect[side]);
+        ellInit(&visited[side]);
+    }
 
-    /* strategy is to start with psecond and do
-     * a breadth first traversal until all records are
-     * visited.  If we encounter pfirst, then there
-     * is no need to create a new lockset so we abort
-     * early.
+    /* strategy is to do a breadth first traversal from
+     * both psecond and pfirst, one record at a time from each.
+     * If the two searches meet, then there is no need to create
+     * a new lockset so we abort early.  Otherwise the side which
+     * runs out of records first has found the smaller component,
+     * which is moved into a new lockset.  psecond goes first,
+     * so it is moved when both components are the same size.
      */
-    ellAdd(&toInspect, &psecond->lset->compnode);
-    psecond->lset->compflag = 1;
+    splitMark(psecond->lset, 1, &toInspect[0]);
+    splitMark(pfirst->lset, 2, &toInspect[1]);
+
+    for(side=0; ; side=!side) {
+        if(ellCount(&toInspect[side])==0)
+            break;
+        if(splitStep(side+1, &toInspect[side], &visited[side]))
+            goto nosplit;
+    }
 
     {
         lockSet *splitset;
+        ELLLIST *newLS = &visited[side];
         ELLNODE *cur;
-        while((cur=ellGet(&toInspect))!=NULL)
-        {
-            lockRecord *lr=CONTAINER(cur,lockRecord,compnode);
-            dbCommon *prec=lr->precord;
-            dbRecordType *rtype = prec->rdes;
-            size_t i;
-            ELLNODE *bcur;
-
-            ellAdd(&newLS, cur);
-            prec->lset->compflag = 2;
-
-            /* Visit all the links originating from prec */
-            for(i=0; i<rtype->no_links; i++) {
-                dbFldDes *pdesc = rtype->papFldDes[rtype->link_ind[i]];
-                DBLINK *plink = (DBLINK*)((char*)prec + pdesc->offset);
-                dbChannel *chan;
-                lockRecord *lr;
-
-                if(plink->type!=DB_LINK)
-                    continue;
-
-                chan = plink->value.pv_link.pvt;
-                lr = dbChannelRecord(chan)->lset;
-                assert(lr);
-
-                if(lr->precord==pfirst) {
-                    /* so pfirst is still reachable from psecond,
-                     * no new lock set should be created.
-                     */
-                    goto nosplit;
-                }
-
-                /* have we already visited this record? */
-                if(lr->compflag)
-                    continue;
-
-                ellAdd(&toInspect, &lr->compnode);
-                lr->compflag = 1;
-            }
 
-            /* Visit all links terminating at prec */
-            for(bcur=ellFirst(&prec->bklnk); bcur; bcur=ellNext(bcur))
-            {
-                struct pv_link *plink1 = CONTAINER(bcur, struct pv_link, backlinknode);
-                union value *plink2 = CONTAINER(plink1, union value, pv_link);
-                DBLINK *plink = CONTAINER(plink2, DBLINK, value);
-                lockRecord *lr = plink->precord->lset;
-
-                /* plink->type==DB_LINK is implied.  Only DB_LINKs are tracked from BKLNK */
-
-                if(lr->precord==pfirst) {
-                    goto nosplit;
-                }
-
-                if(lr->compflag)
-                    continue;
-
-                ellAdd(&toInspect, &lr->compnode);
-                lr->compflag = 1;
-            }
-        }
-        /* All links involving psecond were traversed without finding
-         * pfirst.  So we must create a new lockset.
+        /* All links involving one side were traversed without reaching
+         * the other.  So we must create a new lockset.
          * newLS contains the nodes which will
          * make up this new lockset.
          */
-        /* newLS will have at least psecond in it */
-        assert(ellCount(&newLS) > 0);
-        /* If we didn't find pfirst, then it must be in the
-         * original lockset, and not the new one
-         */
-        assert(ellCount(&newLS) < ellCount(&ls->lockRecordList));
-        assert(ellCount(&newLS) < ls->refcount);
+        /* newLS will have at least psecond or pfirst in it */
+        assert(ellCount(newLS) > 0);
+        /* the other side holds at least one record */
+        assert(ellCount(newLS) < ellCount(&ls->lockRecordList));
+        assert(ellCount(newLS) < ls->refcount);
 
         splitset = makeSet(); /* reference for locker->locked */
 
         epicsMutexMustLock(splitset->lock);
+        lockSetAcquired(splitset);
 
         assert(splitset->ownerlocker==NULL);
         ellAdd(&locker->locked, &splitset->lockernode);
@@ -809,7 +1087,7 @@ void dbLockSetSplit(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
         assert(ls->ownercount==1);
 #endif
 
-        while((cur=ellGet(&newLS))!=NULL)
+        while((cur=ellGet(newLS))!=NULL)
         {
             lockRecord *lr=CONTAINER(cur,lockRecord,compnode);
 
@@ -830,6 +1108,13 @@ void dbLockSetSplit(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
              */
         }
 
+        /* reset compflag for the partial search of the other side */
+        side = !side;
+        while((cur=ellGet(&toInspect[side]))!=NULL)
+            CONTAINER(cur,lockRecord,compnode)->compflag = 0;
+        while((cur=ellGet(&visited[side]))!=NULL)
+            CONTAINER(cur,lockRecord,compnode)->compflag = 0;
+
         /* refcount of ls can't go to zero as the locker
          * holds at least one reference (its locked list)
          */
@@ -839,9 +1124,9 @@ void dbLockSetSplit(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
 
         assert(splitset->refcount>=ellCount(&splitset->lockRecordList)+1);
 
-        assert(psecond->lset->plockSet==splitset);
+        assert(pfirst->lset->plockSet!=psecond->lset->plockSet);
 
-        /* must have refs from pfirst lockRecord,
+        /* must have refs from the remaining lockRecords,
          * and the locked list.
          */
         assert(epicsAtomicGetIntT(&ls->refcount)>=2);
@@ -855,15 +1140,11 @@ nosplit:
          * during the aborted search
          */
         ELLNODE *cur;
-        while((cur=ellGet(&toInspect))!=NULL)
-        {
-            lockRecord *lr=CONTAINER(cur,lockRecord,compnode);
-            lr->compflag = 0;
-        }
-        while((cur=ellGet(&newLS))!=NULL)
-        {
-            lockRecord *lr=CONTAINER(cur,lockRecord,compnode);
-            lr->compflag = 0;
+        for(side=0; side<2; side++) {
+            while((cur=ellGet(&toInspect[side]))!=NULL)
+                CONTAINER(cur,lockRecord,compnode)->compflag = 0;
+            while((cur=ellGet(&visited[side]))!=NULL)
+                CONTAINER(cur,lockRecord,compnode)->compflag = 0;
         }
         return;
     }
@@ -972,6 +1253,143 @@ long dbLockShowLocked(int level)
     return 0;
 }
 
+typedef struct {
+    unsigned long id;
+    int nrecords;
+    const char *name; /* of the first record */
+    epicsUInt64 key;
+    lockSetStats stats;
+} lockSetStatsCopy;
+
+static int statsCompare(const void *rawA, const void *rawB)
+{
+    const lockSetStatsCopy *A = rawA, *B = rawB;
+    if(A->key > B->key) return -1;
+    if(A->key < B->key) return 1;
+    return 0;
+}
+
+static void showHist(const char *title, const epicsUInt32 *hist)
+{
+    unsigned i;
+    printf("    %s:", title);
+    for(i=0; i<DBLOCK_NHIST; i++)
+        printf(" %u", (unsigned)hist[i]);
+    printf("\n");
+}
+
+long dbLockShowStats(int count, const char *sort, int level)
+{
+    lockSetStatsCopy *copies;
+    lockSet *plockSet;
+    int ncopies = 0, nsets, i;
+    int key = 0;
+
+    if(!sort || !*sort || !strcmp(sort, "contended"))
+        key = 0;
+    else if(!strcmp(sort, "acquire"))
+        key = 1;
+    else if(!strcmp(sort, "wait"))
+        key = 2;
+    else if(!strcmp(sort, "hold"))
+        key = 3;
+    else {
+        printf("Unknown sort key '%s', expected contended, acquire, wait or hold\n", sort);
+        return -1;
+    }
+    if(count<=0)
+        count = 10;
+
+    if(!dbLockStats)
+        printf("Lockset statistics are disabled, set dbLockStats=1 to collect\n");
+
+    epicsThreadOnce(&dbLockOnceInit, &dbLockOnce, NULL);
+    epicsMutexMustLock(lockSetsGuard);
+
+    nsets = ellCount(&lockSetsActive);
+    copies = nsets ? calloc(nsets, sizeof(*copies)) : NULL;
+    if(nsets && !copies) {
+        epicsMutexUnlock(lockSetsGuard);
+        printf("Out of memory\n");
+        return -1;
+    }
+
+    /* The counters are copied without locking each lockSet,
+     * so may be slightly inconsistent.
+     */
+    for(plockSet = (lockSet *)ellFirst(&lockSetsActive); plockSet;
+        plockSet = (lockSet *)ellNext(&plockSet->node))
+    {
+        lockSetStatsCopy *copy = &copies[ncopies];
+        lockRecord *plr;
+
+        if(!plockSet->stats || !plockSet->stats->nAcquire)
+            continue;
+        copy->stats = *plockSet->stats;
+        copy->id = plockSet->id;
+        copy->nrecords = ellCount(&plockSet->lockRecordList);
+        plr = (lockRecord *)ellFirst(&plockSet->lockRecordList);
+        copy->name = plr ? plr->precord->name : "";
+        switch(key) {
+        case 0: copy->key = copy->stats.nContended; break;
+        case 1: copy->key = copy->stats.nAcquire; break;
+        case 2: copy->key = copy->stats.waitTotal; break;
+        default: copy->key = copy->stats.holdTotal; break;
+        }
+        ncopies++;
+    }
+    epicsMutexUnlock(lockSetsGuard);
+
+    qsort(copies, ncopies, sizeof(*copies), statsCompare);
+
+    printf("%d of %d lockSets used, top %d by %s\n", ncopies, nsets,
+           count<ncopies ? count : ncopies, sort && *sort ? sort : "contended");
+    if(ncopies)
+        printf("%8s %7s %12s %12s %10s %10s %10s %10s  %s\n", "Id", "Records",
+               "Acquired", "Contended", "AvgWait", "MaxWait",
+               "AvgHold", "MaxHold", "First record");
+    for(i=0; i<ncopies && i<count; i++) {
+        const lockSetStats *st = &copies[i].stats;
+        double avgWait = st->nContended ? st->waitTotal*1e-3/st->nContended : 0.0;
+        double avgHold = st->nHold ? st->holdTotal*1e-3/st->nHold : 0.0;
+
+        printf("%8lu %7d %12llu %12llu %8.1fus %8.1fus %8.1fus %8.1fus  %s\n",
+               copies[i].id, copies[i].nrecords,
+               (unsigned long long)st->nAcquire,
+               (unsigned long long)st->nContended,
+               avgWait, st->waitMax*1e-3, avgHold, st->holdMax*1e-3,
+               copies[i].name);
+        if(level>0) {
+            showHist("wait", st->waitHist);
+            showHist("hold", st->holdHist);
+        }
+    }
+    if(level>0 && ncopies)
+        printf("Histogram buckets: <1us, then [2^(i-1), 2^i) us, last >= %uus\n",
+               1u<<(DBLOCK_NHIST-2));
+
+    free(copies);
+    return 0;
+}
+
+void dbLockResetStats(void)
+{
+    lockSet *plockSet;
+
+    epicsThreadOnce(&dbLockOnceInit, &dbLockOnce, NULL);
+    epicsMutexMustLock(lockSetsGuard);
+    /* lockSet locks may not be taken while holding lockSetsGuard.
+     * A concurrent update may survive the reset, which is harmless.
+     */
+    for(plockSet = (lockSet *)ellFirst(&lockSetsActive); plockSet;
+        plockSet = (lockSet *)ellNext(&plockSet->node))
+    {
+        if(plockSet->stats)
+            memset(plockSet->stats, 0, sizeof(*plockSet->stats));
+    }
+    epicsMutexUnlock(lockSetsGuard);
+}
+
 int * dbLockSetAddrTrace(dbCommon *precord)
 {
     lockRecord  *plockRecord = precord->lset;
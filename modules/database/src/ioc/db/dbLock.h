@@ -26,6 +26,17 @@ struct dbCommon;
 struct dbBase;
 typedef struct dbLocker dbLocker;
 
+/* When non-zero, dbGetField() and friends read scalar numeric fields
+ * without locking, retrying under dbScanLock() if the lockSet was held
+ * during the read.
+ */
+DBCORE_API extern int dbLockOptimisticRead;
+
+/* When non-zero, count lockSet acquisitions and measure wait and hold
+ * times.  See dbLockShowStats().
+ */
+DBCORE_API extern int dbLockStats;
+
 DBCORE_API void dbScanLock(struct dbCommon *precord);
 DBCORE_API void dbScanUnlock(struct dbCommon *precord);
 
@@ -42,6 +53,7 @@ DBCORE_API unsigned long dbLockGetLockId(
     struct dbCommon *precord);
 
 DBCORE_API void dbLockInitRecords(struct dbBase *pdbbase);
+DBCORE_API void dbLockInitSets(struct dbBase *pdbbase);
 DBCORE_API void dbLockCleanupRecords(struct dbBase *pdbbase);
 
 
@@ -51,6 +63,12 @@ DBCORE_API long dblsr(char *recordname,int level);
 /* level = (0,1,2) (lock set state, + recordname, +DB links) */
 
 DBCORE_API long dbLockShowLocked(int level);
+/* Report the <count> lockSets with the largest statistic named by sort:
+ * "contended" (default), "acquire", "wait" or "hold".
+ * level>0 adds histograms of wait and hold times.
+ */
+DBCORE_API long dbLockShowStats(int count, const char *sort, int level);
+DBCORE_API void dbLockResetStats(void);
 
 /*KLUDGE to support field TPRO*/
 DBCORE_API int * dbLockSetAddrTrace(struct dbCommon *precord);
@@ -11,6 +11,7 @@
 
 #include "dbLock.h"
 #include "epicsSpin.h"
+#include "epicsTypes.h"
 
 /* Define to enable additional error checking */
 #undef LOCKSET_DEBUG
@@ -21,6 +22,22 @@
 /* Define to disable use of recomputeCnt optimization */
 #undef LOCKSET_NOCNT
 
+/* Histogram buckets of lockSetStats.  Bucket 0 counts times below 1us,
+ * bucket i>0 times in [2^(i-1), 2^i) us, and the last bucket all longer.
+ */
+#define DBLOCK_NHIST 16
+
+/* Collected while dbLockStats is set.  Guarded by the lockSet lock. */
+typedef struct {
+    epicsUInt64 nAcquire;   /* by dbScanLock() or dbScanLockMany() */
+    epicsUInt64 nContended; /* which had to wait */
+    epicsUInt64 nHold;      /* outermost holds which were timed */
+    epicsUInt64 waitTotal, waitMax; /* ns */
+    epicsUInt64 holdTotal, holdMax; /* ns */
+    epicsUInt32 waitHist[DBLOCK_NHIST];
+    epicsUInt32 holdHist[DBLOCK_NHIST];
+} lockSetStats;
+
 /* except for refcount (and lock), all members of dbLockSet
  * are guarded by its lock.
  */
@@ -38,6 +55,16 @@ typedef struct dbLockSet {
     dbLocker           *ownerlocker;
     ELLNODE             lockernode;
 
+    /* Incremented when the lock is first taken and again when it
+     * is finally released, so odd while held.  Read without the lock
+     * by optimistic readers, see dbLockReadBegin().
+     */
+    size_t              seq;
+    unsigned int        holdcount; /* recursion depth of the holder */
+
+    lockSetStats       *stats; /* allocated when first needed */
+    epicsUInt64         holdStart; /* non-zero if this hold is timed */
+
     int                 trace; /*For field TPRO*/
 } lockSet;
 
@@ -65,6 +92,12 @@ typedef struct lockRecord {
      */
     ELLNODE     compnode;
     unsigned int compflag;
+
+    /* union-find forest used while links are initialized,
+     * between dbLockInitRecords() and dbLockInitSets().
+     */
+    struct lockRecord *ufparent;
+    size_t      ufsize;
 } lockRecord;
 
 typedef struct {
@@ -96,6 +129,34 @@ DBCORE_API lockSet* dbLockGetRef(lockRecord *lr); /* lookup lockset and incremen
 DBCORE_API void dbLockIncRef(lockSet* ls);
 DBCORE_API void dbLockDecRef(lockSet *ls);
 
+/* Optimistic (seqlock) read of a record without taking its lockSet.
+ * A reader calls dbLockReadBegin(), copies the fields it needs, then
+ * calls dbLockReadEnd().  If either returns zero the lockSet was held
+ * by another thread at some point, and the copy must be discarded
+ * and repeated under dbScanLock().
+ * Only suitable for reads which can't fault on inconsistent data,
+ * see dbLockReadable().
+ */
+typedef struct {
+    lockSet *plockSet;
+    size_t seq;
+} dbLockReader;
+
+DBCORE_API int dbLockReadBegin(struct dbCommon *precord, dbLockReader *reader);
+DBCORE_API int dbLockReadEnd(dbLockReader *reader);
+
+struct dbAddr;
+/* Non-zero if dbGet() of this field may use an optimistic read */
+DBCORE_API int dbLockReadable(const struct dbAddr *paddr, short dbrType,
+                              long options, const void *pfl);
+
+/* Sets of records joined by DB links are normally merged by
+ * dbLockSetMerge() as each link is made.  During IOC initialization
+ * merges with locker==NULL are only recorded in a union-find forest,
+ * and dbLockInitSets() then moves every record into the lockSet of
+ * its root in a single pass.
+ */
+
 /* Calling dbLockerPrepare directly is an internal
  * optimization used when dbLocker on the stack.
  * nrecs must be <=DBLOCKER_NALLOC.
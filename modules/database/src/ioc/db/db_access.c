@@ -40,6 +40,7 @@
 #include "dbCommon.h"
 #include "dbEvent.h"
 #include "dbLock.h"
+#include "dbLockPvt.h"
 #include "dbNotify.h"
 #include "dbStaticLib.h"
 #include "recSup.h"
@@ -137,6 +138,10 @@ int dbChannel_get(struct dbChannel *chan,
     return result;
 }
 
+static long getCountLocked(
+    struct dbChannel *chan, int buffer_type,
+    void *pbuffer, long *nRequest, void *pfl);
+
 /* Performs the work of the public db_get_field API, but also returns the number
  * of elements actually copied to the buffer.  The caller is responsible for
  * zeroing the remaining part of the buffer. */
@@ -145,6 +150,39 @@ int dbChannel_get_count(
     void *pbuffer, long *nRequest, void *pfl)
 {
     long status;
+
+    /* The plain, STS and TIME types of numeric values only need
+     * options which dbLockReadable() accepts, checked here using
+     * a representative numeric request type.
+     */
+    if (buffer_type >= 0 && buffer_type < oldDBR_GR_STRING &&
+        buffer_type % oldDBR_STS_STRING != oldDBR_STRING &&
+        dbLockReadable(&chan->addr, DBR_DOUBLE, DBR_STATUS | DBR_TIME, pfl)) {
+        dbLockReader reader;
+        long saveRequest = *nRequest;
+
+        if (dbLockReadBegin(dbChannelRecord(chan), &reader)) {
+            status = getCountLocked(chan, buffer_type, pbuffer, nRequest, pfl);
+            if (dbLockReadEnd(&reader))
+                return status ? -1 : 0;
+            *nRequest = saveRequest;
+        }
+    }
+
+    dbScanLock(dbChannelRecord(chan));
+    status = getCountLocked(chan, buffer_type, pbuffer, nRequest, pfl);
+    dbScanUnlock(dbChannelRecord(chan));
+
+    if (status) return -1;
+    return 0;
+}
+
+/* Caller must lock the record, or be an optimistic reader */
+static long getCountLocked(
+    struct dbChannel *chan, int buffer_type,
+    void *pbuffer, long *nRequest, void *pfl)
+{
+    long status;
     long options;
     long i;
     long zero = 0;
@@ -154,8 +192,6 @@ int dbChannel_get_count(
     * in the dbAccess.c dbGet() and getOptions() routines.
     */
 
-    dbScanLock(dbChannelRecord(chan));
-
     switch(buffer_type) {
     case(oldDBR_STRING):
         status = dbChannelGet(chan, DBR_STRING, pbuffer, &zero, nRequest, pfl);
@@ -798,10 +834,7 @@ int dbChannel_get_count(
         break;
     }
 
-    dbScanUnlock(dbChannelRecord(chan));
-
-    if (status) return -1;
-    return 0;
+    return status;
 }
 
 int dbChannel_put(struct dbChannel *chan, int src_type,
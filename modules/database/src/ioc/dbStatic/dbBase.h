@@ -163,6 +163,7 @@ typedef struct dbRecordType {
     /*The following are only available on run time system*/
     rset            *prset;
     int             rec_size;       /*record size in bytes          */
+    int             initThreadSafe; /*init_record may run in parallel*/
 }dbRecordType;
 
 struct dbPvd;           /* Contents private to dbPvdLib code */
@@ -87,6 +87,8 @@ struct pv_link {
     LINKCVT     getCvt;         /* input conversion function */
     short       pvlMask;        /* Options mask */
     short       lastGetdbrType; /* last dbrType for DB or CA get */
+    short       lastPutdbrType; /* last dbrType for DB put */
+    LINKCVT     putCvt;         /* output conversion function */
 };
 
 struct jlink;
@@ -31,6 +31,8 @@
 #include "epicsPrint.h"
 #include "epicsSignal.h"
 #include "epicsThread.h"
+#include "epicsThreadPool.h"
+#include "epicsTime.h"
 #include "errMdef.h"
 #include "iocsh.h"
 #include "taskwd.h"
@@ -94,10 +96,68 @@ static void exitDatabase(void *dummy);
 typedef void (*recIterFunc)(dbRecordType *rtyp, dbCommon *prec, void *user);
 
 static void iterateRecords(recIterFunc func, void *user);
+static void iterateRecordsParallel(recIterFunc func, void *user);
 
 int dbThreadRealtimeLock = 1;
 epicsExportAddress(int, dbThreadRealtimeLock);
 
+/* Worker threads used for the init_record() passes of record types
+ * marked with iocInitThreadSafe(); 0 or 1 initializes serially.
+ */
+int iocInitThreads = 0;
+epicsExportAddress(int, iocInitThreads);
+
+/* Print the time spent in each phase of iocBuild */
+int iocInitReportTimes = 0;
+epicsExportAddress(int, iocInitReportTimes);
+
+/*
+ * Per-phase timing of iocBuild
+ */
+#define MAX_INIT_PHASES 24
+
+static struct {
+    const char *name;
+    double seconds;
+} initPhase[MAX_INIT_PHASES];
+static int nInitPhases;
+static epicsUInt64 initPhaseStart;
+
+static void initPhaseBegin(void)
+{
+    nInitPhases = 0;
+    initPhaseStart = epicsMonotonicGet();
+}
+
+static void initPhaseDone(const char *name)
+{
+    epicsUInt64 now = epicsMonotonicGet();
+
+    if (nInitPhases < MAX_INIT_PHASES) {
+        initPhase[nInitPhases].name = name;
+        initPhase[nInitPhases].seconds = (now - initPhaseStart) * 1e-9;
+        nInitPhases++;
+    }
+    initPhaseStart = now;
+}
+
+static void initPhaseReport(void)
+{
+    double total = 0.0;
+    int i;
+
+    if (!iocInitReportTimes)
+        return;
+    errlogPrintf("iocBuild phase times (%d init threads):\n",
+        iocInitThreads > 1 ? iocInitThreads : 1);
+    for (i = 0; i < nInitPhases; i++) {
+        errlogPrintf("  %-24s %10.6f sec\n", initPhase[i].name,
+            initPhase[i].seconds);
+        total += initPhase[i].seconds;
+    }
+    errlogPrintf("  %-24s %10.6f sec\n", "total", total);
+}
+
 enum iocStateEnum getIocState(void)
 {
     return iocState;
@@ -118,6 +178,7 @@ static int iocBuild_1(void)
         return -1;
     }
     errlogInit(0);
+    initPhaseBegin();
     initHookAnnounce(initHookAtIocBuild);
 
     if (!epicsThreadIsOkToBlock()) {
@@ -139,6 +200,7 @@ static int iocBuild_1(void)
     taskwdInit();
     callbackInit();
     initHookAnnounce(initHookAfterCallbackInit);
+    initPhaseDone("callbackInit");
 
     return 0;
 }
@@ -151,25 +213,33 @@ static void prepareLinks(dbRecordType *rtyp, dbCommon *prec, void *junk)
 static int iocBuild_2(void)
 {
     initHookAnnounce(initHookAfterCaLinkInit);
+    initPhaseDone("dbCaLinkInit");
 
     initDrvSup();
     initHookAnnounce(initHookAfterInitDrvSup);
+    initPhaseDone("initDrvSup");
 
     initRecSup();
     initHookAnnounce(initHookAfterInitRecSup);
+    initPhaseDone("initRecSup");
 
     initDevSup();
     initHookAnnounce(initHookAfterInitDevSup); /* used by autosave pass 0 */
+    initPhaseDone("initDevSup");
 
     iterateRecords(prepareLinks, NULL);
+    initPhaseDone("prepareLinks");
 
     dbLockInitRecords(pdbbase);
+    initPhaseDone("dbLockInitRecords");
     initDatabase();
     dbBkptInit();
     initHookAnnounce(initHookAfterInitDatabase); /* used by autosave pass 1 */
+    initPhaseDone("dbBkptInit");
 
     finishDevSup();
     initHookAnnounce(initHookAfterFinishDevSup);
+    initPhaseDone("finishDevSup");
 
     scanInit();
     if (asInit()) {
@@ -179,18 +249,22 @@ static int iocBuild_2(void)
     dbProcessNotifyInit();
     epicsThreadSleep(.5);
     initHookAnnounce(initHookAfterScanInit);
+    initPhaseDone("scanInit");
 
     initialProcess();
     initHookAnnounce(initHookAfterInitialProcess);
+    initPhaseDone("initialProcess");
     return 0;
 }
 
 static int iocBuild_3(void)
 {
     initHookAnnounce(initHookAfterCaServerInit);
+    initPhaseDone("dbInitServers");
 
     iocState = iocBuilt;
     initHookAnnounce(initHookAfterIocBuilt);
+    initPhaseReport();
     return 0;
 }
 
@@ -491,6 +565,143 @@ static void iterateRecords(recIterFunc func, void *user)
     }
     return;
 }
+
+/*
+ * Mark a record type as having init_record() routines (including those of
+ * its device support) that may run concurrently with any other record's.
+ */
+int iocInitThreadSafe(const char *recordTypeName)
+{
+    DBENTRY dbentry;
+    long status;
+
+    if (!pdbbase) {
+        errlogPrintf("iocInitThreadSafe: No database definitions loaded\n");
+        return -1;
+    }
+    if (!recordTypeName) {
+        errlogPrintf("iocInitThreadSafe: Missing record type name\n");
+        return -1;
+    }
+    dbInitEntry(pdbbase, &dbentry);
+    status = dbFindRecordType(&dbentry, recordTypeName);
+    if (!status)
+        dbentry.precordType->initThreadSafe = 1;
+    else
+        errlogPrintf("iocInitThreadSafe: Record type '%s' not found\n",
+            recordTypeName);
+    dbFinishEntry(&dbentry);
+    return status ? -1 : 0;
+}
+
+/*
+ * Parallel record iteration: records of types marked with
+ * iocInitThreadSafe() are handed to a thread pool in chunks, while the
+ * calling thread walks all other record types itself.
+ * Returns after every record has been visited.
+ */
+#define INIT_CHUNK_RECORDS 500
+
+typedef struct initChunk {
+    ELLNODE node;
+    epicsJob *job;
+    recIterFunc func;
+    void *user;
+    dbRecordType *pdbRecordType;
+    dbRecordNode *pfirst;
+    int count;
+} initChunk;
+
+static void iterateChunk(dbRecordType *pdbRecordType,
+    dbRecordNode *pdbRecordNode, int count, recIterFunc func, void *user)
+{
+    for (; pdbRecordNode && count--;
+         pdbRecordNode = (dbRecordNode *)ellNext(&pdbRecordNode->node)) {
+        dbCommon *precord = pdbRecordNode->precord;
+
+        if (!precord->name[0] ||
+            pdbRecordNode->flags & DBRN_FLAGS_ISALIAS)
+            continue;
+
+        func(pdbRecordType, precord, user);
+    }
+}
+
+static void initChunkJob(void *arg, epicsJobMode mode)
+{
+    initChunk *pchunk = (initChunk *)arg;
+
+    if (mode != epicsJobModeRun)
+        return;
+    iterateChunk(pchunk->pdbRecordType, pchunk->pfirst, pchunk->count,
+        pchunk->func, pchunk->user);
+}
+
+static void iterateRecordsParallel(recIterFunc func, void *user)
+{
+    epicsThreadPoolConfig conf;
+    epicsThreadPool *pool;
+    ELLLIST chunks = ELLLIST_INIT;
+    dbRecordType *pdbRecordType;
+    initChunk *pchunk;
+
+    if (iocInitThreads <= 1) {
+        iterateRecords(func, user);
+        return;
+    }
+
+    epicsThreadPoolConfigDefaults(&conf);
+    conf.initialThreads = conf.maxThreads = iocInitThreads;
+    pool = epicsThreadPoolCreate(&conf);
+    if (!pool) {
+        errlogPrintf("iocInit: Can't create thread pool, "
+            "initializing records serially\n");
+        iterateRecords(func, user);
+        return;
+    }
+
+    for (pdbRecordType = (dbRecordType *)ellFirst(&pdbbase->recordTypeList);
+         pdbRecordType;
+         pdbRecordType = (dbRecordType *)ellNext(&pdbRecordType->node)) {
+        dbRecordNode *pdbRecordNode =
+            (dbRecordNode *)ellFirst(&pdbRecordType->recList);
+
+        if (!pdbRecordType->initThreadSafe) {
+            iterateChunk(pdbRecordType, pdbRecordNode,
+                ellCount(&pdbRecordType->recList), func, user);
+            continue;
+        }
+
+        while (pdbRecordNode) {
+            int i;
+
+            pchunk = dbCalloc(1, sizeof(initChunk));
+            pchunk->func = func;
+            pchunk->user = user;
+            pchunk->pdbRecordType = pdbRecordType;
+            pchunk->pfirst = pdbRecordNode;
+            for (i = 0; pdbRecordNode && i < INIT_CHUNK_RECORDS; i++)
+                pdbRecordNode = (dbRecordNode *)ellNext(&pdbRecordNode->node);
+            pchunk->count = i;
+            ellAdd(&chunks, &pchunk->node);
+
+            pchunk->job = epicsJobCreate(pool, initChunkJob, pchunk);
+            if (!pchunk->job || epicsJobQueue(pchunk->job)) {
+                /* Do it here instead */
+                initChunkJob(pchunk, epicsJobModeRun);
+            }
+        }
+    }
+
+    epicsThreadPoolWait(pool, -1.0);
+
+    while ((pchunk = (initChunk *)ellGet(&chunks))) {
+        if (pchunk->job)
+            epicsJobDestroy(pchunk->job);
+        free(pchunk);
+    }
+    epicsThreadPoolDestroy(pool);
+}
 
 static void doInitRecord0(dbRecordType *pdbRecordType, dbCommon *precord,
     void *user)
@@ -560,9 +771,13 @@ static void doInitRecord1(dbRecordType *pdbRecordType, dbCommon *precord,
 static void initDatabase(void)
 {
     dbChannelInit();
-    iterateRecords(doInitRecord0, NULL);
+    iterateRecordsParallel(doInitRecord0, NULL);
+    initPhaseDone("init_record pass 0");
     iterateRecords(doResolveLinks, NULL);
-    iterateRecords(doInitRecord1, NULL);
+    dbLockInitSets(pdbbase);
+    initPhaseDone("resolve links");
+    iterateRecordsParallel(doInitRecord1, NULL);
+    initPhaseDone("init_record pass 1");
 
     epicsAtExit(exitDatabase, NULL);
     return;
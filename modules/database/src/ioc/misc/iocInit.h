@@ -22,6 +22,11 @@ enum iocStateEnum {
 extern "C" {
 #endif
 
+/* Number of threads for the parallel init_record() passes */
+DBCORE_API extern int iocInitThreads;
+/* Print per-phase timings at the end of iocBuild() */
+DBCORE_API extern int iocInitReportTimes;
+
 DBCORE_API enum iocStateEnum getIocState(void);
 DBCORE_API int iocInit(void);
 DBCORE_API int iocBuild(void);
@@ -29,6 +34,7 @@ DBCORE_API int iocBuildIsolated(void);
 DBCORE_API int iocRun(void);
 DBCORE_API int iocPause(void);
 DBCORE_API int iocShutdown(void);
+DBCORE_API int iocInitThreadSafe(const char *recordTypeName);
 
 #ifdef __cplusplus
 }
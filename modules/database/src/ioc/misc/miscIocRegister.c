@@ -53,6 +53,17 @@ static void iocPauseCallFunc(const iocshArgBuf *args)
     iocshSetError(iocPause());
 }
 
+/* iocInitThreadSafe */
+static const iocshArg iocInitThreadSafeArg0 = { "recordType",iocshArgString};
+static const iocshArg * const iocInitThreadSafeArgs[] = {&iocInitThreadSafeArg0};
+static const iocshFuncDef iocInitThreadSafeFuncDef = {"iocInitThreadSafe",1,iocInitThreadSafeArgs,
+             "Allow init_record() of a record type to run on several threads.\n"
+             "Only has an effect if iocInitThreads > 1; use before iocInit.\n"};
+static void iocInitThreadSafeCallFunc(const iocshArgBuf *args)
+{
+    iocshSetError(iocInitThreadSafe(args[0].sval));
+}
+
 /* coreRelease */
 static const iocshFuncDef coreReleaseFuncDef = {"coreRelease",0,NULL,
              "Print release information for iocCore.\n"};
@@ -68,6 +79,7 @@ void miscIocRegister(void)
     iocshRegister(&iocBuildFuncDef,iocBuildCallFunc);
     iocshRegister(&iocRunFuncDef,iocRunCallFunc);
     iocshRegister(&iocPauseFuncDef,iocPauseCallFunc);
+    iocshRegister(&iocInitThreadSafeFuncDef,iocInitThreadSafeCallFunc);
     iocshRegister(&coreReleaseFuncDef, coreReleaseCallFunc);
 }
 
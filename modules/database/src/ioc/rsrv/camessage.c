@@ -368,6 +368,17 @@ static int tcp_version_action ( caHdrLargeArray *mp, void *pPayload,
         return RSRV_ERROR;
     }
 
+    /*
+     * clients that accept compressed responses give a size threshold,
+     * smaller responses are never worth compressing
+     */
+    SEND_LOCK ( client );
+    client->compressMin = rsrvCompressArrays ? mp->m_available : 0u;
+    if ( client->compressMin && client->compressMin < MAX_TCP / 16u ) {
+        client->compressMin = MAX_TCP / 16u;
+    }
+    SEND_UNLOCK ( client );
+
     if ( mp->m_dataType > CA_PROTO_PRIORITY_MAX ) {
         return RSRV_ERROR;
     }
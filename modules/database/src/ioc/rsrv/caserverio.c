@@ -347,9 +347,82 @@ void cas_set_header_count (struct client *pClient, ca_uint32_t count)
     }
 }
 
+/*
+ * casCompressMsg()
+ *
+ * Replace a large data response with a CA_PROTO_COMPRESSED message
+ * if the client asked for that and it makes the message smaller.
+ * Returns the new payload size.
+ *
+ * send lock must be on while in this routine
+ */
+static ca_uint32_t casCompressMsg ( struct client *pClient, caHdr *pMsg,
+    ca_uint32_t size )
+{
+    unsigned cmmd = ntohs ( pMsg->m_cmmd );
+    unsigned type = ntohs ( pMsg->m_dataType );
+    char *pPayload = ( char * ) ( pMsg + 1 );
+    caCompressedHdr *pHdr;
+    unsigned stride = 1u;
+    unsigned csize;
+
+    if ( cmmd != CA_PROTO_READ && cmmd != CA_PROTO_READ_NOTIFY &&
+            cmmd != CA_PROTO_EVENT_ADD ) {
+        return size;
+    }
+    if ( pMsg->m_postsize == htons ( 0xffff ) ) {
+        pPayload += 2 * sizeof ( ca_uint32_t );
+    }
+    /* the padding is compressed too */
+    memset ( pPayload + size, 0, CA_MESSAGE_ALIGN ( size ) - size );
+    size = CA_MESSAGE_ALIGN ( size );
+    /* the result must be smaller, including its header */
+    if ( size <= sizeof ( *pHdr ) + 8u ) {
+        return size;
+    }
+
+    if ( size > pClient->compressBufSize ) {
+        char *pBuf = realloc ( pClient->pCompressBuf, size );
+        if ( ! pBuf ) {
+            return size;
+        }
+        pClient->pCompressBuf = pBuf;
+        pClient->compressBufSize = size;
+    }
+    if ( dbr_type_is_valid ( type ) ) {
+        switch ( dbr_value_size[type] ) {
+        case 2: case 4: case 8:
+            stride = dbr_value_size[type];
+        }
+    }
+    pClient->compressBytesIn += size;
+    csize = caNetCompress ( pPayload, size, stride, pClient->pCompressBuf,
+        size - sizeof ( *pHdr ) - 8u );
+    if ( csize == 0u ) {
+        pClient->compressBytesOut += size;
+        return size;
+    }
+
+    pHdr = ( caCompressedHdr * ) pPayload;
+    pHdr->m_cmmd = htons ( cmmd );
+    pHdr->m_codec = CA_COMPRESS_SHUFFLE_RLE;
+    pHdr->m_stride = stride;
+    pHdr->m_postsize = htonl ( size );
+    memcpy ( pHdr + 1, pClient->pCompressBuf, csize );
+    pMsg->m_cmmd = htons ( CA_PROTO_COMPRESSED );
+
+    csize += sizeof ( *pHdr );
+    memset ( pPayload + csize, 0, CA_MESSAGE_ALIGN ( csize ) - csize );
+    pClient->compressBytesOut += CA_MESSAGE_ALIGN ( csize );
+    return csize;
+}
+
 void cas_commit_msg ( struct client *pClient, ca_uint32_t size )
 {
     caHdr * pMsg = ( caHdr * ) &pClient->send.buf[pClient->send.stk];
+    if ( pClient->compressMin && size >= pClient->compressMin ) {
+        size = casCompressMsg ( pClient, pMsg, size );
+    }
     size = CA_MESSAGE_ALIGN ( size );
     if ( pMsg->m_postsize == htons ( 0xffff ) ) {
         ca_uint32_t * pLW = ( ca_uint32_t * ) ( pMsg + 1 );
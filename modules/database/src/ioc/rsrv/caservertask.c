@@ -844,6 +844,17 @@ static void log_one_client (struct client *client, unsigned level)
         client->priority,
         n, n == 1 ? "" : "s" );
 
+    if ( client->compressMin ) {
+        printf ( "\tCompressing responses >= %u bytes",
+            client->compressMin );
+        if ( client->compressBytesOut > 0.0 ) {
+            printf ( ", %.0f bytes sent as %.0f (%.1f:1)",
+                client->compressBytesIn, client->compressBytesOut,
+                client->compressBytesIn / client->compressBytesOut );
+        }
+        printf ( "\n" );
+    }
+
     if ( level >= 3u ) {
         double         send_delay;
         double         recv_delay;
@@ -1104,6 +1115,8 @@ void destroy_client ( struct client *client )
         }
     }
 
+    free ( client->pCompressBuf );
+
     if ( client->eventqLock ) {
         epicsMutexDestroy ( client->eventqLock );
     }
@@ -1305,6 +1318,10 @@ struct client * create_client ( SOCKET sock, int proto )
     epicsTimeGetCurrent ( &client->time_at_last_recv );
     client->minor_version_number = CA_UKN_MINOR_VERSION;
     client->recvBytesToDrain = 0u;
+    client->compressMin = 0u;
+    client->pCompressBuf = NULL;
+    client->compressBufSize = 0u;
+    client->compressBytesIn = client->compressBytesOut = 0.0;
 
     return client;
 }
@@ -38,4 +38,5 @@ void rsrvRegistrar(void)
 }
 
 epicsExportAddress(int, CASDEBUG);
+epicsExportAddress(int, rsrvCompressArrays);
 epicsExportRegistrar(rsrvRegistrar);
@@ -93,6 +93,11 @@ typedef struct client {
   unsigned              recvBytesToDrain;
   unsigned              priority;
   char                  disconnect; /* disconnect detected */
+  /*! compress responses at least this large, 0 if not, guarded by SEND_LOCK() */
+  ca_uint32_t           compressMin;
+  char                  *pCompressBuf;
+  ca_uint32_t           compressBufSize;
+  double                compressBytesIn, compressBytesOut;
 } client;
 
 /* Channel state shows which struct client list a
@@ -180,6 +185,7 @@ enum ctl {ctlInit, ctlRun, ctlPause, ctlExit};
 #endif
 
 GLBLTYPE int                CASDEBUG;
+GLBLTYPE int                rsrvCompressArrays  GLBLTYPE_INIT(1);
 GLBLTYPE unsigned short     ca_server_port, ca_udp_port, ca_beacon_port;
 GLBLTYPE ELLLIST            clientQ             GLBLTYPE_INIT(ELLLIST_INIT);
 GLBLTYPE ELLLIST            servers; /* rsrv_iface_config::node, read-only after rsrv_init() */
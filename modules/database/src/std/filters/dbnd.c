@@ -13,10 +13,13 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <epicsMath.h>
 #include <freeList.h>
+#include <dbConvert.h>
 #include <dbConvertFast.h>
+#include <dbLock.h>
 #include <chfPlugin.h>
 #include <recGbl.h>
 #include <epicsExit.h>
@@ -28,6 +31,11 @@ typedef struct myStruct {
     double cval;
     double hyst;
     double last;
+    /* array channels only */
+    long   nmax;        /* capacity of the buffers */
+    long   nlast;       /* elements in prev, -1 if nothing sent yet */
+    double *prev;       /* values last sent */
+    double *cur;        /* values being checked */
 } myStruct;
 
 static void *myStructFreeList;
@@ -51,6 +59,10 @@ static void * allocPvt(void)
 
 static void freePvt(void *pvt)
 {
+    myStruct *my = (myStruct*) pvt;
+
+    free(my->prev);
+    free(my->cur);
     freeListFree(myStructFreeList, pvt);
 }
 
@@ -59,6 +71,7 @@ static int parse_ok(void *pvt)
     myStruct *my = (myStruct*) pvt;
     my->hyst = my->cval;
     my->last = epicsNAN;
+    my->nlast = -1;
     return 0;
 }
 
@@ -69,8 +82,8 @@ static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl) {
     unsigned send = 1;
 
     /*
-     * Only scalar values supported - strings, arrays, and conversion errors
-     * are just passed on
+     * Only scalar values supported - strings, arrays (when the channel is
+     * not a numeric array), and conversion errors are just passed on
      */
     if (pfl->type == dbfl_type_val) {
         DBADDR localAddr = chan->addr; /* Structure copy */
@@ -94,9 +107,109 @@ static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl) {
     } else return pfl;
 }
 
+/*
+ * Same test as recGblCheckDeadband(), for each element: an update is
+ * sent when any element has moved by more than the deadband since the
+ * last update that was sent. The relative deadband of an element is a
+ * percentage of its last sent value.
+ */
+static int arrayChanged(const myStruct *my, long n)
+{
+    const double *prev = my->prev;
+    const double *cur = my->cur;
+    double scale = my->cval / 100.;
+    long i;
+
+    if (n != my->nlast)
+        return 1;
+
+    /* the common case of finite values inside the band, a single compare
+     * per element; stops at the first element needing the checks below */
+    for (i = 0; i < n; i++) {
+        double band = my->mode == 1 ? fabs(prev[i]) * scale : my->hyst;
+        if (!(fabs(cur[i] - prev[i]) <= band))
+            break;
+    }
+    for (; i < n; i++) {
+        double delta = 0.;
+        double band = my->mode == 1 ? fabs(prev[i]) * scale : my->hyst;
+
+        if (finite(cur[i]) && finite(prev[i]))
+            delta = fabs(cur[i] - prev[i]);
+        else if (!isnan(cur[i]) != !isnan(prev[i]) ||
+                 !isinf(cur[i]) != !isinf(prev[i]) ||
+                 (isinf(cur[i]) && cur[i] != prev[i]))
+            delta = epicsINF;
+        if (delta > band)
+            return 1;
+    }
+    return 0;
+}
+
+static db_field_log* filterArray(void* pvt, dbChannel *chan, db_field_log *pfl) {
+    myStruct *my = (myStruct*) pvt;
+    unsigned send = 1;
+
+    if (pfl->type == dbfl_type_ref && pfl->no_elements <= my->nmax &&
+        pfl->field_type == chan->addr.field_type) {
+        DBADDR localAddr = chan->addr; /* Structure copy */
+        int must_lock = !pfl->dtor;
+        long nSource = pfl->no_elements;
+        long offset = 0;
+        long status;
+
+        localAddr.pfield = pfl->u.r.field;
+        if (must_lock) {
+            dbScanLock(dbChannelRecord(chan));
+            dbChannelGetArrayInfo(chan, &localAddr.pfield, &nSource, &offset);
+        }
+        if (nSource > pfl->no_elements)
+            nSource = pfl->no_elements;
+        status = nSource <= 0 ? 0 :
+            dbGetConvertRoutine[pfl->field_type][DBR_DOUBLE]
+                (&localAddr, my->cur, nSource, pfl->no_elements,
+                 offset % pfl->no_elements);
+        if (must_lock)
+            dbScanUnlock(dbChannelRecord(chan));
+
+        if (!status) {
+            send = pfl->mask & ~(DBE_VALUE|DBE_LOG);
+            if (arrayChanged(my, nSource)) {
+                double *tmp = my->prev;
+
+                send |= pfl->mask & (DBE_VALUE|DBE_LOG);
+                my->prev = my->cur;
+                my->cur = tmp;
+                my->nlast = nSource;
+            }
+        }
+    }
+    if (!send) {
+        db_delete_field_log(pfl);
+        return NULL;
+    } else return pfl;
+}
+
 static void channelRegisterPre(dbChannel *chan, void *pvt,
                                chPostEventFunc **cb_out, void **arg_out, db_field_log *probe)
 {
+    myStruct *my = (myStruct*) pvt;
+
+    /* numeric arrays: compare each element against the last sent array */
+    if (probe->field_type >= DBF_CHAR && probe->field_type <= DBF_ENUM &&
+        probe->no_elements > 1) {
+        my->prev = calloc(probe->no_elements, sizeof(double));
+        my->cur = calloc(probe->no_elements, sizeof(double));
+        if (my->prev && my->cur) {
+            my->nmax = probe->no_elements;
+            *cb_out = filterArray;
+            *arg_out = pvt;
+            return;
+        }
+        free(my->prev);
+        free(my->cur);
+        my->prev = my->cur = NULL;
+    }
     *cb_out = filter;
     *arg_out = pvt;
 }
@@ -104,9 +217,9 @@ static void channelRegisterPre(dbChannel *chan, void *pvt,
 static void channel_report(dbChannel *chan, void *pvt, int level, const unsigned short indent)
 {
     myStruct *my = (myStruct*) pvt;
-    printf("%*sDeadband (dbnd): mode=%s, delta=%g%s\n", indent, "",
+    printf("%*sDeadband (dbnd): mode=%s, delta=%g%s%s\n", indent, "",
            chfPluginEnumString(modeEnum, my->mode, "n/a"), my->cval,
-           my->mode == 1 ? "%" : "");
+           my->mode == 1 ? "%" : "", my->nmax ? ", per element" : "");
 }
 
 static chfPluginIf pif = {
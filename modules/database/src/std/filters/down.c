@@ -0,0 +1,357 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Downsampling filter: reduces an array to at most n elements chosen
+ *  from the original, either the minimum and maximum of each of n/2 bins
+ *  (which preserves peaks) or by Largest-Triangle-Three-Buckets (LTTB).
+ *
+ *  The source array is scanned in place a chunk at a time and only the
+ *  selected elements are copied out, keeping their original data type.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "chfPlugin.h"
+#include "dbAccessDefs.h"
+#include "dbConvert.h"
+#include "db_field_log.h"
+#include "dbLock.h"
+#include "epicsExit.h"
+#include "epicsMath.h"
+#include "freeList.h"
+#include "epicsExport.h"
+
+typedef enum {
+    downMinMax, downLTTB
+} downMode;
+
+typedef struct myStruct {
+    epicsInt32 n;       /* target number of elements */
+    int mode;
+    void *arrayFreeList;
+} myStruct;
+
+/* The part of a (possibly wrapped) source array being reduced */
+typedef struct source {
+    DBADDR addr;        /* pfield is the start of the buffer */
+    GETCONVERTFUNC convert;
+    long size;          /* element size */
+    long nbuf;          /* elements in the buffer, for wrap-around */
+    long offset;        /* buffer index of element 0 */
+    long count;         /* number of elements */
+} source;
+
+#define CHUNK 256
+
+static void *myStructFreeList;
+
+static const
+chfPluginEnumType modeEnum[] = {
+    {"minmax", downMinMax}, {"lttb", downLTTB}, {NULL, 0}
+};
+
+static const
+chfPluginArgDef opts[] = {
+    chfInt32 (myStruct, n, "n", 1, 1),
+    chfEnum  (myStruct, mode, "m", 0, 1, modeEnum),
+    chfPluginArgEnd
+};
+
+static void * allocPvt(void)
+{
+    myStruct *my = (myStruct*) freeListCalloc(myStructFreeList);
+    if (!my) return NULL;
+
+    /* defaults */
+    my->mode = downMinMax;
+    return (void *) my;
+}
+
+static void freePvt(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (my->arrayFreeList) freeListCleanup(my->arrayFreeList);
+    freeListFree(myStructFreeList, pvt);
+}
+
+static int parse_ok(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (my->n < (my->mode == downLTTB ? 3 : 2))
+        return -1;
+    return 0;
+}
+
+static void freeArray(db_field_log *pfl)
+{
+    if (pfl->type == dbfl_type_ref) {
+        freeListFree(pfl->u.r.pvt, pfl->u.r.field);
+    }
+}
+
+/* Copy element i of the source to the n'th element of the target */
+static void copyOut(const source *src, long i, char *pTarget, long n)
+{
+    i += src->offset;
+    if (i >= src->nbuf)
+        i -= src->nbuf;
+    memcpy(pTarget + n * src->size,
+        (const char *) src->addr.pfield + i * src->size, src->size);
+}
+
+/* Fetch elements first..first+n-1 (n <= CHUNK) as doubles */
+static void fetch(const source *src, long first, long n, double *dst)
+{
+    long phys = src->offset + first;
+
+    if (phys >= src->nbuf)
+        phys -= src->nbuf;
+    src->convert(&src->addr, dst, n, src->nbuf, phys);
+}
+
+/* Bin boundaries, without overflowing a long for large arrays */
+static long boundary(long bin, long nbins, long count)
+{
+    return (long) ((epicsUInt64) bin * count / nbins);
+}
+
+/* Min/max per bin: returns the number of elements selected */
+static long selectMinMax(const source *src, long nTarget, char *pTarget)
+{
+    long nbins = nTarget / 2;
+    long nsel = 0;
+    long bin;
+    double buf[CHUNK];
+
+    for (bin = 0; bin < nbins; bin++) {
+        long lo = boundary(bin, nbins, src->count);
+        long hi = boundary(bin + 1, nbins, src->count);
+        long imin = lo, imax = lo;
+        double vmin, vmax;
+        long first;
+
+        fetch(src, lo, 1, buf);
+        vmin = vmax = buf[0];
+        for (first = lo; first < hi; first += CHUNK) {
+            long n = hi - first < CHUNK ? hi - first : CHUNK;
+            long i;
+
+            fetch(src, first, n, buf);
+            for (i = 0; i < n; i++) {
+                if (buf[i] < vmin) {
+                    vmin = buf[i];
+                    imin = first + i;
+                }
+                if (buf[i] > vmax) {
+                    vmax = buf[i];
+                    imax = first + i;
+                }
+            }
+        }
+        /* keep the selected elements in their original order */
+        if (imin < imax) {
+            copyOut(src, imin, pTarget, nsel++);
+            copyOut(src, imax, pTarget, nsel++);
+        }
+        else if (imin > imax) {
+            copyOut(src, imax, pTarget, nsel++);
+            copyOut(src, imin, pTarget, nsel++);
+        }
+        else
+            copyOut(src, imin, pTarget, nsel++);
+    }
+    return nsel;
+}
+
+/* Mean of elements lo..hi-1 */
+static double average(const source *src, long lo, long hi)
+{
+    double buf[CHUNK];
+    double sum = 0.0;
+    long first;
+
+    for (first = lo; first < hi; first += CHUNK) {
+        long n = hi - first < CHUNK ? hi - first : CHUNK;
+        long i;
+
+        fetch(src, first, n, buf);
+        for (i = 0; i < n; i++)
+            sum += buf[i];
+    }
+    return sum / (hi - lo);
+}
+
+/* Largest-Triangle-Three-Buckets: returns the number of elements selected */
+static long selectLTTB(const source *src, long nTarget, char *pTarget)
+{
+    long nbuckets = nTarget - 2;
+    long last = src->count - 1;
+    long a = 0;
+    long bucket;
+    double ay, buf[CHUNK];
+
+    fetch(src, 0, 1, buf);
+    ay = buf[0];
+    copyOut(src, 0, pTarget, 0);
+
+    /* buckets cover the elements between the first and the last */
+    for (bucket = 0; bucket < nbuckets; bucket++) {
+        long lo = 1 + boundary(bucket, nbuckets, last - 1);
+        long hi = 1 + boundary(bucket + 1, nbuckets, last - 1);
+        long nlo = hi;
+        long nhi = 1 + boundary(bucket + 2, nbuckets, last - 1);
+        double cx, cy, dx, dy, amax = -1.0;
+        long first, ibest = lo;
+
+        /* point C is the average of the next bucket, or the last element */
+        if (bucket == nbuckets - 1) {
+            nlo = last;
+            nhi = last + 1;
+        }
+        cx = (nlo + nhi - 1) / 2.0;
+        cy = average(src, nlo, nhi);
+        dx = cx - a;
+        dy = cy - ay;
+
+        for (first = lo; first < hi; first += CHUNK) {
+            long n = hi - first < CHUNK ? hi - first : CHUNK;
+            long i;
+
+            fetch(src, first, n, buf);
+            for (i = 0; i < n; i++) {
+                /* twice the area of the triangle A, B, C */
+                double area = fabs(dx * (buf[i] - ay) -
+                    (first + i - a) * dy);
+
+                if (area > amax) {
+                    amax = area;
+                    ibest = first + i;
+                }
+            }
+        }
+        fetch(src, ibest, 1, buf);
+        a = ibest;
+        ay = buf[0];
+        copyOut(src, a, pTarget, bucket + 1);
+    }
+    copyOut(src, last, pTarget, nTarget - 1);
+    return nTarget;
+}
+
+static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl)
+{
+    myStruct *my = (myStruct*) pvt;
+    int must_lock;
+    long nTarget;
+    char *pTarget;
+    long offset = 0;
+    long nSource = pfl->no_elements;
+    void *pSource = pfl->u.r.field;
+    source src;
+
+    if (pfl->type != dbfl_type_ref)
+        return pfl;
+
+    must_lock = !pfl->dtor;
+    if (must_lock) {
+        dbScanLock(dbChannelRecord(chan));
+        dbChannelGetArrayInfo(chan, &pSource, &nSource, &offset);
+    }
+    if (nSource > pfl->no_elements)
+        nSource = pfl->no_elements;
+
+    /* short arrays pass through unchanged */
+    if (nSource > my->n) {
+        pTarget = freeListMalloc(my->arrayFreeList);
+        if (pTarget) {
+            src.addr = chan->addr;
+            src.addr.pfield = pSource;
+            src.convert = dbGetConvertRoutine[pfl->field_type][DBR_DOUBLE];
+            src.size = pfl->field_size;
+            src.nbuf = pfl->no_elements;
+            src.offset = offset % pfl->no_elements;
+            src.count = nSource;
+
+            if (my->mode == downLTTB)
+                nTarget = selectLTTB(&src, my->n, pTarget);
+            else
+                nTarget = selectMinMax(&src, my->n, pTarget);
+
+            if (pfl->dtor) pfl->dtor(pfl);
+            pfl->u.r.field = pTarget;
+            pfl->dtor = freeArray;
+            pfl->u.r.pvt = my->arrayFreeList;
+            pfl->no_elements = nTarget;
+        }
+    }
+    if (must_lock)
+        dbScanUnlock(dbChannelRecord(chan));
+    return pfl;
+}
+
+static void channelRegisterPost(dbChannel *chan, void *pvt,
+    chPostEventFunc **cb_out, void **arg_out, db_field_log *probe)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    /* numeric arrays longer than the target only */
+    if (probe->field_type < DBF_CHAR || probe->field_type > DBF_ENUM ||
+        probe->no_elements <= my->n)
+        return;
+
+    if (!my->arrayFreeList)
+        freeListInitPvt(&my->arrayFreeList, my->n * probe->field_size, 2);
+    if (!my->arrayFreeList) return;
+
+    probe->no_elements = my->n;
+    *cb_out = filter;
+    *arg_out = pvt;
+}
+
+static void channel_report(dbChannel *chan, void *pvt, int level,
+    const unsigned short indent)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    printf("%*sDownsample (down): n=%d, m=%s\n", indent, "", my->n,
+           chfPluginEnumString(modeEnum, my->mode, "n/a"));
+}
+
+static chfPluginIf pif = {
+    allocPvt,
+    freePvt,
+
+    NULL, /* parse_error, */
+    parse_ok,
+
+    NULL, /* channel_open, */
+    NULL, /* channelRegisterPre, */
+    channelRegisterPost,
+    channel_report,
+    NULL /* channel_close */
+};
+
+static void downShutdown(void* ignore)
+{
+    if (myStructFreeList)
+        freeListCleanup(myStructFreeList);
+    myStructFreeList = NULL;
+}
+
+static void downInitialize(void)
+{
+    if (!myStructFreeList)
+        freeListInitPvt(&myStructFreeList, sizeof(myStruct), 64);
+
+    chfPluginRegister("down", &pif, opts);
+    epicsAtExit(downShutdown, NULL);
+}
+
+epicsExportRegistrar(downInitialize);
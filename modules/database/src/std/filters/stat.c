@@ -0,0 +1,382 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Statistics filter: aggregates a window of monitor updates into one
+ *  update carrying the mean, minimum, maximum, standard deviation or
+ *  count of the values seen, either per element or over whole arrays.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "alarm.h"
+#include "chfPlugin.h"
+#include "dbAccessDefs.h"
+#include "dbConvert.h"
+#include "db_field_log.h"
+#include "dbLock.h"
+#include "epicsExit.h"
+#include "epicsMath.h"
+#include "epicsTime.h"
+#include "freeList.h"
+#include "epicsExport.h"
+
+typedef enum {
+    statMean, statMin, statMax, statStd, statCount
+} statFunc;
+
+typedef struct myStruct {
+    epicsInt32 n;       /* updates per window, 0 if not limited */
+    double t;           /* seconds per window, 0 if not limited */
+    int func;
+    char all;           /* reduce whole arrays */
+    long nelem;         /* max elements in an update */
+    long nout;          /* max elements in the output */
+    double *x;          /* nelem values from the current update */
+    double *mean, *m2, *min, *max;
+    void *arrayFreeList;
+    /* window state */
+    epicsInt32 updates;
+    double count;       /* updates, or elements for whole arrays */
+    long len;           /* shortest update seen, per element */
+    epicsTimeStamp start;
+    unsigned char mask;
+    unsigned short stat, sevr;
+    char amsg[40];
+} myStruct;
+
+static void *myStructFreeList;
+
+static const
+chfPluginEnumType funcEnum[] = {
+    {"mean", statMean}, {"min", statMin}, {"max", statMax},
+    {"std", statStd}, {"count", statCount}, {NULL, 0}
+};
+
+static const
+chfPluginArgDef opts[] = {
+    chfInt32  (myStruct, n, "n", 0, 1),
+    chfDouble (myStruct, t, "t", 0, 1),
+    chfEnum   (myStruct, func, "f", 0, 1, funcEnum),
+    chfBoolean(myStruct, all, "all", 0, 1),
+    chfPluginArgEnd
+};
+
+static void * allocPvt(void)
+{
+    myStruct *my = (myStruct*) freeListCalloc(myStructFreeList);
+    if (!my) return NULL;
+
+    /* defaults */
+    my->func = statMean;
+    return (void *) my;
+}
+
+static void freePvt(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (my->arrayFreeList) freeListCleanup(my->arrayFreeList);
+    free(my->x);
+    freeListFree(myStructFreeList, pvt);
+}
+
+static int parse_ok(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (my->n < 0 || my->t < 0 || (my->n == 0 && !(my->t > 0)))
+        return -1;
+    return 0;
+}
+
+static void freeArray(db_field_log *pfl)
+{
+    if (pfl->type == dbfl_type_ref) {
+        freeListFree(pfl->u.r.pvt, pfl->u.r.field);
+    }
+}
+
+/* Fetch the values of an update into my->x, returns how many */
+static long getValues(myStruct *my, dbChannel *chan, db_field_log *pfl)
+{
+    DBADDR localAddr = chan->addr; /* Structure copy */
+    GETCONVERTFUNC convert = dbGetConvertRoutine[pfl->field_type][DBR_DOUBLE];
+    long nSource = pfl->no_elements;
+    long offset = 0;
+    long status;
+    int must_lock;
+
+    if (pfl->type == dbfl_type_val) {
+        localAddr.pfield = &pfl->u.v.field;
+        return convert(&localAddr, my->x, 1, 1, 0) ? 0 : 1;
+    }
+
+    localAddr.pfield = pfl->u.r.field;
+    must_lock = !pfl->dtor;
+    if (must_lock) {
+        dbScanLock(dbChannelRecord(chan));
+        dbChannelGetArrayInfo(chan, &localAddr.pfield, &nSource, &offset);
+    }
+    if (nSource > pfl->no_elements)
+        nSource = pfl->no_elements;
+    if (nSource > my->nelem)
+        nSource = my->nelem;
+    /* the array may wrap around at no_elements */
+    status = nSource <= 0 ? 0 :
+        convert(&localAddr, my->x, nSource, pfl->no_elements,
+            offset % pfl->no_elements);
+    if (must_lock)
+        dbScanUnlock(dbChannelRecord(chan));
+    return status ? 0 : nSource;
+}
+
+/* Add n values to the per-element statistics (Welford's method) */
+static void addElements(myStruct *my, long n)
+{
+    const double *x = my->x;
+    double *mean = my->mean, *m2 = my->m2;
+    double *min = my->min, *max = my->max;
+    double r;
+    long i;
+
+    if (my->count == 0) {
+        for (i = 0; i < n; i++) {
+            mean[i] = min[i] = max[i] = x[i];
+            m2[i] = 0.0;
+        }
+        my->len = n;
+        my->count = 1;
+        return;
+    }
+
+    if (n < my->len)
+        my->len = n;
+    n = my->len;
+    r = 1.0 / ++my->count;
+    for (i = 0; i < n; i++) {
+        double d = x[i] - mean[i];
+
+        mean[i] += d * r;
+        m2[i] += d * (x[i] - mean[i]);
+        min[i] = x[i] < min[i] ? x[i] : min[i];
+        max[i] = x[i] > max[i] ? x[i] : max[i];
+    }
+}
+
+/* Add n values to the whole-array statistics (Chan et al.) */
+static void addArray(myStruct *my, long n)
+{
+    const double *x = my->x;
+    double sum = 0.0, m2 = 0.0, mean, d, total, min, max;
+    long i;
+
+    if (n <= 0)
+        return;
+
+    for (i = 0; i < n; i++)
+        sum += x[i];
+    mean = sum / n;
+    for (i = 0; i < n; i++) {
+        d = x[i] - mean;
+        m2 += d * d;
+    }
+    min = max = x[0];
+    for (i = 1; i < n; i++) {
+        min = x[i] < min ? x[i] : min;
+        max = x[i] > max ? x[i] : max;
+    }
+
+    if (my->count == 0) {
+        my->mean[0] = mean;
+        my->m2[0] = m2;
+        my->min[0] = min;
+        my->max[0] = max;
+        my->count = n;
+        return;
+    }
+
+    total = my->count + n;
+    d = mean - my->mean[0];
+    my->mean[0] += d * n / total;
+    my->m2[0] += m2 + d * d * my->count * n / total;
+    if (min < my->min[0]) my->min[0] = min;
+    if (max > my->max[0]) my->max[0] = max;
+    my->count = total;
+}
+
+static double result(const myStruct *my, long i)
+{
+    switch (my->func) {
+    case statMin:   return my->min[i];
+    case statMax:   return my->max[i];
+    case statStd:   return sqrt(my->m2[i] / my->count);
+    case statCount: return my->count;
+    default:        return my->mean[i];
+    }
+}
+
+/* Replace the data in pfl with the window's statistics */
+static void emit(myStruct *my, db_field_log *pfl)
+{
+    long n = my->nout > 1 ? my->len : 1;
+    long i;
+
+    if (pfl->type == dbfl_type_ref && pfl->dtor)
+        pfl->dtor(pfl);
+    pfl->dtor = NULL;
+    pfl->field_type = DBF_DOUBLE;
+    pfl->field_size = sizeof(epicsFloat64);
+    pfl->mask |= my->mask;
+    pfl->stat = my->stat;
+    pfl->sevr = my->sevr;
+    strcpy(pfl->amsg, my->amsg);
+
+    if (my->nout == 1) {
+        pfl->type = dbfl_type_val;
+        pfl->no_elements = 1;
+        pfl->u.v.field.dbf_double = result(my, 0);
+    }
+    else {
+        double *pTarget = freeListMalloc(my->arrayFreeList);
+
+        pfl->type = dbfl_type_ref;
+        pfl->no_elements = pTarget ? n : 0;
+        pfl->u.r.field = pTarget;
+        pfl->u.r.pvt = my->arrayFreeList;
+        if (pTarget) {
+            for (i = 0; i < n; i++)
+                pTarget[i] = result(my, i);
+            pfl->dtor = freeArray;
+        }
+    }
+
+    my->updates = 0;
+    my->count = 0;
+    my->mask = 0;
+    my->sevr = NO_ALARM;
+}
+
+static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl)
+{
+    myStruct *my = (myStruct*) pvt;
+    long n;
+
+    if (pfl->ctx == dbfl_context_read)
+        return pfl;
+
+    if (my->updates++ == 0) {
+        my->start = pfl->time;
+        my->stat = pfl->stat;
+        my->sevr = pfl->sevr;
+        strcpy(my->amsg, pfl->amsg);
+    }
+    else if (pfl->sevr > my->sevr) {
+        my->stat = pfl->stat;
+        my->sevr = pfl->sevr;
+        strcpy(my->amsg, pfl->amsg);
+    }
+    my->mask |= pfl->mask;
+
+    n = getValues(my, chan, pfl);
+    if (my->all)
+        addArray(my, n);
+    else
+        addElements(my, n);
+
+    /* The window closes after n updates or t seconds, whichever is first */
+    if ((my->n && my->updates >= my->n) ||
+        (my->t > 0 &&
+         epicsTimeDiffInSeconds(&pfl->time, &my->start) >= my->t)) {
+        if (my->count > 0) {
+            emit(my, pfl);
+            return pfl;
+        }
+        my->updates = 0;    /* nothing to send */
+    }
+
+    db_delete_field_log(pfl);
+    return NULL;
+}
+
+static void channelRegisterPost(dbChannel *chan, void *pvt,
+    chPostEventFunc **cb_out, void **arg_out, db_field_log *probe)
+{
+    myStruct *my = (myStruct*) pvt;
+    long nelem = probe->no_elements;
+    long nstats;
+
+    /* numeric data only */
+    if (probe->field_type < DBF_CHAR || probe->field_type > DBF_ENUM ||
+        nelem < 1)
+        return;
+
+    my->nelem = nelem;
+    my->nout = (my->all || my->func == statCount) ? 1 : nelem;
+    nstats = my->all ? 1 : nelem;
+    my->x = calloc(nelem + 4 * nstats, sizeof(double));
+    if (!my->x) return;
+    my->mean = my->x + nelem;
+    my->m2 = my->mean + nstats;
+    my->min = my->m2 + nstats;
+    my->max = my->min + nstats;
+
+    if (my->nout > 1) {
+        if (!my->arrayFreeList)
+            freeListInitPvt(&my->arrayFreeList, nelem * sizeof(double), 2);
+        if (!my->arrayFreeList) return;
+    }
+
+    probe->field_type = DBF_DOUBLE;
+    probe->field_size = sizeof(epicsFloat64);
+    probe->no_elements = my->nout;
+    *cb_out = filter;
+    *arg_out = pvt;
+}
+
+static void channel_report(dbChannel *chan, void *pvt, int level,
+    const unsigned short indent)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    printf("%*sStatistics (stat): f=%s, n=%d, t=%g%s, %d updates\n",
+           indent, "", chfPluginEnumString(funcEnum, my->func, "n/a"),
+           my->n, my->t, my->all ? ", all" : "", my->updates);
+}
+
+static chfPluginIf pif = {
+    allocPvt,
+    freePvt,
+
+    NULL, /* parse_error, */
+    parse_ok,
+
+    NULL, /* channel_open, */
+    NULL, /* channelRegisterPre, */
+    channelRegisterPost,
+    channel_report,
+    NULL /* channel_close */
+};
+
+static void statShutdown(void* ignore)
+{
+    if (myStructFreeList)
+        freeListCleanup(myStructFreeList);
+    myStructFreeList = NULL;
+}
+
+static void statInitialize(void)
+{
+    if (!myStructFreeList)
+        freeListInitPvt(&myStructFreeList, sizeof(myStruct), 64);
+
+    chfPluginRegister("stat", &pif, opts);
+    epicsAtExit(statShutdown, NULL);
+}
+
+epicsExportRegistrar(statInitialize);
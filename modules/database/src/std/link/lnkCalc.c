@@ -10,6 +10,8 @@
 /*  Usage
  *      {calc:{expr:"A*B", args:[{...}, ...], units:"mm"}}
  *  First link in 'args' is 'A', second is 'B', and so forth.
+ *  An input link with nelm:N > 1 reads up to N elements from each
+ *  argument and evaluates the expression with calcPerformArray().
  */
 
 #include <string.h>
@@ -21,6 +23,7 @@
 #include "dbDefs.h"
 #include "errlog.h"
 #include "epicsAssert.h"
+#include "epicsMath.h"
 #include "epicsString.h"
 #include "epicsTypes.h"
 #include "epicsTime.h"
@@ -46,7 +49,7 @@ typedef struct calc_link {
         ps_init,
         ps_expr, ps_major, ps_minor,
         ps_args, ps_out,
-        ps_prec,
+        ps_prec, ps_nelm,
         ps_units,
         ps_time,
         ps_error
@@ -69,6 +72,12 @@ typedef struct calc_link {
     epicsTimeStamp time;
     epicsUTag utag;
     double val;
+    long nelm;          /* > 1 for array evaluation */
+    double *abuf;       /* nelm doubles for each arg, result and scratch */
+    const double *parray[CALCPERFORM_NARGS];
+    unsigned long narray[CALCPERFORM_NARGS];
+    double *aval;
+    unsigned long naval;
 } calc_link;
 
 static lset lnkCalc_lset;
@@ -96,6 +105,7 @@ static jlink* lnkCalc_alloc(short dbfType)
     clink->pstate = ps_init;
     clink->prec = 15;   /* standard value for a double */
     clink->tinp = -1;
+    clink->nelm = 1;
 
     return &clink->jlink;
 }
@@ -117,6 +127,7 @@ static void lnkCalc_free(jlink *pjlink)
     free(clink->post_major);
     free(clink->post_minor);
     free(clink->units);
+    free(clink->abuf);
     free(clink);
 }
 
@@ -129,6 +140,15 @@ static jlif_result lnkCalc_integer(jlink *pjlink, long long num)
         return jlif_continue;
     }
 
+    if (clink->pstate == ps_nelm) {
+        if (num < 1 || num > 0x7fffffff / sizeof(double)) {
+            errlogPrintf("lnkCalc: Bad 'nelm' parameter %lld\n", num);
+            return jlif_stop;
+        }
+        clink->nelm = num;
+        return jlif_continue;
+    }
+
     if (clink->pstate != ps_args) {
         errlogPrintf("lnkCalc: Unexpected integer %lld\n", num);
         return jlif_stop;
@@ -273,6 +293,9 @@ static jlif_result lnkCalc_map_key(jlink *pjlink, const char *key, size_t len)
             clink->pstate = ps_prec;
         else if (!strncmp(key, "time", len))
             clink->pstate = ps_time;
+        else if (!strncmp(key, "nelm", len) &&
+            clink->dbfType == DBF_INLINK)
+            clink->pstate = ps_nelm;
         else {
             errlogPrintf("lnkCalc: Unknown key \"%.4s\"\n", key);
             return jlif_stop;
@@ -385,6 +408,10 @@ static void lnkCalc_report(const jlink *pjlink, int level, int indent)
         clink->expr, clink->prec, clink->val,
         clink->units ? clink->units : "");
 
+    if (clink->nelm > 1)
+        printf("%*s  Elements: %lu of %ld\n", indent, "",
+            clink->naval, clink->nelm);
+
     if (level > 0) {
         if (clink->sevr)
             printf("%*s  Alarm: %s, %s, \"%s\"\n", indent, "",
@@ -412,8 +439,12 @@ static void lnkCalc_report(const jlink *pjlink, int level, int indent)
             jlink *child = plink->type == JSON_LINK ?
                 plink->value.json.jlink : NULL;
 
-            printf("%*s  Input %c: %g\n", indent, "",
-                i + 'A', clink->arg[i]);
+            if (clink->nelm > 1)
+                printf("%*s  Input %c: %lu elements\n", indent, "",
+                    i + 'A', clink->narray[i]);
+            else
+                printf("%*s  Input %c: %g\n", indent, "",
+                    i + 'A', clink->arg[i]);
 
             if (child)
                 dbJLinkReport(child, level - 1, indent + 4);
@@ -462,6 +493,39 @@ static void lnkCalc_open(struct link *plink)
         dbLoadLink(child, DBR_DOUBLE, &clink->arg[i]);
     }
 
+    if (clink->nelm > 1) {
+        clink->abuf = calloc(clink->nArgs + 2, clink->nelm * sizeof(double));
+        if (!clink->abuf) {
+            errlogPrintf("lnkCalc: calloc() failed.\n");
+            clink->nelm = 1;
+        }
+    }
+
+    if (clink->nelm > 1) {
+        /* Numeric and unused args are scalars, constant links are
+         * loaded once here, other links are read by getValue.
+         */
+        for (i = 0; i < CALCPERFORM_NARGS; i++) {
+            clink->parray[i] = &clink->arg[i];
+            clink->narray[i] = 1;
+        }
+        for (i = 0; i < clink->nArgs; i++) {
+            struct link *child = &clink->inp[i];
+            double *parray = clink->abuf + i * clink->nelm;
+            long n = clink->nelm;
+
+            if (!child->lset)
+                continue;
+            clink->parray[i] = parray;
+            parray[0] = clink->arg[i];
+            if (dbLinkIsConstant(child) &&
+                !dbLoadLinkArray(child, DBR_DOUBLE, parray, &n))
+                clink->narray[i] = n;
+        }
+        clink->aval = clink->abuf + clink->nArgs * clink->nelm;
+        clink->naval = 1;
+    }
+
     if (clink->out.type == JSON_LINK) {
         dbJLinkInit(&clink->out);
     }
@@ -490,6 +554,7 @@ static void lnkCalc_remove(struct dbLocker *locker, struct link *plink)
     free(clink->post_major);
     free(clink->post_minor);
     free(clink->units);
+    free(clink->abuf);
     free(clink);
     plink->value.json.jlink = NULL;
 }
@@ -527,7 +592,10 @@ static int lnkCalc_getDBFtype(const struct link *plink)
 
 static long lnkCalc_getElements(const struct link *plink, long *nelements)
 {
-    *nelements = 1;
+    calc_link *clink = CONTAINER(plink->value.json.jlink,
+        struct calc_link, jlink);
+
+    *nelements = clink->nelm;
     return 0;
 }
 
@@ -536,13 +604,13 @@ struct lcvt {
     double *pval;
     epicsTimeStamp *ptime;
     epicsUTag *ptag;
+    long nReq;
 };
 
 static long readLocked(struct link *pinp, void *vvt)
 {
     struct lcvt *pvt = (struct lcvt *) vvt;
-    long nReq = 1;
-    long status = dbGetLink(pinp, DBR_DOUBLE, pvt->pval, NULL, &nReq);
+    long status = dbGetLink(pinp, DBR_DOUBLE, pvt->pval, NULL, &pvt->nReq);
 
     if (!status && pvt->ptime)
         dbGetTimeStampTag(pinp, pvt->ptime, pvt->ptag);
@@ -550,6 +618,113 @@ static long readLocked(struct link *pinp, void *vvt)
     return status;
 }
 
+/* Evaluate an alarm expression on the array result, true if any
+ * element of its result is non-zero.
+ */
+static int arrayAlarm(calc_link *clink, const char *post, long *pstatus)
+{
+    double *alval = clink->aval + clink->nelm;
+    unsigned long n = clink->naval;
+    unsigned long i;
+
+    memcpy(alval, clink->aval, n * sizeof(double));
+    *pstatus = calcPerformArray(clink->parray, clink->narray, alval, &n,
+        clink->nelm, post);
+    if (*pstatus)
+        return 0;
+    for (i = 0; i < n; i++)
+        if (alval[i])
+            return 1;
+    return 0;
+}
+
+static long getArrayValue(struct link *plink, short dbrType, void *pbuffer,
+    long *pnRequest)
+{
+    calc_link *clink = CONTAINER(plink->value.json.jlink,
+        struct calc_link, jlink);
+    dbCommon *prec = plink->precord;
+    long nRequest = pnRequest ? *pnRequest : 1;
+    int i;
+    long status;
+
+    /* Any link errors will trigger a LINK/INVALID alarm in the child link */
+    for (i = 0; i < clink->nArgs; i++) {
+        struct link *child = &clink->inp[i];
+        double *parray = clink->abuf + i * clink->nelm;
+        long nReq = clink->nelm;
+        long nElem;
+
+        if (dbLinkIsConstant(child))
+            continue;
+
+        /* Not all link types set *pnRequest for scalar values */
+        if (!dbGetNelements(child, &nElem) && nElem < nReq)
+            nReq = nElem > 0 ? nElem : 1;
+
+        if (i == clink->tinp) {
+            struct lcvt vt = {parray, &clink->time, &clink->utag, nReq};
+
+            status = dbLinkDoLocked(child, readLocked, &vt);
+            if (status == S_db_noLSET)
+                status = readLocked(child, &vt);
+            if (!status)
+                clink->narray[i] = vt.nReq;
+
+            if (dbLinkIsConstant(&prec->tsel) &&
+                prec->tse == epicsTimeEventDeviceTime) {
+                prec->time = clink->time;
+                prec->utag = clink->utag;
+            }
+        }
+        else if (!dbGetLink(child, DBR_DOUBLE, parray, NULL, &nReq))
+            clink->narray[i] = nReq;
+    }
+    clink->stat = 0;
+    clink->sevr = 0;
+    clink->amsg[0] = '\0';
+
+    if (clink->post_expr) {
+        status = calcPerformArray(clink->parray, clink->narray, clink->aval,
+            &clink->naval, clink->nelm, clink->post_expr);
+        if (!status) {
+            FASTCONVERT conv = dbFastPutConvertRoutine[DBR_DOUBLE][dbrType];
+            int size = dbValueSize(dbrType);
+            long n = clink->naval < nRequest ? clink->naval : nRequest;
+            char *pdst = pbuffer;
+
+            clink->val = clink->naval ? clink->aval[0] : epicsNAN;
+            for (i = 0; !status && i < n; i++, pdst += size)
+                status = conv(&clink->aval[i], pdst, NULL);
+            if (!status && pnRequest)
+                *pnRequest = n;
+        }
+    }
+    else {
+        status = 0;
+        if (pnRequest)
+            *pnRequest = 0;
+    }
+
+    if (!status && clink->post_major &&
+        arrayAlarm(clink, clink->post_major, &status)) {
+        clink->stat = LINK_ALARM;
+        clink->sevr = MAJOR_ALARM;
+        strcpy(clink->amsg, "post_major error");
+        recGblSetSevrMsg(prec, clink->stat, clink->sevr, "post_major error");
+    }
+
+    if (!status && !clink->sevr && clink->post_minor &&
+        arrayAlarm(clink, clink->post_minor, &status)) {
+        clink->stat = LINK_ALARM;
+        clink->sevr = MINOR_ALARM;
+        strcpy(clink->amsg, "post_minor error");
+        recGblSetSevrMsg(prec, clink->stat, clink->sevr, "post_minor error");
+    }
+
+    return status;
+}
+
 static long lnkCalc_getValue(struct link *plink, short dbrType, void *pbuffer,
     long *pnRequest)
 {
@@ -563,6 +738,9 @@ static long lnkCalc_getValue(struct link *plink, short dbrType, void *pbuffer,
     if(INVALID_DB_REQ(dbrType))
         return S_db_badDbrtype;
 
+    if (clink->nelm > 1)
+        return getArrayValue(plink, dbrType, pbuffer, pnRequest);
+
     conv = dbFastPutConvertRoutine[DBR_DOUBLE][dbrType];
 
     /* Any link errors will trigger a LINK/INVALID alarm in the child link */
@@ -571,7 +749,7 @@ static long lnkCalc_getValue(struct link *plink, short dbrType, void *pbuffer,
         long nReq = 1;
 
         if (i == clink->tinp) {
-            struct lcvt vt = {&clink->arg[i], &clink->time, &clink->utag};
+            struct lcvt vt = {&clink->arg[i], &clink->time, &clink->utag, 1};
 
             status = dbLinkDoLocked(child, readLocked, &vt);
             if (status == S_db_noLSET)
@@ -651,7 +829,7 @@ static long lnkCalc_putValue(struct link *plink, short dbrType,
         long nReq = 1;
 
         if (i == clink->tinp) {
-            struct lcvt vt = {&clink->arg[i], &clink->time, &clink->utag};
+            struct lcvt vt = {&clink->arg[i], &clink->time, &clink->utag, 1};
 
             status = dbLinkDoLocked(child, readLocked, &vt);
             if (status == S_db_noLSET)
@@ -108,6 +108,7 @@ static long init_record(struct dbCommon *pcommon, int pass)
         errlogPrintf("%s.CALC: %s in expression \"%s\"\n",
                      prec->name, calcErrorStr(error_number), prec->calc);
     }
+    calcArgUsage(prec->rpcl, &prec->ftch, NULL);
     return 0;
 }
 
@@ -150,6 +151,7 @@ static long special(DBADDR *paddr, int after)
                          prec->name, calcErrorStr(error_number), prec->calc);
             return S_db_badField;
         }
+        calcArgUsage(prec->rpcl, &prec->ftch, NULL);
         return 0;
     }
     recGblDbaddrError(S_db_badChoice, paddr, "calc::special - bad special value!");
@@ -436,6 +438,12 @@ static int fetch_values(calcRecord *prec)
     for(i = 0; i < CALCPERFORM_NARGS; i++, plink++, pvalue++) {
         int newStatus;
 
+        /* Constant links have nothing to fetch, and unused inputs are
+         * only read if that processes or alarms a record */
+        if (dbLinkIsConstant(plink) ||
+            (!(prec->ftch & (1u << i)) && !dbLinkReadHasEffects(plink)))
+            continue;
+
         newStatus = dbGetLink(plink, DBR_DOUBLE, pvalue, 0, 0);
         if (status == 0) status = newStatus;
     }
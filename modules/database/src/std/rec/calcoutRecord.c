@@ -112,6 +112,8 @@ typedef struct rpvtStruct {
     epicsCallback checkLinkCb;
     short    cbScheduled;
     short    caLinkStat; /* NO_CA_LINKS, CA_LINKS_ALL_OK, CA_LINKS_NOT_OK */
+    unsigned long calcInputs;   /* inputs used by CALC */
+    unsigned long ocalInputs;   /* inputs used by OCAL */
 } rpvtStruct;
 
 static void checkAlarms(calcoutRecord *prec);
@@ -195,6 +197,7 @@ static long init_record(struct dbCommon *pcommon, int pass)
         errlogPrintf("%s.CALC: %s in expression \"%s\"\n",
                      prec->name, calcErrorStr(error_number), prec->calc);
     }
+    calcArgUsage(prec->rpcl, &prpvt->calcInputs, NULL);
 
     prec->oclv = postfix(prec->ocal, prec->orpc, &error_number);
     if (prec->dopt == calcoutDOPT_Use_OVAL && prec->oclv){
@@ -203,6 +206,7 @@ static long init_record(struct dbCommon *pcommon, int pass)
         errlogPrintf("%s.OCAL: %s in expression \"%s\"\n",
                      prec->name, calcErrorStr(error_number), prec->ocal);
     }
+    calcArgUsage(prec->orpc, &prpvt->ocalInputs, NULL);
 
     prpvt = prec->rpvt;
     callbackSetCallback(checkLinksCallback, &prpvt->checkLinkCb);
@@ -330,6 +334,7 @@ static long special(DBADDR *paddr, int after)
             errlogPrintf("%s.CALC: %s in expression \"%s\"\n",
                          prec->name, calcErrorStr(error_number), prec->calc);
         }
+        calcArgUsage(prec->rpcl, &prpvt->calcInputs, NULL);
         db_post_events(prec, &prec->clcv, DBE_VALUE);
         return 0;
 
@@ -341,6 +346,7 @@ static long special(DBADDR *paddr, int after)
             errlogPrintf("%s.OCAL: %s in expression \"%s\"\n",
                          prec->name, calcErrorStr(error_number), prec->ocal);
         }
+        calcArgUsage(prec->orpc, &prpvt->ocalInputs, NULL);
         db_post_events(prec, &prec->oclv, DBE_VALUE);
         return 0;
       case(calcoutRecordINPA):
@@ -684,6 +690,8 @@ static void monitor(calcoutRecord *prec)
 
 static int fetch_values(calcoutRecord *prec)
 {
+        rpvtStruct      *prpvt = prec->rpvt;
+        unsigned long   inputs = prpvt->calcInputs | prpvt->ocalInputs;
         DBLINK  *plink; /* structure of the link field  */
         double          *pvalue;
         long            status = 0;
@@ -693,6 +701,12 @@ static int fetch_values(calcoutRecord *prec)
             i++, plink++, pvalue++) {
             int newStatus;
 
+            /* Constant links have nothing to fetch, and unused inputs are
+             * only read if that processes or alarms a record */
+            if (dbLinkIsConstant(plink) ||
+                (!(inputs & (1u << i)) && !dbLinkReadHasEffects(plink)))
+                continue;
+
             newStatus = dbGetLink(plink, DBR_DOUBLE, pvalue, 0, 0);
             if (!status) status = newStatus;
         }
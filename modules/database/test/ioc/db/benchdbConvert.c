@@ -5,6 +5,7 @@
 * EPICS BASE is distributed subject to a Software License Agreement found
 * in file LICENSE that is included with this distribution.
 \*************************************************************************/
+#include <stdio.h>
 #include "string.h"
 
 #include "cantProceed.h"
@@ -112,9 +113,91 @@ done:
     free(tdat.output);
 }
 
+/* numeric types, excluding DBF_ENUM which converts as DBF_USHORT */
+static const struct {
+    short dbf;
+    const char *name;
+    size_t size;
+} numTypes[] = {
+    {DBF_CHAR,   "CHAR",   1},
+    {DBF_UCHAR,  "UCHAR",  1},
+    {DBF_SHORT,  "SHORT",  2},
+    {DBF_USHORT, "USHORT", 2},
+    {DBF_LONG,   "LONG",   4},
+    {DBF_ULONG,  "ULONG",  4},
+    {DBF_INT64,  "INT64",  8},
+    {DBF_UINT64, "UINT64", 8},
+    {DBF_FLOAT,  "FLOAT",  4},
+    {DBF_DOUBLE, "DOUBLE", 8},
+};
+
+/* Time get (field to buffer) or put (buffer to field) conversion
+ * for every pair of numeric types, printing nanoseconds per element.
+ * A non-zero offset makes the field a wrapped ring buffer.
+ */
+static void runMatrix(int put, size_t nelem, long offset)
+{
+    size_t ntypes = NELEMENTS(numTypes), from, to;
+    size_t niter = 10000000/nelem + 1;
+    void *field = callocMustSucceed(nelem, 8, "runMatrix");
+    void *buf = callocMustSucceed(nelem, 8, "runMatrix");
+    char line[256];
+    int pos;
+
+    testDiag("%s %lu elements%s, ns/element, row is field type, column is request type",
+             put ? "Put" : "Get", (unsigned long)nelem, offset ? " wrapped" : "");
+    pos = sprintf(line, "%-7s", "");
+    for(to=0; to<ntypes; to++)
+        pos += sprintf(line+pos, "%7s", numTypes[to].name);
+    testDiag("%s", line);
+
+    for(from=0; from<ntypes; from++) {
+        pos = sprintf(line, "%-7s", numTypes[from].name);
+
+        for(to=0; to<ntypes; to++) {
+            DBADDR addr;
+            epicsUInt64 start;
+            size_t i;
+
+            memset(&addr, 0, sizeof(addr));
+            addr.field_type = numTypes[from].dbf;
+            addr.field_size = (short)numTypes[from].size;
+            addr.no_elements = (long)nelem;
+            addr.pfield = field;
+
+            start = epicsMonotonicGet();
+            if(put) {
+                PUTCONVERTFUNC putter = dbPutConvertRoutine[numTypes[to].dbf][numTypes[from].dbf];
+                for(i=0; i<niter; i++)
+                    putter(&addr, buf, (long)nelem, (long)nelem, offset);
+            } else {
+                GETCONVERTFUNC getter = dbGetConvertRoutine[numTypes[from].dbf][numTypes[to].dbf];
+                for(i=0; i<niter; i++)
+                    getter(&addr, buf, (long)nelem, (long)nelem, offset);
+            }
+            pos += sprintf(line+pos, "%7.2f",
+                           (epicsMonotonicGet()-start)/(double)(niter*nelem));
+        }
+        testDiag("%s", line);
+    }
+
+    free(field);
+    free(buf);
+}
+
 MAIN(benchdbConvert)
 {
+    size_t sizes[] = {16, 1000, 100000, 1000000};
+    unsigned i;
+
     testPlan(0);
+    for(i=0; i<NELEMENTS(sizes); i++) {
+        runMatrix(0, sizes[i], 0);
+        runMatrix(1, sizes[i], 0);
+    }
+    runMatrix(0, 100000, 100000/3);
+    runMatrix(1, 100000, 100000/3);
+
     runBench(1, 10000000, 10);
     runBench(2,  5000000, 10);
     runBench(10, 1000000, 10);
@@ -109,9 +109,76 @@ void checkAlarm(void)
     testOk1(strcmp(amsg, "a me")==0);
 }
 
+static
+void checkScalar(void)
+{
+    xRecord* scalar = (xRecord*)testdbRecordPtr("scalar");
+    dbCommon* lnk = testdbRecordPtr("lnk");
+    struct link *plink = dbGetDevLink(lnk);
+    testMonitor *mon;
+    epicsFloat64 dval = 0;
+    epicsInt32 lval = 0;
+
+    testDiag("checkScalar()");
+
+    mon = testMonitorCreate("scalar.F64", DBE_VALUE, 0);
+
+    /* second read or write of the same type uses the bound conversion */
+    dbScanLock(lnk);
+    testOk1(0==dbGetLink(plink, DBR_DOUBLE, &dval, NULL, NULL) && dval==3.0);
+    dval = 0;
+    testOk1(0==dbGetLink(plink, DBR_DOUBLE, &dval, NULL, NULL) && dval==3.0);
+    testOk1(0==dbGetLink(plink, DBR_LONG, &lval, NULL, NULL) && lval==3);
+    dval = 4.25;
+    testOk1(0==dbPutLink(plink, DBR_DOUBLE, &dval, 1));
+    testOk1(scalar->f64==4.25);
+    dval = 5.5;
+    testOk1(0==dbPutLink(plink, DBR_DOUBLE, &dval, 1));
+    testOk1(scalar->f64==5.5);
+    lval = 7;
+    testOk1(0==dbPutLink(plink, DBR_LONG, &lval, 1));
+    testOk1(scalar->f64==7.0);
+    dbScanUnlock(lnk);
+
+    testMonitorWait(mon);
+    testOk(testMonitorCount(mon, 1)==3, "3 monitor events for 3 link puts");
+    testMonitorDestroy(mon);
+
+    /* retarget to a field of another type */
+    testdbPutFieldOk("lnk.INP", DBR_STRING, "scalar.I16");
+
+    dbScanLock(lnk);
+    testOk1(0==dbGetLink(plink, DBR_DOUBLE, &dval, NULL, NULL) && dval==-3.0);
+    dval = 0;
+    testOk1(0==dbGetLink(plink, DBR_DOUBLE, &dval, NULL, NULL) && dval==-3.0);
+    dval = 12.0;
+    testOk1(0==dbPutLink(plink, DBR_DOUBLE, &dval, 1));
+    testOk1(0==dbPutLink(plink, DBR_DOUBLE, &dval, 1));
+    testOk1(scalar->i16==12);
+    dbScanUnlock(lnk);
+
+    /* VAL has SPC_MOD so puts always go through dbPut() */
+    testdbPutFieldOk("lnk.INP", DBR_STRING, "scalar.VAL");
+
+    dbScanLock(lnk);
+    lval = 42;
+    testOk1(0==dbPutLink(plink, DBR_LONG, &lval, 1));
+    testOk1(0==dbPutLink(plink, DBR_LONG, &lval, 1));
+    testOk1(scalar->val==42);
+    dbScanUnlock(lnk);
+
+    /* link fields have no scalar conversion */
+    testdbPutFieldOk("lnk.INP", DBR_STRING, "scalar.LNK");
+
+    dbScanLock(lnk);
+    testOk1(S_db_badDbrtype==dbGetLink(plink, DBR_DOUBLE, &dval, NULL, NULL));
+    testOk1(S_db_badDbrtype==dbGetLink(plink, DBR_DOUBLE, &dval, NULL, NULL));
+    dbScanUnlock(lnk);
+}
+
 MAIN(dbDbLinkTest)
 {
-    testPlan(18);
+    testPlan(41);
 
     testdbPrepare();
 
@@ -127,6 +194,7 @@ MAIN(dbDbLinkTest)
 
     checkTime();
     checkAlarm();
+    checkScalar();
 
     testIocShutdownOk();
 
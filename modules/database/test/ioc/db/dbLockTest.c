@@ -16,6 +16,7 @@
 #include "epicsMutex.h"
 #include "dbCommon.h"
 #include "epicsThread.h"
+#include "epicsEvent.h"
 
 #include "dbLockPvt.h"
 #include "dbStaticLib.h"
@@ -24,6 +25,8 @@
 #include "testMain.h"
 
 #include "dbAccess.h"
+#include "epicsStdio.h"
+#include "epicsTime.h"
 #include "errlog.h"
 
 void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
@@ -414,12 +417,256 @@ static void testLinkNOP(void)
     testdbCleanup();
 }
 
+/* A long chain of DB links, each record linking to the one created
+ * before it, is merged into a single lockSet at init.
+ * Breaking a link near one end splits off only a few records.
+ */
+#define NCHAIN 20000
+
+static void testLongChain(void)
+{
+    DBENTRY entry;
+    char name[20], target[20];
+    epicsUInt64 start;
+    dbCommon *pfirst, *plast, *pnear;
+    int i, nBad = 0;
+
+    testDiag("Test chain of %d records", NCHAIN);
+
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    dbInitEntry(pdbbase, &entry);
+    for(i=0; i<NCHAIN; i++) {
+        epicsSnprintf(name, sizeof(name), "chain%d", i);
+        if(dbFindRecordType(&entry, "x") || dbCreateRecord(&entry, name)) {
+            nBad++;
+            continue;
+        }
+        if(i==0)
+            continue;
+        epicsSnprintf(target, sizeof(target), "chain%d", i-1);
+        if(dbFindField(&entry, "SDIS") || dbPutString(&entry, target))
+            nBad++;
+    }
+    dbFinishEntry(&entry);
+    testOk(nBad==0, "Created chain (%d errors)", nBad);
+
+    start = epicsMonotonicGet();
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+    testDiag("iocInit took %.3f sec", (epicsMonotonicGet()-start)*1e-9);
+
+    pfirst = testdbRecordPtr("chain0");
+    plast = testdbRecordPtr("chain19999");
+    pnear = testdbRecordPtr("chain19998");
+
+    testOk1(pfirst->lset->plockSet==plast->lset->plockSet);
+    testIntOk1(ellCount(&pfirst->lset->plockSet->lockRecordList), ==, NCHAIN);
+    testIntOk1(pfirst->lset->plockSet->refcount, ==, NCHAIN);
+
+    start = epicsMonotonicGet();
+    testdbPutFieldOk("chain19999.SDIS", DBR_STRING, "");
+    testDiag("split took %.6f sec", (epicsMonotonicGet()-start)*1e-9);
+
+    testOk1(pfirst->lset->plockSet!=plast->lset->plockSet);
+    testOk1(pfirst->lset->plockSet==pnear->lset->plockSet);
+    testIntOk1(plast->lset->plockSet->refcount, ==, 1);
+    testIntOk1(pfirst->lset->plockSet->refcount, ==, NCHAIN-1);
+
+    start = epicsMonotonicGet();
+    testdbPutFieldOk("chain19999.SDIS", DBR_STRING, "chain0");
+    testDiag("merge took %.6f sec", (epicsMonotonicGet()-start)*1e-9);
+
+    testOk1(pfirst->lset->plockSet==plast->lset->plockSet);
+    testIntOk1(pfirst->lset->plockSet->refcount, ==, NCHAIN);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+}
+
+static void testOptimisticRead(void)
+{
+    dbCommon *prec, *pother;
+    dbLockReader reader;
+    DBADDR addr;
+    epicsInt32 val = 0;
+
+    testDiag("testing dbLockReadBegin()/dbLockReadEnd()");
+
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("dbLockTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    prec = testdbRecordPtr("reca");
+    pother = testdbRecordPtr("recb");
+
+    testOk1(dbLockReadBegin(prec, &reader));
+    testOk1(dbLockReadEnd(&reader));
+    testOk1(prec->lset->plockSet->refcount==1);
+
+    dbScanLock(prec);
+    testOk(!dbLockReadBegin(prec, &reader), "Can't begin while held");
+    dbScanLock(prec);
+    dbScanUnlock(prec);
+    testOk(!dbLockReadBegin(prec, &reader), "Can't begin while held recursively");
+    dbScanUnlock(prec);
+    testOk1(prec->lset->plockSet->refcount==1);
+
+    testOk1(dbLockReadBegin(prec, &reader));
+    dbScanLock(pother);
+    dbScanUnlock(pother);
+    testOk(dbLockReadEnd(&reader), "Not disturbed by another lockSet");
+
+    testOk1(dbLockReadBegin(prec, &reader));
+    dbScanLock(prec);
+    dbScanUnlock(prec);
+    testOk(!dbLockReadEnd(&reader), "Disturbed by a holder");
+    testOk1(prec->lset->plockSet->refcount==1);
+
+    /* recg is moved into the lockSet of recb */
+    pother = testdbRecordPtr("recg");
+    testOk1(dbLockReadBegin(pother, &reader));
+    testdbPutFieldOk("recb.SDIS", DBR_STRING, "recg");
+    testOk(!dbLockReadEnd(&reader), "Disturbed by a move");
+    testOk1(dbLockReadBegin(pother, &reader));
+    testOk(reader.plockSet==testdbRecordPtr("recb")->lset->plockSet,
+           "Begins on the new lockSet");
+    testOk1(dbLockReadEnd(&reader));
+
+    dbLockOptimisticRead = 1;
+    testdbPutFieldOk("reca.VAL", DBR_LONG, 42);
+    testOk1(!dbNameToAddr("reca.VAL", &addr));
+    testOk1(dbLockReadable(&addr, DBR_LONG, 0, NULL));
+    testOk1(!dbLockReadable(&addr, DBR_STRING, 0, NULL));
+    testOk1(!dbLockReadable(&addr, DBR_LONG, DBR_UNITS, NULL));
+    testOk1(!dbGetField(&addr, DBR_LONG, &val, NULL, NULL, NULL));
+    testIntOk1(val, ==, 42);
+    testdbGetFieldEqual("reca.VAL", DBR_DOUBLE, 42.0);
+    dbLockOptimisticRead = 0;
+    testOk1(!dbLockReadable(&addr, DBR_LONG, 0, NULL));
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+}
+
+static epicsEventId retryDone;
+
+static void retryLocker(void *arg)
+{
+    dbCommon *prec = arg;
+
+    dbScanLock(prec);
+    dbScanUnlock(prec);
+    epicsEventMustTrigger(retryDone);
+}
+
+static void testStats(void)
+{
+    dbCommon *prec;
+    lockSet *lG;
+    lockSetStats *stats;
+    epicsUInt64 nacq;
+    epicsUInt32 nhold = 0;
+    unsigned i;
+
+    testDiag("testing dbLockStats");
+
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("dbLockTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    prec = testdbRecordPtr("reca");
+
+    dbScanLock(prec);
+    dbScanUnlock(prec);
+    testOk(prec->lset->plockSet->stats==NULL, "Nothing collected while disabled");
+
+    dbLockStats = 1;
+    dbScanLock(prec);
+    dbScanUnlock(prec);
+    dbScanLock(prec);
+    dbScanLock(prec);
+    dbScanUnlock(prec);
+    dbScanUnlock(prec);
+    dbLockStats = 0;
+    dbScanLock(prec);
+    dbScanUnlock(prec);
+
+    testOk1(dbLockShowStats(5, "hold", 1)==0);
+    testOk1(dbLockShowStats(5, "nonsense", 0)!=0);
+
+    stats = prec->lset->plockSet->stats;
+    testOk1(stats!=NULL);
+    if(!stats) {
+        testSkip(6, "No stats");
+    } else {
+        testOk(stats->nAcquire==3, "nAcquire %u==3", (unsigned)stats->nAcquire);
+        testOk(stats->nContended==0, "nContended %u==0", (unsigned)stats->nContended);
+        testOk(stats->nHold==2, "nHold %u==2", (unsigned)stats->nHold);
+        for(i=0; i<DBLOCK_NHIST; i++)
+            nhold += stats->holdHist[i];
+        testOk(nhold==2, "hold histogram total %u==2", (unsigned)nhold);
+        testOk1(prec->lset->plockSet->holdStart==0);
+
+        dbLockResetStats();
+        testOk1(stats->nAcquire==0 && stats->nHold==0);
+    }
+
+    testDiag("a retried dbScanLock() is counted once");
+    prec = testdbRecordPtr("recg");
+    lG = dbLockGetRef(prec->lset);
+    retryDone = epicsEventMustCreate(epicsEventEmpty);
+    dbLockStats = 1;
+    /* held without dbScanLock(), which would release the new lockSet */
+    epicsMutexMustLock(lG->lock);
+    epicsThreadMustCreate("retry", epicsThreadPriorityMedium,
+                          epicsThreadGetStackSize(epicsThreadStackSmall),
+                          retryLocker, prec);
+    epicsThreadSleep(0.1);
+    /* recg is moved into the lockSet of recb while the thread waits */
+    testdbPutFieldOk("recb.SDIS", DBR_STRING, "recg");
+    nacq = lG->stats ? lG->stats->nAcquire : 0;
+    epicsMutexUnlock(lG->lock);
+    epicsEventMustWait(retryDone);
+    dbLockStats = 0;
+    testOk1(prec->lset->plockSet!=lG);
+    testOk((lG->stats ? lG->stats->nAcquire : 0)==nacq,
+           "Retried attempt not counted (%u==%u)",
+           (unsigned)(lG->stats ? lG->stats->nAcquire : 0), (unsigned)nacq);
+    stats = prec->lset->plockSet->stats;
+    testOk(stats && stats->nAcquire>=1, "Counted on the new lockSet");
+    dbLockDecRef(lG);
+    epicsEventDestroy(retryDone);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+}
+
 MAIN(dbLockTest)
 {
 #ifdef LOCKSET_DEBUG
-    testPlan(100);
+    testPlan(152);
 #else
-    testPlan(88);
+    testPlan(140);
 #endif
     testSets();
     testSingleLock();
@@ -428,5 +675,8 @@ MAIN(dbLockTest)
     testLinkMake();
     testLinkChange();
     testLinkNOP();
+    testLongChain();
+    testOptimisticRead();
+    testStats();
     return testDone();
 }
@@ -12,11 +12,13 @@
  */
 
 #include "epicsString.h"
+#include "epicsStdio.h"
 #include "dbUnitTest.h"
 #include "epicsThread.h"
 #include "iocInit.h"
 #include "dbBase.h"
 #include "dbAccess.h"
+#include "dbCommon.h"
 #include "registry.h"
 #include "dbStaticLib.h"
 #include "osiFileName.h"
@@ -86,12 +88,70 @@ void cycle(void) {
     testdbCleanup();
 }
 
+/* Initialize with the init_record() passes on a thread pool */
+#define NPARALLEL 2000
+
+static
+void cycleParallel(void) {
+    DBENTRY entry;
+    char name[20], value[20];
+    int i, nBad = 0;
+
+    testDiag("parallel init_record passes");
+
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    dbInitEntry(pdbbase, &entry);
+    for (i = 0; i < NPARALLEL; i++) {
+        epicsSnprintf(name, sizeof(name), "par%d", i);
+        epicsSnprintf(value, sizeof(value), "%d", i);
+        /* devxSoft's init_record() loads a constant INP into VAL */
+        if (dbFindRecordType(&entry, "x") || dbCreateRecord(&entry, name) ||
+            dbFindField(&entry, "INP") || dbPutString(&entry, value))
+            nBad++;
+    }
+    dbFinishEntry(&entry);
+    testOk(nBad == 0, "Created %d records", NPARALLEL - nBad);
+
+    testOk1(iocInitThreadSafe("x") == 0);
+    testOk1(iocInitThreadSafe("noSuchType") != 0);
+
+    iocInitThreads = 4;
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+    iocInitThreads = 0;
+
+    nBad = 0;
+    for (i = 0; i < NPARALLEL; i++) {
+        DBADDR addr;
+        epicsInt32 val = -1;
+        long nReq = 1;
+
+        epicsSnprintf(name, sizeof(name), "par%d.VAL", i);
+        if (dbNameToAddr(name, &addr) ||
+            dbGetField(&addr, DBR_LONG, &val, NULL, &nReq, NULL) ||
+            val != i)
+            nBad++;
+    }
+    testOk(nBad == 0, "%d records not initialized by init_record()", nBad);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+}
+
 MAIN(dbShutdownTest)
 {
-    testPlan(10);
+    testPlan(14);
 
     cycle();
     cycle();
+    cycleParallel();
 
     return testDone();
 }
@@ -10,10 +10,11 @@
  * Lockset stress test.
  *
  * The test strategy is for N threads to contend for M records.
- * Each thread will perform one of three operations:
+ * Each thread will perform one of four operations:
  * 1) Lock a single record.
  * 2) Lock several records.
- * 3) Retarget the TSEL link of a record
+ * 3) Read a field with dbGetField(), optimistic unless $OPTREAD is 0.
+ * 4) Retarget the TSEL link of a record
  *
  *  Author: Michael Davidsaver <mdavidsaver@bnl.gov>
  */
@@ -59,14 +60,17 @@ static unsigned int nrecords;
 
 #define MAXLOCK 20
 
+#define NACT 4
+
 static dbCommon **precords;
+static DBADDR *pvaladdrs; /* VAL of each record */
 
 typedef struct {
     int id;
-    unsigned long N[3];
-    double X[3];
-    double X2[3];
-    double min[3], max[3];
+    unsigned long N[NACT];
+    double X[NACT];
+    double X2[NACT];
+    double min[NACT], max[NACT];
 
     unsigned int done;
     epicsEventId donevent;
@@ -123,6 +127,16 @@ void doMulti(workerPriv *p)
     dbLockerFree(locker);
 }
 
+static
+void doRead(workerPriv *p)
+{
+    size_t recn = (size_t)(getRand()*(nrecords-1));
+    epicsInt32 val;
+
+    if(dbGetField(&pvaladdrs[recn], DBR_LONG, &val, NULL, NULL, NULL))
+        testAbort("get fails");
+}
+
 static
 void doreTarget(workerPriv *p)
 {
@@ -170,15 +184,18 @@ void worker(void *raw)
 
         before = epicsMonotonicGet();
 
-        if(sel<0.33) {
+        if(sel<0.25) {
             doSingle(priv);
             act = 0;
-        } else if(sel<0.66) {
+        } else if(sel<0.5) {
             doMulti(priv);
             act = 1;
+        } else if(sel<0.75) {
+            doRead(priv);
+            act = 2;
         } else {
             doreTarget(priv);
-            act = 2;
+            act = 3;
         }
 
         after = epicsMonotonicGet();
@@ -205,6 +222,7 @@ MAIN(dbStressTest)
     unsigned int i;
     workerPriv *priv;
     char *nwork=getenv("NWORK");
+    char *optread=getenv("OPTREAD");
     epicsTimeStamp seed;
 
     epicsTimeGetCurrent(&seed);
@@ -218,10 +236,10 @@ MAIN(dbStressTest)
             nworkers = val;
     }
 
-    testPlan(80+nworkers*3);
+    testPlan(120+nworkers*NACT);
 
 #if defined(__rtems__)
-    testSkip(80+nworkers*3, "Test assumes time sliced preempting scheduling");
+    testSkip(120+nworkers*NACT, "Test assumes time sliced preempting scheduling");
     return testDone();
 #endif
 
@@ -235,6 +253,8 @@ MAIN(dbStressTest)
     dbTestIoc_registerRecordDeviceDriver(pdbbase);
     testdbReadDatabase("dbStressLock.db", NULL, NULL);
 
+    dbLockOptimisticRead = !optread || atoi(optread)!=0;
+
     eltc(0);
     testIocInitOk();
     eltc(1);
@@ -258,6 +278,7 @@ MAIN(dbStressTest)
     if(nrecords<2)
         testAbort("where are the records!");
     precords = callocMustSucceed(nrecords, sizeof(*precords), "no mem");
+    pvaladdrs = callocMustSucceed(nrecords, sizeof(*pvaladdrs), "no mem");
     for(status = dbFirstRecordType(&ent), i = 0;
         !status;
         status = dbNextRecordType(&ent))
@@ -274,8 +295,18 @@ MAIN(dbStressTest)
     }
     dbFinishEntry(&ent);
 
-    testDiag("Running with %u workers and %u records",
-             nworkers, nrecords);
+    for(i=0; i<nrecords; i++) {
+        char name[PVNAME_STRINGSZ+4];
+
+        strcpy(name, precords[i]->name);
+        strcat(name, ".VAL");
+        if(dbNameToAddr(name, &pvaladdrs[i]))
+            testAbort("no field %s", name);
+    }
+
+    testDiag("Running with %u workers and %u records, %s reads",
+             nworkers, nrecords,
+             dbLockOptimisticRead ? "optimistic" : "locked");
 
     for(i=0; i<nworkers; i++) {
         priv[i].id = i;
@@ -323,29 +354,32 @@ MAIN(dbStressTest)
             testOk(ellCount(&ls->lockRecordList)==ls->refcount, "%s only lockRecords hold refs. %d == %d",
                    prec->name,ellCount(&ls->lockRecordList),ls->refcount);
             testOk1(ls->ownerlocker==NULL);
+            testOk(ls->holdcount==0 && (ls->seq&1)==0, "%s lockSet not held. seq=%lu",
+                   prec->name, (unsigned long)ls->seq);
         }
 
     }
     dbFinishEntry(&ent);
 
-    testDiag("Statistics");
+    testDiag("Statistics (single, multi, read, retarget)");
     for(i=0; i<nworkers; i++) {
-        double avg[3], std[3];
+        double avg[NACT], std[NACT];
         unsigned j;
         testDiag("Worker %u", i);
-        for(j=0; j<3; j++) {
+        for(j=0; j<NACT; j++) {
             avg[j] = priv[i].X[j]/priv[i].N[j];
             std[j] = sqrt( (priv[i].X2[j]/priv[i].N[j]) - avg[j]*avg[j] );
         }
-        testDiag("N = %lu\t%lu\t%lu", priv[i].N[0], priv[i].N[1], priv[i].N[2]);
-        testDiag("AVG = %g us\t%g us\t%g us", avg[0]*1e6, avg[1]*1e6, avg[2]*1e6);
-        testDiag("STD = %g us\t%g us\t%g us", std[0]*1e6, std[1]*1e6, std[2]*1e6);
-        testDiag("MIN = %g us\t%g us\t%g us", priv[i].min[0]*1e6, priv[i].min[1]*1e6, priv[i].min[2]*1e6);
-        testDiag("MAX = %g us\t%g us\t%g us", priv[i].max[0]*1e6, priv[i].max[1]*1e6, priv[i].max[2]*1e6);
-
-        testOk1(priv[i].N[0]>0);
-        testOk1(priv[i].N[1]>0);
-        testOk1(priv[i].N[2]>0);
+        testDiag("N = %lu\t%lu\t%lu\t%lu", priv[i].N[0], priv[i].N[1], priv[i].N[2], priv[i].N[3]);
+        testDiag("AVG = %g us\t%g us\t%g us\t%g us", avg[0]*1e6, avg[1]*1e6, avg[2]*1e6, avg[3]*1e6);
+        testDiag("STD = %g us\t%g us\t%g us\t%g us", std[0]*1e6, std[1]*1e6, std[2]*1e6, std[3]*1e6);
+        testDiag("MIN = %g us\t%g us\t%g us\t%g us", priv[i].min[0]*1e6, priv[i].min[1]*1e6,
+                 priv[i].min[2]*1e6, priv[i].min[3]*1e6);
+        testDiag("MAX = %g us\t%g us\t%g us\t%g us", priv[i].max[0]*1e6, priv[i].max[1]*1e6,
+                 priv[i].max[2]*1e6, priv[i].max[3]*1e6);
+
+        for(j=0; j<NACT; j++)
+            testOk(priv[i].N[j]>0, "priv[%u].N[%u]>0", i, j);
     }
 
     testIocShutdownOk();
@@ -354,6 +388,7 @@ MAIN(dbStressTest)
 
     free(priv);
     free(precords);
+    free(pvaladdrs);
 
     return testDone();
 }
@@ -11,6 +11,7 @@
 #include "dbConvert.h"
 #include "dbDefs.h"
 #include "epicsAssert.h"
+#include "epicsTypes.h"
 
 #include "epicsUnitTest.h"
 #include "testMain.h"
@@ -149,10 +150,58 @@ static void testBasicPut(void)
     free(scratch);
 }
 
+static void testConvertWrap(void)
+{
+    epicsInt16 sfield[7];
+    epicsFloat64 dbuf[8];
+    epicsFloat64 dfield[7];
+    epicsInt32 lbuf[8];
+    DBADDR addr;
+    long i;
+
+    testDiag("Test converting get and put with wrap");
+
+    for(i=0; i<7; i++)
+        sfield[i] = (epicsInt16)(i - 3);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.field_type = DBF_SHORT;
+    addr.field_size = sizeof(sfield[0]);
+    addr.no_elements = 7;
+    addr.pfield = sfield;
+
+    for(i=0; i<8; i++)
+        dbuf[i] = 42.0;
+    dbGetConvertRoutine[DBF_SHORT][DBR_DOUBLE](&addr, dbuf, 7, 7, 0);
+    testOk1(dbuf[0]==-3.0 && dbuf[6]==3.0 && dbuf[7]==42.0);
+
+    dbGetConvertRoutine[DBF_SHORT][DBR_DOUBLE](&addr, dbuf, 5, 7, 4);
+    testOk(dbuf[0]==1.0 && dbuf[2]==3.0 && dbuf[3]==-3.0 && dbuf[4]==-2.0 &&
+           dbuf[5]==2.0, "%g %g %g %g %g", dbuf[0], dbuf[2], dbuf[3], dbuf[4], dbuf[5]);
+
+    for(i=0; i<7; i++)
+        dfield[i] = 0.0;
+    for(i=0; i<8; i++)
+        lbuf[i] = (epicsInt32)(10 + i);
+
+    addr.field_type = DBF_DOUBLE;
+    addr.field_size = sizeof(dfield[0]);
+    addr.pfield = dfield;
+
+    dbPutConvertRoutine[DBR_LONG][DBF_DOUBLE](&addr, lbuf, 4, 7, 5);
+    testOk(dfield[5]==10.0 && dfield[6]==11.0 && dfield[0]==12.0 && dfield[1]==13.0 &&
+           dfield[2]==0.0 && dfield[4]==0.0,
+           "%g %g %g %g %g %g", dfield[5], dfield[6], dfield[0], dfield[1], dfield[2], dfield[4]);
+
+    dbPutConvertRoutine[DBR_LONG][DBF_DOUBLE](&addr, lbuf, 3, 7, 1);
+    testOk1(dfield[1]==10.0 && dfield[3]==12.0 && dfield[4]==0.0);
+}
+
 MAIN(testdbConvert)
 {
-    testPlan(15);
+    testPlan(19);
     testBasicGet();
     testBasicPut();
+    testConvertWrap();
     return testDone();
 }
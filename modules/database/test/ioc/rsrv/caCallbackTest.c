@@ -0,0 +1,410 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Tests of the callback thread pool (EPICS_CA_CALLBACK_THREADS): where
+ *  and in what order callbacks run, and clearing subscriptions and
+ *  channels while one of their callbacks is running, from the thread
+ *  running it and from another one.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cadef.h"
+#include "envDefs.h"
+#include "epicsEvent.h"
+#include "epicsMutex.h"
+#include "epicsThread.h"
+#include "epicsTime.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#include "caTestIoc.h"
+
+#define NPUTS 50
+#define HOLD 0.5
+
+#define NPAIR 8
+
+static epicsMutexId lock;
+static epicsEventId entered, release, done;
+
+/* protected by lock */
+static unsigned nCalls, nOffPool, nOutOfOrder;
+static double last;
+static int blocking, running, nameOk;
+static int poolThread[NPAIR];
+static chid clearTarget;
+static double clearTime;
+static int clearRunning;
+
+static int onPoolThread(void)
+{
+    return strncmp(epicsThreadGetNameSelf(), "CAC-callback-", 13) == 0;
+}
+
+static void orderMonitor(struct event_handler_args args)
+{
+    double value = *(const double *) args.dbr;
+
+    epicsMutexMustLock(lock);
+    nCalls++;
+    if (!onPoolThread())
+        nOffPool++;
+    if (value < last)
+        nOutOfOrder++;
+    last = value;
+    epicsMutexUnlock(lock);
+    if (value == NPUTS)
+        epicsEventMustTrigger(done);
+}
+
+/* the first update after blocking is set waits until released */
+static void blockMonitor(struct event_handler_args args)
+{
+    int block;
+
+    epicsMutexMustLock(lock);
+    nCalls++;
+    block = blocking;
+    blocking = 0;
+    running = 1;
+    epicsMutexUnlock(lock);
+
+    if (block) {
+        epicsEventMustTrigger(entered);
+        epicsEventMustWait(release);
+        /* the channel must still be usable */
+        epicsMutexMustLock(lock);
+        nameOk = strcmp(ca_name(args.chid), (const char *) args.usr) == 0;
+        epicsMutexUnlock(lock);
+    }
+
+    epicsMutexMustLock(lock);
+    running = 0;
+    epicsMutexUnlock(lock);
+}
+
+static void selfClearMonitor(struct event_handler_args args)
+{
+    int status = ca_clear_channel(args.chid);
+
+    epicsMutexMustLock(lock);
+    nCalls++;
+    nameOk = status == ECA_NORMAL;
+    epicsMutexUnlock(lock);
+    epicsEventMustTrigger(done);
+}
+
+static void threadMonitor(struct event_handler_args args)
+{
+    const char *name = epicsThreadGetNameSelf();
+    int index = (int) (size_t) args.usr;
+
+    epicsMutexMustLock(lock);
+    poolThread[index] = onPoolThread() ? name[13] - '0' : -1;
+    epicsMutexUnlock(lock);
+}
+
+static void releaser(void *arg);
+
+/* clears the target channel once it is set */
+static void clearMonitor(struct event_handler_args args)
+{
+    epicsTimeStamp start, now;
+    chid target;
+
+    epicsMutexMustLock(lock);
+    target = clearTarget;
+    clearTarget = NULL;
+    epicsMutexUnlock(lock);
+    if (!target)
+        return;
+
+    epicsThreadMustCreate("releaser", epicsThreadPriorityMedium,
+        epicsThreadGetStackSize(epicsThreadStackSmall), releaser, NULL);
+    epicsTimeGetCurrent(&start);
+    ca_clear_channel(target);
+    epicsTimeGetCurrent(&now);
+
+    epicsMutexMustLock(lock);
+    clearRunning = running;
+    clearTime = epicsTimeDiffInSeconds(&now, &start);
+    epicsMutexUnlock(lock);
+    epicsEventMustTrigger(done);
+}
+
+static void releaser(void *arg)
+{
+    epicsThreadSleep(HOLD);
+    epicsEventMustTrigger(release);
+}
+
+static void reset(void)
+{
+    epicsMutexMustLock(lock);
+    nCalls = nOffPool = nOutOfOrder = 0;
+    last = 0.0;
+    blocking = running = nameOk = 0;
+    epicsMutexUnlock(lock);
+}
+
+static void put(chid chan, double value)
+{
+    ca_array_put(DBR_DOUBLE, 1, chan, &value);
+    ca_flush_io();
+}
+
+static void testDispatch(void)
+{
+    chid chan;
+    evid id;
+    unsigned i;
+
+    testDiag("Callbacks run on the pool threads, in order");
+
+    reset();
+    ca_create_channel("cb:order", NULL, NULL, CA_PRIORITY_DEFAULT, &chan);
+    ca_pend_io(5.0);
+    ca_create_subscription(DBR_DOUBLE, 1, chan, DBE_VALUE, orderMonitor,
+        NULL, &id);
+    ca_flush_io();
+    for (i = 1; i <= NPUTS; i++)
+        put(chan, i);
+    testOk(epicsEventWaitWithTimeout(done, 5.0) == epicsEventOK,
+        "Last update arrived");
+    epicsMutexMustLock(lock);
+    testOk(nCalls > 0 && nOffPool == 0, "%u callbacks, %u not on the pool",
+        nCalls, nOffPool);
+    testOk(nOutOfOrder == 0, "%u updates out of order", nOutOfOrder);
+    epicsMutexUnlock(lock);
+
+    ca_clear_subscription(id);
+    ca_clear_channel(chan);
+}
+
+static void testClearSubscription(chid chan)
+{
+    epicsTimeStamp start, now;
+    evid id;
+    unsigned count;
+    int wasRunning;
+
+    testDiag("Clearing a subscription while its callback runs");
+
+    reset();
+    ca_create_subscription(DBR_DOUBLE, 1, chan, DBE_VALUE, blockMonitor,
+        "cb:block", &id);
+    ca_flush_io();
+    epicsThreadSleep(0.2);      /* the initial update */
+
+    epicsMutexMustLock(lock);
+    nCalls = 0;
+    blocking = 1;
+    epicsMutexUnlock(lock);
+    put(chan, 1.0);
+    testOk(epicsEventWaitWithTimeout(entered, 5.0) == epicsEventOK,
+        "Callback is running");
+
+    /* these updates are queued behind the running callback */
+    put(chan, 2.0);
+    put(chan, 3.0);
+    epicsThreadSleep(0.1);
+
+    epicsThreadMustCreate("releaser", epicsThreadPriorityMedium,
+        epicsThreadGetStackSize(epicsThreadStackSmall), releaser, NULL);
+    epicsTimeGetCurrent(&start);
+    ca_clear_subscription(id);
+    epicsTimeGetCurrent(&now);
+
+    epicsMutexMustLock(lock);
+    wasRunning = running;
+    epicsMutexUnlock(lock);
+    testOk(!wasRunning && epicsTimeDiffInSeconds(&now, &start) > HOLD / 2,
+        "ca_clear_subscription() waited %.3f seconds for the callback",
+        epicsTimeDiffInSeconds(&now, &start));
+
+    epicsThreadSleep(0.2);
+    epicsMutexMustLock(lock);
+    count = nCalls;
+    epicsMutexUnlock(lock);
+    testOk(count == 1, "Queued updates were discarded (%u callbacks)", count);
+}
+
+static void testClearChannel(chid chan)
+{
+    epicsTimeStamp start, now;
+    evid id;
+    int wasRunning, ok;
+
+    testDiag("Clearing a channel while its callback runs");
+
+    reset();
+    ca_create_subscription(DBR_DOUBLE, 1, chan, DBE_VALUE, blockMonitor,
+        "cb:block", &id);
+    ca_flush_io();
+    epicsThreadSleep(0.2);
+
+    epicsMutexMustLock(lock);
+    blocking = 1;
+    epicsMutexUnlock(lock);
+    put(chan, 4.0);
+    testOk(epicsEventWaitWithTimeout(entered, 5.0) == epicsEventOK,
+        "Callback is running");
+
+    epicsThreadMustCreate("releaser", epicsThreadPriorityMedium,
+        epicsThreadGetStackSize(epicsThreadStackSmall), releaser, NULL);
+    epicsTimeGetCurrent(&start);
+    ca_clear_channel(chan);
+    epicsTimeGetCurrent(&now);
+
+    epicsMutexMustLock(lock);
+    wasRunning = running;
+    ok = nameOk;
+    epicsMutexUnlock(lock);
+    testOk(!wasRunning && epicsTimeDiffInSeconds(&now, &start) > HOLD / 2,
+        "ca_clear_channel() waited %.3f seconds for the callback",
+        epicsTimeDiffInSeconds(&now, &start));
+    testOk(ok, "The callback could still use the channel");
+}
+
+static void testClearSelf(void)
+{
+    chid chan;
+    evid id;
+    int ok;
+
+    testDiag("A callback clearing its own channel");
+
+    reset();
+    ca_create_channel("cb:self", NULL, NULL, CA_PRIORITY_DEFAULT, &chan);
+    ca_pend_io(5.0);
+    ca_create_subscription(DBR_DOUBLE, 1, chan, DBE_VALUE, selfClearMonitor,
+        NULL, &id);
+    ca_flush_io();
+    testOk(epicsEventWaitWithTimeout(done, 5.0) == epicsEventOK,
+        "Callback returned");
+    epicsMutexMustLock(lock);
+    ok = nameOk;
+    epicsMutexUnlock(lock);
+    testOk(ok, "ca_clear_channel() succeeded");
+}
+
+static void testClearOther(void)
+{
+    chid chans[NPAIR];
+    evid ids[NPAIR];
+    char names[NPAIR][16];
+    int i, first = -1, other = -1;
+    int wasRunning, ok;
+    double elapsed;
+    evid id;
+
+    testDiag("A callback clearing a channel run by another pool thread");
+
+    /* find two channels whose callbacks run on different threads */
+    for (i = 0; i < NPAIR; i++) {
+        sprintf(names[i], "cb:pair%d", i);
+        poolThread[i] = -1;
+        ca_create_channel(names[i], NULL, NULL, CA_PRIORITY_DEFAULT,
+            &chans[i]);
+    }
+    if (ca_pend_io(5.0) != ECA_NORMAL)
+        testAbort("Channels didn't connect");
+    for (i = 0; i < NPAIR; i++)
+        ca_create_subscription(DBR_DOUBLE, 1, chans[i], DBE_VALUE,
+            threadMonitor, (void *) (size_t) i, &ids[i]);
+    ca_flush_io();
+    epicsThreadSleep(0.5);
+    epicsMutexMustLock(lock);
+    for (i = 0; i < NPAIR; i++) {
+        if (poolThread[i] < 0)
+            continue;
+        if (first < 0)
+            first = i;
+        else if (poolThread[i] != poolThread[first] && other < 0)
+            other = i;
+    }
+    epicsMutexUnlock(lock);
+    for (i = 0; i < NPAIR; i++)
+        ca_clear_subscription(ids[i]);
+
+    if (first < 0 || other < 0) {
+        testSkip(3, "All of the channels are run by one thread");
+    }
+    else {
+        reset();
+        ca_create_subscription(DBR_DOUBLE, 1, chans[first], DBE_VALUE,
+            blockMonitor, names[first], &id);
+        ca_create_subscription(DBR_DOUBLE, 1, chans[other], DBE_VALUE,
+            clearMonitor, NULL, &ids[other]);
+        ca_flush_io();
+        epicsThreadSleep(0.2);
+
+        epicsMutexMustLock(lock);
+        blocking = 1;
+        epicsMutexUnlock(lock);
+        put(chans[first], 1.0);
+        testOk(epicsEventWaitWithTimeout(entered, 5.0) == epicsEventOK,
+            "Callback on thread %d is running", poolThread[first]);
+
+        epicsMutexMustLock(lock);
+        clearTarget = chans[first];
+        epicsMutexUnlock(lock);
+        put(chans[other], 1.0);
+        if (epicsEventWaitWithTimeout(done, 5.0) != epicsEventOK)
+            testAbort("ca_clear_channel() didn't return");
+
+        epicsMutexMustLock(lock);
+        wasRunning = clearRunning;
+        elapsed = clearTime;
+        ok = nameOk;
+        epicsMutexUnlock(lock);
+        testOk(!wasRunning && elapsed > HOLD / 2,
+            "ca_clear_channel() on thread %d waited %.3f seconds",
+            poolThread[other], elapsed);
+        testOk(ok, "The callback could still use the channel");
+        chans[first] = NULL;
+    }
+
+    for (i = 0; i < NPAIR; i++)
+        if (chans[i])
+            ca_clear_channel(chans[i]);
+}
+
+MAIN(caCallbackTest)
+{
+    chid chan;
+
+    testPlan(14);
+
+    lock = epicsMutexMustCreate();
+    entered = epicsEventMustCreate(epicsEventEmpty);
+    release = epicsEventMustCreate(epicsEventEmpty);
+    done = epicsEventMustCreate(epicsEventEmpty);
+
+    caTestIocEnv(55150);
+    epicsEnvSet("EPICS_CA_CALLBACK_THREADS", "2");
+    if (ca_context_create(ca_enable_preemptive_callback) != ECA_NORMAL)
+        testAbort("Failed to create the CA context");
+    caTestIocStart("caCallbackTest.db", NULL);
+
+    testDispatch();
+
+    ca_create_channel("cb:block", NULL, NULL, CA_PRIORITY_DEFAULT, &chan);
+    if (ca_pend_io(5.0) != ECA_NORMAL)
+        testAbort("Channel didn't connect");
+    testClearSubscription(chan);
+    testClearChannel(chan);
+
+    testClearSelf();
+    testClearOther();
+
+    ca_context_destroy();
+
+    return testDone();
+}
@@ -0,0 +1,206 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Tests of ca_create_channels() and ca_create_subscriptions()
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cadef.h"
+#include "dbDefs.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#include "caTestIoc.h"
+
+#define NMANY 3000
+
+static const char * const names[] = {
+    "bulk:a", "bulk:b", "", "bulk:c", "bulk:d"
+};
+static chid chans[NELEMENTS(names)];
+
+static double values[] = {1, 2, 3, 4};
+static unsigned nUpdates[NELEMENTS(values)];
+static unsigned nWrong;
+
+static void monitor(struct event_handler_args args)
+{
+    double *pExpect = (double *) args.usr;
+
+    if (args.status != ECA_NORMAL || args.type != DBR_DOUBLE ||
+        *(const double *) args.dbr != *pExpect)
+        nWrong++;
+    else
+        nUpdates[pExpect - values]++;
+}
+
+static void testCreateChannels(void)
+{
+    void *users[NELEMENTS(names)];
+    unsigned i, nBad = 0;
+    int status;
+
+    testDiag("Create channels in one call");
+
+    for (i = 0; i < NELEMENTS(names); i++)
+        users[i] = &users[i];
+    status = ca_create_channels(NELEMENTS(names), names, NULL, users,
+        CA_PRIORITY_DEFAULT, chans);
+    testOk(status == ECA_BADSTR, "Empty name fails (%s)", ca_message(status));
+    testOk(chans[2] == NULL, "Failed channel id is NULL");
+
+    status = ca_pend_io(5.0);
+    testOk(status == ECA_NORMAL, "Channels connect (%s)", ca_message(status));
+    for (i = 0; i < NELEMENTS(names); i++) {
+        if (i == 2)
+            continue;
+        if (!chans[i] || ca_state(chans[i]) != cs_conn ||
+            ca_puser(chans[i]) != users[i] ||
+            strcmp(ca_name(chans[i]), names[i]) != 0)
+            nBad++;
+    }
+    testOk(nBad == 0, "Channels have their own names and user private "
+        "values (%u wrong)", nBad);
+
+    testOk1(ca_create_channels(0, names, NULL, NULL, CA_PRIORITY_DEFAULT,
+        chans) == ECA_NORMAL);
+}
+
+static void testManyChannels(void)
+{
+    const char **many = calloc(NMANY, sizeof(*many));
+    chid *manyIds = calloc(NMANY, sizeof(*manyIds));
+    unsigned i, nBad = 0;
+    int status;
+
+    testDiag("Create %u channels in one call", NMANY);
+
+    if (!many || !manyIds)
+        testAbort("Out of memory");
+    for (i = 0; i < NMANY; i++)
+        many[i] = names[i % 2];
+    status = ca_create_channels(NMANY, many, NULL, NULL,
+        CA_PRIORITY_DEFAULT, manyIds);
+    testOk(status == ECA_NORMAL, "Created %u channels (%s)", NMANY,
+        ca_message(status));
+    status = ca_pend_io(10.0);
+    testOk(status == ECA_NORMAL, "Channels connect (%s)", ca_message(status));
+    for (i = 0; i < NMANY; i++) {
+        if (!manyIds[i] || ca_state(manyIds[i]) != cs_conn ||
+            ca_puser(manyIds[i]) != NULL)
+            nBad++;
+    }
+    testOk(nBad == 0, "All are connected, with NULL user private values "
+        "(%u wrong)", nBad);
+
+    for (i = 0; i < NMANY; i++)
+        if (manyIds[i])
+            ca_clear_channel(manyIds[i]);
+    free(manyIds);
+    free(many);
+}
+
+static void testCreateSubscriptions(void)
+{
+    chid good[NELEMENTS(values)];
+    void *args[NELEMENTS(values)];
+    evid ids[NELEMENTS(values)];
+    unsigned i, nMissing, nIds = 0;
+    int status, loops;
+
+    testDiag("Subscribe in one call");
+
+    for (i = 0; i < NELEMENTS(values); i++) {
+        good[i] = chans[i < 2 ? i : i + 1];
+        args[i] = &values[i];
+    }
+
+    status = ca_create_subscriptions(NELEMENTS(good), DBR_DOUBLE, 1, good,
+        0, monitor, args, ids);
+    testOk(status == ECA_BADMASK, "Empty mask is rejected (%s)",
+        ca_message(status));
+
+    status = ca_create_subscriptions(NELEMENTS(good), DBR_DOUBLE, 1, good,
+        DBE_VALUE, monitor, args, ids);
+    testOk(status == ECA_NORMAL, "Subscribed (%s)", ca_message(status));
+    for (i = 0; i < NELEMENTS(ids); i++)
+        nIds += ids[i] != NULL;
+    testOk(nIds == NELEMENTS(ids), "%u subscription ids set", nIds);
+
+    for (loops = 0; loops < 50; loops++) {
+        ca_pend_event(0.1);
+        for (nMissing = 0, i = 0; i < NELEMENTS(values); i++)
+            nMissing += nUpdates[i] == 0;
+        if (!nMissing)
+            break;
+    }
+    testOk(nMissing == 0 && nWrong == 0,
+        "Each subscription got its own value and argument "
+        "(%u missing, %u wrong)", nMissing, nWrong);
+
+    for (i = 0; i < NELEMENTS(ids); i++)
+        if (ids[i])
+            ca_clear_subscription(ids[i]);
+}
+
+static void ignore(struct event_handler_args args)
+{
+}
+
+static void testChained(void)
+{
+    chid none[2] = {NULL, NULL};
+    evid ids[NELEMENTS(names)];
+    unsigned i, nIds = 0;
+    int status;
+
+    testDiag("Subscribe to the ids written by ca_create_channels()");
+
+    status = ca_create_subscriptions(NELEMENTS(chans), DBR_DOUBLE, 1, chans,
+        DBE_VALUE, ignore, NULL, ids);
+    testOk(status == ECA_BADCHID, "NULL channel id fails (%s)",
+        ca_message(status));
+    for (i = 0; i < NELEMENTS(ids); i++)
+        nIds += ids[i] != NULL;
+    testOk(ids[2] == NULL && nIds == NELEMENTS(ids) - 1,
+        "The others were subscribed (%u ids set)", nIds);
+    for (i = 0; i < NELEMENTS(ids); i++)
+        if (ids[i])
+            ca_clear_subscription(ids[i]);
+
+    ids[0] = ids[1] = (evid) &none;
+    status = ca_create_subscriptions(2, DBR_DOUBLE, 1, none,
+        DBE_VALUE, ignore, NULL, ids);
+    testOk(status == ECA_BADCHID && ids[0] == NULL && ids[1] == NULL,
+        "Only NULL channel ids fail (%s)", ca_message(status));
+}
+
+MAIN(caChannelsTest)
+{
+    unsigned i;
+
+    testPlan(15);
+
+    caTestIocEnv(55120);
+    if (ca_context_create(ca_disable_preemptive_callback) != ECA_NORMAL)
+        testAbort("Failed to create the CA context");
+    caTestIocStart("caChannelsTest.db", NULL);
+
+    testCreateChannels();
+    testManyChannels();
+    testCreateSubscriptions();
+    testChained();
+
+    for (i = 0; i < NELEMENTS(chans); i++)
+        if (chans[i])
+            ca_clear_channel(chans[i]);
+    ca_context_destroy();
+
+    return testDone();
+}
@@ -0,0 +1,159 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Tests of automatic flushing with both EPICS_CA_FLUSH_DELAY and
+ *  EPICS_CA_FLUSH_BYTES set. The test never flushes or pends, so only
+ *  the library can send its requests.
+ */
+
+#include "cadef.h"
+#include "envDefs.h"
+#include "epicsEvent.h"
+#include "epicsMutex.h"
+#include "epicsThread.h"
+#include "epicsTime.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#include "caTestIoc.h"
+
+#define DELAY 2.0
+#define NSMALL 10
+#define NBIG 500     /* doubles, more than EPICS_CA_FLUSH_BYTES */
+
+static epicsEventId done;
+static epicsMutexId lock;
+static unsigned nDone, nFailed;
+static double wf[NBIG];
+
+static void putDone(struct event_handler_args args)
+{
+    epicsMutexMustLock(lock);
+    nDone++;
+    if (args.status != ECA_NORMAL)
+        nFailed++;
+    epicsMutexUnlock(lock);
+    epicsEventMustTrigger(done);
+}
+
+/* Wait for n callbacks, returns the seconds since start */
+static double waitFor(unsigned n, const epicsTimeStamp *start)
+{
+    epicsTimeStamp now;
+
+    for (;;) {
+        unsigned count;
+
+        epicsMutexMustLock(lock);
+        count = nDone;
+        epicsMutexUnlock(lock);
+        if (count >= n ||
+            epicsEventWaitWithTimeout(done, 5 * DELAY) != epicsEventOK)
+            break;
+    }
+    epicsTimeGetCurrent(&now);
+    return epicsTimeDiffInSeconds(&now, start);
+}
+
+static void reset(epicsTimeStamp *start)
+{
+    epicsMutexMustLock(lock);
+    nDone = nFailed = 0;
+    epicsMutexUnlock(lock);
+    epicsTimeGetCurrent(start);
+}
+
+static void testDelay(chid ao)
+{
+    epicsTimeStamp start;
+    double value = 1.0, t;
+    unsigned i;
+
+    testDiag("Small requests are sent after the flush delay");
+
+    reset(&start);
+    for (i = 0; i < NSMALL; i++)
+        ca_array_put_callback(DBR_DOUBLE, 1, ao, &value, putDone, NULL);
+    t = waitFor(NSMALL, &start);
+    testOk(nDone == NSMALL && nFailed == 0, "%u of %u puts completed",
+        nDone, NSMALL);
+    testOk(t >= 0.75 * DELAY && t < 5 * DELAY,
+        "They were sent after %.3f seconds", t);
+}
+
+static void testBytes(chid wfChan)
+{
+    epicsTimeStamp start;
+    double t;
+
+    testDiag("A large request is sent without waiting");
+
+    reset(&start);
+    ca_array_put_callback(DBR_DOUBLE, NBIG, wfChan, wf, putDone, NULL);
+    t = waitFor(1, &start);
+    testOk(nDone == 1 && nFailed == 0, "Put completed");
+    testOk(t < 0.75 * DELAY, "It was sent after %.3f seconds", t);
+}
+
+static void testBoth(chid ao, chid wfChan)
+{
+    epicsTimeStamp start;
+    double value = 2.0, t;
+
+    testDiag("Requests queued before a large one go with it");
+
+    reset(&start);
+    ca_array_put_callback(DBR_DOUBLE, 1, ao, &value, putDone, NULL);
+    ca_array_put_callback(DBR_DOUBLE, NBIG, wfChan, wf, putDone, NULL);
+    t = waitFor(2, &start);
+    testOk(nDone == 2 && nFailed == 0, "%u of 2 puts completed", nDone);
+    testOk(t < 0.75 * DELAY, "They were sent after %.3f seconds", t);
+
+    testDiag("The delay still applies after the timer expired unused");
+
+    epicsThreadSleep(1.5 * DELAY);
+    reset(&start);
+    ca_array_put_callback(DBR_DOUBLE, 1, ao, &value, putDone, NULL);
+    t = waitFor(1, &start);
+    testOk(nDone == 1 && nFailed == 0, "Put completed");
+    testOk(t >= 0.75 * DELAY && t < 5 * DELAY,
+        "It was sent after %.3f seconds", t);
+}
+
+MAIN(caFlushTest)
+{
+    chid ao, wfChan;
+
+    testPlan(8);
+
+    done = epicsEventMustCreate(epicsEventEmpty);
+    lock = epicsMutexMustCreate();
+
+    caTestIocEnv(55140);
+    epicsEnvSet("EPICS_CA_FLUSH_DELAY", "2.0");
+    epicsEnvSet("EPICS_CA_FLUSH_BYTES", "2000");
+    if (ca_context_create(ca_enable_preemptive_callback) != ECA_NORMAL)
+        testAbort("Failed to create the CA context");
+    caTestIocStart("caFlushTest.db", NULL);
+
+    ca_create_channel("flush:ao", NULL, NULL, CA_PRIORITY_DEFAULT, &ao);
+    ca_create_channel("flush:wf", NULL, NULL, CA_PRIORITY_DEFAULT, &wfChan);
+    if (ca_pend_io(5.0) != ECA_NORMAL)
+        testAbort("Channels didn't connect");
+
+    testDelay(ao);
+    testBytes(wfChan);
+    testBoth(ao, wfChan);
+
+    ca_clear_channel(ao);
+    ca_clear_channel(wfChan);
+    ca_context_destroy();
+    epicsMutexDestroy(lock);
+    epicsEventDestroy(done);
+
+    return testDone();
+}
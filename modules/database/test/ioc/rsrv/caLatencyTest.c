@@ -0,0 +1,164 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS Base is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Tests of the client side measurements: the latency summaries of
+ *  ca_client_latency(), the byte counts of ca_client_message_bytes(),
+ *  and ca_round_trip_time().
+ */
+
+#include "cadef.h"
+#include "caProto.h"
+#include "epicsThread.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#include "caTestIoc.h"
+
+#define NGETS 5
+#define NPUTS 3
+
+static unsigned nPutDone;
+
+static void putDone(struct event_handler_args args)
+{
+    if (args.status == ECA_NORMAL)
+        nPutDone++;
+}
+
+static unsigned count(enum ca_latency_select select)
+{
+    struct ca_latency_summary summary;
+
+    if (ca_client_latency(select, &summary) != ECA_NORMAL)
+        return 0u;
+    return summary.count;
+}
+
+/* the percentiles are upper bounds, at most 25% above the times */
+static void testSummary(enum ca_latency_select select, const char *name)
+{
+    struct ca_latency_summary s;
+    int status = ca_client_latency(select, &s);
+
+    testOk(status == ECA_NORMAL && s.count > 0 && s.mean > 0.0 &&
+        s.mean <= s.max && s.p50 <= s.p90 && s.p90 <= s.p99 &&
+        s.p99 <= 1.25 * s.max && s.max < 5.0,
+        "%s: %u samples, mean %.6f, p50 %.6f, p90 %.6f, p99 %.6f, "
+        "max %.6f", name, s.count, s.mean, s.p50, s.p90, s.p99, s.max);
+}
+
+static void testArguments(void)
+{
+    struct ca_latency_summary summary;
+    double sent, received;
+
+    testDiag("Invalid arguments");
+
+    testOk1(ca_client_latency((enum ca_latency_select) 99, &summary) ==
+        ECA_BADTYPE);
+    testOk1(ca_client_message_bytes(CA_PROTO_LAST_CMMD + 1u, &sent,
+        &received) == ECA_BADTYPE);
+    testOk(count(ca_latency_get) == 0u, "No get times yet");
+}
+
+static void testConnect(chid *pChan)
+{
+    chid other;
+
+    testDiag("Search and connect times, and the round trip time");
+
+    ca_create_channel("lat:ao", NULL, NULL, CA_PRIORITY_DEFAULT, pChan);
+    if (ca_pend_io(5.0) != ECA_NORMAL)
+        testAbort("Channel didn't connect");
+    testSummary(ca_latency_search, "search");
+    testSummary(ca_latency_connect, "connect");
+
+    /* the round trip time is measured once the circuit connects */
+    epicsThreadSleep(0.5);
+    testOk(ca_round_trip_time(*pChan) > 0.0 &&
+        ca_round_trip_time(*pChan) < 5.0,
+        "Round trip time %.6f sec", ca_round_trip_time(*pChan));
+    testSummary(ca_latency_echo, "echo");
+
+    ca_create_channel("lat:none", NULL, NULL, CA_PRIORITY_DEFAULT, &other);
+    testOk(ca_round_trip_time(other) < 0.0,
+        "Unknown for a channel that isn't connected");
+    ca_clear_channel(other);
+}
+
+static void testGet(chid chan)
+{
+    double sent0, received0, sent, received, value;
+    unsigned count0 = count(ca_latency_get);
+    unsigned i;
+
+    testDiag("Get times and byte counts");
+
+    ca_client_message_bytes(CA_PROTO_READ_NOTIFY, &sent0, &received0);
+    for (i = 0; i < NGETS; i++) {
+        ca_array_get(DBR_DOUBLE, 1, chan, &value);
+        ca_pend_io(5.0);
+    }
+    testOk(count(ca_latency_get) == count0 + NGETS, "%u gets timed",
+        count(ca_latency_get) - count0);
+    testSummary(ca_latency_get, "get");
+
+    /* a header each, and a double padded to 8 bytes in the responses */
+    ca_client_message_bytes(CA_PROTO_READ_NOTIFY, &sent, &received);
+    testOk(sent - sent0 == NGETS * 16.0, "%g bytes sent", sent - sent0);
+    testOk(received - received0 == NGETS * 24.0, "%g bytes received",
+        received - received0);
+}
+
+static void testPutCallback(chid chan)
+{
+    double sent0, received0, sent, received;
+    unsigned count0 = count(ca_latency_put_callback);
+    unsigned i;
+
+    testDiag("Put callback times and byte counts");
+
+    ca_client_message_bytes(CA_PROTO_WRITE_NOTIFY, &sent0, &received0);
+    for (i = 0; i < NPUTS; i++) {
+        double value = i;
+
+        ca_array_put_callback(DBR_DOUBLE, 1, chan, &value, putDone, NULL);
+        ca_flush_io();
+    }
+    for (i = 0; i < 50 && nPutDone < NPUTS; i++)
+        ca_pend_event(0.1);
+    testOk(nPutDone == NPUTS, "%u puts completed", nPutDone);
+    testOk(count(ca_latency_put_callback) == count0 + NPUTS,
+        "%u puts timed", count(ca_latency_put_callback) - count0);
+    testSummary(ca_latency_put_callback, "put callback");
+
+    ca_client_message_bytes(CA_PROTO_WRITE_NOTIFY, &sent, &received);
+    testOk(sent - sent0 == NPUTS * 24.0, "%g bytes sent", sent - sent0);
+    testOk(received - received0 == NPUTS * 16.0, "%g bytes received",
+        received - received0);
+}
+
+MAIN(caLatencyTest)
+{
+    chid chan;
+
+    testPlan(17);
+
+    caTestIocEnv(55170);
+    if (ca_context_create(ca_disable_preemptive_callback) != ECA_NORMAL)
+        testAbort("Failed to create the CA context");
+    caTestIocStart("caLatencyTest.db", NULL);
+
+    testArguments();
+    testConnect(&chan);
+    testGet(chan);
+    testPutCallback(chan);
+
+    ca_context_destroy();
+
+    return testDone();
+}
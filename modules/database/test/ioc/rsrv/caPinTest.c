@@ -0,0 +1,178 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Tests of ca_pin_event_data() and ca_unpin_event_data()
+ */
+
+#include "cadef.h"
+#include "epicsEvent.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#include "caTestIoc.h"
+
+#define NELM 5000
+#define NPUTS 4
+
+static epicsEventId updated;
+static double buf[NELM];
+
+/* state of the waveform monitor, only used by the callback thread
+ * until it signals the main thread */
+static unsigned nUpdates;
+static ca_pinned_data *pPinned;
+static const double *pPinnedData;
+static double pinnedFirst;
+static unsigned nPinned, nKept, nOthers;
+
+static void wfMonitor(struct event_handler_args args)
+{
+    const double *pData = (const double *) args.dbr;
+
+    if (args.status != ECA_NORMAL)
+        return;
+
+    /* data pinned during the previous update must be unchanged */
+    if (pPinned) {
+        if (pPinnedData[0] == pinnedFirst && pPinnedData != pData)
+            nKept++;
+        ca_unpin_event_data(pPinned);
+    }
+
+    /* only the callback's own data can be pinned */
+    if (ca_pin_event_data(pData + 1) || ca_pin_event_data(NULL))
+        nOthers++;
+
+    pPinned = ca_pin_event_data(args.dbr);
+    if (pPinned) {
+        nPinned++;
+        pPinnedData = pData;
+        pinnedFirst = pData[0];
+    }
+    nUpdates++;
+    epicsEventMustTrigger(updated);
+}
+
+static ca_pinned_data *pGetPinned;
+static const double *pGetData;
+static double getValue;
+
+/* pins the data if the user argument is not NULL */
+static void aoGet(struct event_handler_args args)
+{
+    if (args.status == ECA_NORMAL) {
+        if (args.usr) {
+            pGetPinned = ca_pin_event_data(args.dbr);
+            pGetData = (const double *) args.dbr;
+        }
+        getValue = *(const double *) args.dbr;
+    }
+    epicsEventMustTrigger(updated);
+}
+
+static void putWaveform(chid chan, double first)
+{
+    unsigned k;
+
+    for (k = 0; k < NELM; k++)
+        buf[k] = first + k;
+    ca_array_put(DBR_DOUBLE, NELM, chan, buf);
+    ca_flush_io();
+}
+
+static void testSubscription(chid wf)
+{
+    evid id;
+    unsigned i;
+    int status;
+
+    testDiag("Pin monitor data of %u doubles", NELM);
+
+    status = ca_create_subscription(DBR_DOUBLE, NELM, wf, DBE_VALUE,
+        wfMonitor, NULL, &id);
+    testOk(status == ECA_NORMAL, "Subscribed (%s)", ca_message(status));
+    ca_flush_io();
+    testOk(epicsEventWaitWithTimeout(updated, 5.0) == epicsEventOK,
+        "Initial update");
+
+    for (i = 1; i <= NPUTS; i++) {
+        putWaveform(wf, i * 10000.0);
+        if (epicsEventWaitWithTimeout(updated, 5.0) != epicsEventOK)
+            break;
+    }
+    testOk(nUpdates == NPUTS + 1, "%u updates", nUpdates);
+    testOk(nPinned == nUpdates, "Data pinned inside %u callbacks", nPinned);
+    testOk(nKept == NPUTS, "Pinned data kept through %u later updates, "
+        "then unpinned in a callback", nKept);
+    testOk(nOthers == 0, "Other pointers can't be pinned");
+    testOk(pPinned && pPinnedData[0] == NPUTS * 10000.0 &&
+        pPinnedData[NELM - 1] == NPUTS * 10000.0 + NELM - 1,
+        "Last pinned update holds the last values put");
+
+    /* the main thread isn't running a callback */
+    testOk(ca_pin_event_data(pPinnedData) == NULL,
+        "Pinning from another thread returns NULL");
+
+    ca_clear_subscription(id);
+    ca_unpin_event_data(pPinned);
+    ca_unpin_event_data(NULL);
+    testPass("Unpinned outside the callback");
+}
+
+static void testGet(chid ao)
+{
+    double value = 43.0;
+    int status;
+
+    testDiag("Pin get callback data");
+
+    status = ca_array_get_callback(DBR_DOUBLE, 1, ao, aoGet, &pGetPinned);
+    testOk(status == ECA_NORMAL, "Get requested (%s)", ca_message(status));
+    ca_flush_io();
+    testOk(epicsEventWaitWithTimeout(updated, 5.0) == epicsEventOK,
+        "Get callback ran");
+    testOk(pGetPinned != NULL, "Scalar data pinned");
+
+    /* the next response is received into a new buffer */
+    ca_array_put(DBR_DOUBLE, 1, ao, &value);
+    ca_array_get_callback(DBR_DOUBLE, 1, ao, aoGet, NULL);
+    ca_flush_io();
+    epicsEventWaitWithTimeout(updated, 5.0);
+    testOk(pGetData && *pGetData == 42.0 && getValue == 43.0,
+        "Pinned value %g kept after getting %g",
+        pGetData ? *pGetData : 0.0, getValue);
+    ca_unpin_event_data(pGetPinned);
+}
+
+MAIN(caPinTest)
+{
+    chid wf, ao;
+
+    testPlan(13);
+
+    updated = epicsEventMustCreate(epicsEventEmpty);
+
+    caTestIocEnv(55130);
+    if (ca_context_create(ca_enable_preemptive_callback) != ECA_NORMAL)
+        testAbort("Failed to create the CA context");
+    caTestIocStart("caPinTest.db", NULL);
+
+    ca_create_channel("pin:wf", NULL, NULL, CA_PRIORITY_DEFAULT, &wf);
+    ca_create_channel("pin:ao", NULL, NULL, CA_PRIORITY_DEFAULT, &ao);
+    if (ca_pend_io(5.0) != ECA_NORMAL)
+        testAbort("Channels didn't connect");
+
+    testSubscription(wf);
+    testGet(ao);
+
+    ca_clear_channel(wf);
+    ca_clear_channel(ao);
+    ca_context_destroy();
+    epicsEventDestroy(updated);
+
+    return testDone();
+}
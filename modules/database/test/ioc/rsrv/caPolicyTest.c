@@ -0,0 +1,239 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS Base is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Tests of ca_set_subscription_policy(): the updates held back by the
+ *  windowed and budgeted policies, their delivery by the subscription
+ *  pacer, and changing the policy while an update is held.
+ */
+
+#include "cadef.h"
+#include "epicsMutex.h"
+#include "epicsThread.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#include "caTestIoc.h"
+
+#define NPUTS 10
+
+static epicsMutexId lock;
+
+/* protected by lock */
+static unsigned nCalls, nOutOfOrder;
+static double last;
+
+static void monitor(struct event_handler_args args)
+{
+    double value;
+
+    if (args.status != ECA_NORMAL)
+        return;
+    value = *(const double *) args.dbr;
+    epicsMutexMustLock(lock);
+    nCalls++;
+    if (value < last)
+        nOutOfOrder++;
+    last = value;
+    epicsMutexUnlock(lock);
+}
+
+static void snapshot(unsigned *pCalls, double *pLast)
+{
+    epicsMutexMustLock(lock);
+    *pCalls = nCalls;
+    *pLast = last;
+    epicsMutexUnlock(lock);
+}
+
+static void put(chid chan, double value)
+{
+    ca_array_put(DBR_DOUBLE, 1, chan, &value);
+    ca_flush_io();
+}
+
+static void putBurst(chid chan, double first)
+{
+    unsigned i;
+
+    for (i = 0; i < NPUTS; i++) {
+        put(chan, first + i);
+        epicsThreadSleep(0.01);
+    }
+}
+
+/* subscribes, and waits for the initial update */
+static evid subscribe(const char *name, chid *pChan,
+    enum ca_subscription_policy_select policy, double window, double budget)
+{
+    evid id;
+
+    epicsMutexMustLock(lock);
+    nCalls = nOutOfOrder = 0;
+    last = 0.0;
+    epicsMutexUnlock(lock);
+
+    ca_create_channel(name, NULL, NULL, CA_PRIORITY_DEFAULT, pChan);
+    if (ca_pend_io(5.0) != ECA_NORMAL)
+        testAbort("Channel %s didn't connect", name);
+    ca_create_subscription(DBR_DOUBLE, 1, *pChan, DBE_VALUE, monitor,
+        NULL, &id);
+    ca_set_subscription_policy(id, policy, window, budget);
+    ca_flush_io();
+    epicsThreadSleep(0.2);
+    return id;
+}
+
+static void testArguments(void)
+{
+    chid chan;
+    evid id = subscribe("pol:lossless", &chan, ca_subscription_lossless,
+        0.0, 0.0);
+
+    testDiag("Invalid arguments");
+
+    testOk1(ca_set_subscription_policy(id,
+        (enum ca_subscription_policy_select) 7, 0.0, 0.0) == ECA_BADTYPE);
+    testOk1(ca_set_subscription_policy(id, ca_subscription_windowed,
+        0.0, 0.0) == ECA_BADTYPE);
+    testOk1(ca_set_subscription_policy(id, ca_subscription_latest,
+        0.0, -1.0) == ECA_BADTYPE);
+    testOk1(ca_set_subscription_policy(id, ca_subscription_lossless,
+        0.0, 0.0) == ECA_NORMAL);
+
+    ca_clear_subscription(id);
+    ca_clear_channel(chan);
+}
+
+static void testLossless(void)
+{
+    chid chan;
+    evid id = subscribe("pol:lossless", &chan, ca_subscription_lossless,
+        0.0, 0.0);
+    unsigned count;
+    double value;
+
+    testDiag("Every update is delivered by default");
+
+    putBurst(chan, 1.0);
+    epicsThreadSleep(0.5);
+    snapshot(&count, &value);
+    testOk(count == NPUTS + 1, "%u updates delivered", count);
+    testOk(value == NPUTS, "Last value %g", value);
+
+    ca_clear_subscription(id);
+    ca_clear_channel(chan);
+}
+
+static void testWindowed(void)
+{
+    chid chan;
+    evid id = subscribe("pol:window", &chan, ca_subscription_windowed,
+        1.5, 0.0);
+    unsigned count;
+    double value;
+
+    testDiag("Windowed updates are held until the window ends");
+
+    snapshot(&count, &value);
+    testOk(count == 1, "Initial update delivered");
+
+    putBurst(chan, 1.0);
+    snapshot(&count, &value);
+    testOk(count == 1, "Updates within the window are held (%u delivered)",
+        count);
+
+    epicsThreadSleep(1.5);
+    snapshot(&count, &value);
+    testOk(count == 2, "One held update delivered by the pacer (%u)", count);
+    testOk(value == NPUTS, "It is the last one (%g)", value);
+
+    ca_clear_subscription(id);
+    ca_clear_channel(chan);
+}
+
+static void testBudget(void)
+{
+    chid chan;
+    /* one DBR_DOUBLE each half second */
+    evid id = subscribe("pol:budget", &chan, ca_subscription_latest,
+        0.0, 2.0 * dbr_size_n(DBR_DOUBLE, 1));
+    unsigned count;
+    double value;
+
+    testDiag("The budget limits the rate of the latest policy");
+
+    putBurst(chan, 1.0);
+    epicsThreadSleep(0.8);
+    snapshot(&count, &value);
+    testOk(count >= 2 && count <= 3, "%u updates delivered", count);
+    testOk(value == NPUTS, "The last was delivered (%g)", value);
+
+    ca_clear_subscription(id);
+    ca_clear_channel(chan);
+}
+
+static void testChange(void)
+{
+    chid chan;
+    evid id = subscribe("pol:change", &chan, ca_subscription_windowed,
+        2.0, 0.0);
+    unsigned count, nBad;
+    double value;
+
+    testDiag("Changing the policy while an update is held");
+
+    putBurst(chan, 1.0);
+    snapshot(&count, &value);
+    testOk(count == 1, "Updates held (%u delivered)", count);
+
+    testOk1(ca_set_subscription_policy(id, ca_subscription_lossless,
+        0.0, 0.0) == ECA_NORMAL);
+    epicsThreadSleep(0.2);
+    snapshot(&count, &value);
+    testOk(count == 2 && value == NPUTS,
+        "The held update is delivered at once (%u, %g)", count, value);
+
+    put(chan, 100.0);
+    epicsThreadSleep(0.2);
+    snapshot(&count, &value);
+    testOk(count == 3 && value == 100.0,
+        "A new update is delivered at once (%u, %g)", count, value);
+
+    /* past the end of the old window */
+    epicsThreadSleep(2.5);
+    snapshot(&count, &value);
+    epicsMutexMustLock(lock);
+    nBad = nOutOfOrder;
+    epicsMutexUnlock(lock);
+    testOk(count == 3 && value == 100.0 && nBad == 0,
+        "No stale update delivered later (%u, %g)", count, value);
+
+    ca_clear_subscription(id);
+    ca_clear_channel(chan);
+}
+
+MAIN(caPolicyTest)
+{
+    testPlan(17);
+
+    lock = epicsMutexMustCreate();
+
+    caTestIocEnv(55160);
+    if (ca_context_create(ca_enable_preemptive_callback) != ECA_NORMAL)
+        testAbort("Failed to create the CA context");
+    caTestIocStart("caPolicyTest.db", NULL);
+
+    testArguments();
+    testLossless();
+    testWindowed();
+    testBudget();
+    testChange();
+
+    ca_context_destroy();
+
+    return testDone();
+}
@@ -0,0 +1,45 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+
+#include "dbAccess.h"
+#include "dbUnitTest.h"
+#include "envDefs.h"
+#include "iocInit.h"
+
+#include "caTestIoc.h"
+
+void caTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+void caTestIocEnv(unsigned short port)
+{
+    char buf[16];
+
+    /* Keep traffic local and away from any other CA servers */
+    epicsEnvSet("EPICS_CA_AUTO_ADDR_LIST", "NO");
+    epicsEnvSet("EPICS_CA_ADDR_LIST", "127.0.0.1");
+    epicsEnvSet("EPICS_CAS_INTF_ADDR_LIST", "127.0.0.1");
+    sprintf(buf, "%u", port);
+    epicsEnvSet("EPICS_CA_SERVER_PORT", buf);
+    epicsEnvSet("EPICS_CAS_SERVER_PORT", buf);
+    sprintf(buf, "%u", port + 1u);
+    epicsEnvSet("EPICS_CA_REPEATER_PORT", buf);
+    epicsEnvSet("EPICS_CAS_BEACON_PORT", buf);
+}
+
+void caTestIocStart(const char *db, const char *macros)
+{
+    testdbPrepare();
+    testdbReadDatabase("caTestIoc.dbd", NULL, NULL);
+    caTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase(db, NULL, macros);
+
+    /* RSRV is only started by a full iocBuild(), and can't be stopped,
+     * so the tests end without shutting the IOC down */
+    if (iocBuild() || iocRun())
+        testAbort("Failed to start the test IOC");
+}
@@ -0,0 +1,34 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Test IOC for the CA client tests: RSRV serves a test database over
+ *  the loopback interface to a CA client context in the same process.
+ *
+ *  This header doesn't include dbAccess.h, so the tests can use cadef.h.
+ */
+
+#ifndef INC_caTestIoc_H
+#define INC_caTestIoc_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Point CA clients and RSRV at each other on the loopback interface
+ * using a port of their own, before the first CA context is created */
+void caTestIocEnv(unsigned short port);
+
+/* Load the database and start an IOC that serves it. Call this after
+ * creating the test's CA context; a context created later would find
+ * the records without using the network. */
+void caTestIocStart(const char *db, const char *macros);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_caTestIoc_H */
@@ -25,6 +25,7 @@
 #include "dbUnitTest.h"
 #include "epicsTime.h"
 #include "dbmf.h"
+#include "epicsMath.h"
 #include "testMain.h"
 #include "osiFileName.h"
 
@@ -112,6 +113,18 @@ static void mustPassTwice(dbChannel *pch, db_field_log *pfl2, char* m, double d,
         oldFree, newFree);
 }
 
+static void arrayUpdate(dbChannel *pch, int pass, const char* m) {
+    db_field_log *pfl = db_create_read_log(pch);
+    db_field_log *pfl2;
+
+    pfl->mask = DBE_VALUE;
+    pfl2 = dbChannelRunPreChain(pch, pfl);
+    testOk(pass ? pfl2 == pfl : pfl2 == NULL, "array update %s (%s)",
+        pass ? "passes" : "is dropped", m);
+    if (pfl2)
+        db_delete_field_log(pfl2);
+}
+
 static void testHead (char* title) {
     testDiag("--------------------------------------------------------");
     testDiag("%s", title);
@@ -132,7 +145,7 @@ MAIN(dbndTest)
     dbEventCtx evtctx;
     int logsFree, logsFinal;
 
-    testPlan(72);
+    testPlan(91);
 
     testdbPrepare();
 
@@ -141,6 +154,7 @@ MAIN(dbndTest)
     filterTest_registerRecordDeviceDriver(pdbbase);
 
     testdbReadDatabase("xRecord.db", NULL, NULL);
+    testdbReadDatabase("dbndTest.db", NULL, NULL);
 
     eltc(0);
     testIocInitOk();
@@ -301,6 +315,48 @@ MAIN(dbndTest)
 
     dbChannelDelete(pch);
 
+    /* Arrays: per element deadband */
+
+    testHead("Arrays, absolute per element");
+    {
+        epicsInt16 sval[6] = {10, 20, 30, 40, 50, 60};
+
+        testdbPutArrFieldOk("b", DBF_SHORT, 5, sval);
+        testOk(!!(pch = dbChannelCreate("b.VAL{dbnd:{d:2}}")),
+               "dbChannel with plugin dbnd (array, delta=2) created");
+        testOk(!(dbChannelOpen(pch)), "dbChannel with plugin dbnd opened");
+        arrayUpdate(pch, 1, "first update");
+        arrayUpdate(pch, 0, "no change");
+        sval[3] = 42;
+        testdbPutArrFieldOk("b", DBF_SHORT, 5, sval);
+        arrayUpdate(pch, 0, "one element within deadband");
+        sval[4] = 53;
+        testdbPutArrFieldOk("b", DBF_SHORT, 5, sval);
+        arrayUpdate(pch, 1, "one element outside deadband");
+        testdbPutArrFieldOk("b", DBF_SHORT, 6, sval);
+        arrayUpdate(pch, 1, "length changed");
+        dbChannelDelete(pch);
+    }
+
+    testHead("Arrays, relative per element");
+    {
+        epicsFloat64 dval[3] = {100., -1., 0.};
+
+        testdbPutArrFieldOk("a", DBF_DOUBLE, 3, dval);
+        testOk(!!(pch = dbChannelCreate("a.VAL{dbnd:{rel:10}}")),
+               "dbChannel with plugin dbnd (array, rel=10) created");
+        testOk(!(dbChannelOpen(pch)), "dbChannel with plugin dbnd opened");
+        arrayUpdate(pch, 1, "first update");
+        dval[0] = 105.;
+        dval[1] = -1.05;
+        testdbPutArrFieldOk("a", DBF_DOUBLE, 3, dval);
+        arrayUpdate(pch, 0, "changes below 10%");
+        dval[2] = epicsNAN;
+        testdbPutArrFieldOk("a", DBF_DOUBLE, 3, dval);
+        arrayUpdate(pch, 1, "element became NaN");
+        dbChannelDelete(pch);
+    }
+
     logsFinal = db_available_logs();
     testOk(logsFree == logsFinal, "%d field_logs on free-list", logsFinal);
 
@@ -0,0 +1,199 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Tests for the down (downsampling) channel filter
+ */
+
+#include <string.h>
+
+#include "dbStaticLib.h"
+#include "dbAccessDefs.h"
+#include "db_field_log.h"
+#include "dbCommon.h"
+#include "dbChannel.h"
+#include "chfPlugin.h"
+#include "dbEvent.h"
+#include "errlog.h"
+#include "epicsUnitTest.h"
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+void filterTest_registerRecordDeviceDriver(struct dbBase *);
+
+static double data[100];
+
+static void testHead (char* title) {
+    testDiag("--------------------------------------------------------");
+    testDiag("%s", title);
+    testDiag("--------------------------------------------------------");
+}
+
+static void noFree(db_field_log *pfl) {}
+
+/* Create a field_log referring to an array owned by the test */
+static db_field_log* arrayLog(dbChannel *chan, double *val, long n)
+{
+    db_field_log *pfl = db_create_read_log(chan);
+
+    pfl->type = dbfl_type_ref;
+    pfl->field_type  = DBF_DOUBLE;
+    pfl->field_size  = sizeof(epicsFloat64);
+    pfl->no_elements = n;
+    pfl->u.r.field = val;
+    pfl->dtor = noFree;
+    return pfl;
+}
+
+static dbChannel* openChan(const char *name, long nelem)
+{
+    dbChannel *pch = dbChannelCreate(name);
+
+    testOk(pch && !dbChannelOpen(pch), "opened %s", name);
+    if (!pch)
+        testAbort("Can't continue");
+    testOk(dbChannelFinalElements(pch) == nelem,
+        "final elements %ld == %ld", dbChannelFinalElements(pch), nelem);
+    return pch;
+}
+
+/* Run the post chain, check and release the result */
+static void check(dbChannel *pch, db_field_log *pfl, const double *expect,
+    long n, const char *msg)
+{
+    db_field_log *pfl2 = dbChannelRunPostChain(pch, pfl);
+    int ok = pfl2 == pfl && pfl->type == dbfl_type_ref &&
+        pfl->no_elements == n;
+    long i;
+
+    for (i = 0; ok && i < n; i++) {
+        double val;
+
+        if (pfl->field_type == DBF_SHORT)
+            val = ((epicsInt16 *) pfl->u.r.field)[i];
+        else
+            val = ((epicsFloat64 *) pfl->u.r.field)[i];
+        if (val != expect[i]) {
+            testDiag("element %ld is %g, expected %g", i, val, expect[i]);
+            ok = 0;
+        }
+    }
+    testOk(ok, "%s: %ld elements", msg, pfl->no_elements);
+    db_delete_field_log(pfl);
+}
+
+MAIN(downTest)
+{
+    dbChannel *pch;
+    db_field_log *pfl;
+    dbEventCtx evtctx;
+    int i, logsFree, logsFinal;
+    static const double minmax[] = {0, 19, 0, 100, 0, 19, 0, 19, -5, 19};
+    epicsInt16 sdata[100];
+
+    testPlan(25);
+
+    testdbPrepare();
+
+    testdbReadDatabase("filterTest.dbd", NULL, NULL);
+
+    filterTest_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("downTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    evtctx = db_init_events();
+
+    testOk(!!dbFindFilter("down", 4), "plugin 'down' registered");
+
+    /* Bad parms */
+    testOk(!dbChannelCreate("a.VAL{down:{}}"),
+           "dbChannel with down (no n) failed");
+    testOk(!dbChannelCreate("a.VAL{down:{n:1}}"),
+           "dbChannel with down (n=1) failed");
+    testOk(!dbChannelCreate("a.VAL{down:{n:2,m:\"lttb\"}}"),
+           "dbChannel with down (n=2, lttb) failed");
+    testOk(!dbChannelCreate("a.VAL{down:{n:10,m:\"avg\"}}"),
+           "dbChannel with down (m=avg) failed");
+
+    /* Start the free-list */
+    pch = dbChannelCreate("a.VAL");
+    db_delete_field_log(db_create_read_log(pch));
+    dbChannelDelete(pch);
+    logsFree = db_available_logs();
+
+    /* a sawtooth with a peak and a trough */
+    for (i = 0; i < 100; i++)
+        data[i] = i % 20;
+    data[37] = 100;
+    data[81] = -5;
+
+    testHead("Min/max per bin");
+    pch = openChan("a.VAL{down:{n:200}}", 100);
+    testOk(ellCount(&pch->post_chain) == 0,
+        "filter not used when arrays are short");
+    dbChannelDelete(pch);
+
+    pch = openChan("a.VAL{down:{n:10}}", 10);
+    check(pch, arrayLog(pch, data, 100), minmax, 10, "field_log array");
+    check(pch, arrayLog(pch, data, 10), data, 10, "short array unchanged");
+    pfl = arrayLog(pch, data, 100);
+    pfl->type = dbfl_type_val;
+    testOk(dbChannelRunPostChain(pch, pfl) == pfl &&
+        pfl->type == dbfl_type_val, "scalar field_log passes unchanged");
+    db_delete_field_log(pfl);
+    dbChannelDelete(pch);
+
+    for (i = 0; i < 100; i++)
+        sdata[i] = (epicsInt16) data[i];
+    testdbPutArrFieldOk("b", DBF_SHORT, 100, sdata);
+    pch = openChan("b.VAL{down:{n:11}}", 11);
+    testOk(dbChannelFinalFieldType(pch) == DBF_SHORT, "type is unchanged");
+    check(pch, db_create_read_log(pch), minmax, 10, "record array");
+    dbChannelDelete(pch);
+
+    testHead("Largest-Triangle-Three-Buckets");
+    for (i = 0; i < 100; i++)
+        data[i] = 0;
+    data[50] = 10;
+    data[99] = 3;
+    pch = openChan("a.VAL{down:{n:5,m:\"lttb\"}}", 5);
+    {
+        static const double lttb[] = {0, 0, 10, 0, 3};
+        check(pch, arrayLog(pch, data, 100), lttb, 5, "peak kept");
+    }
+    dbChannelDelete(pch);
+
+    for (i = 0; i < 100; i++)
+        data[i] = i * i;
+    pch = openChan("a.VAL{down:{n:12,m:\"lttb\"}}", 12);
+    pfl = dbChannelRunPostChain(pch, arrayLog(pch, data, 100));
+    {
+        const double *res = pfl->u.r.field;
+        int ordered = pfl->no_elements == 12 && res[0] == 0 &&
+            res[11] == 99 * 99;
+
+        for (i = 1; ordered && i < 12; i++)
+            ordered = res[i] > res[i - 1];
+        testOk(ordered, "monotonic data stays in order, ends kept");
+    }
+    db_delete_field_log(pfl);
+    dbChannelDelete(pch);
+
+    logsFinal = db_available_logs();
+    testOk(logsFree == logsFinal, "%d field_logs on free-list", logsFinal);
+
+    db_close_events(evtctx);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,277 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  Tests for the stat (statistics) channel filter
+ */
+
+#include <string.h>
+
+#include "alarm.h"
+#include "caeventmask.h"
+
+#include "dbStaticLib.h"
+#include "dbAccessDefs.h"
+#include "db_field_log.h"
+#include "dbCommon.h"
+#include "dbChannel.h"
+#include "chfPlugin.h"
+#include "dbEvent.h"
+#include "errlog.h"
+#include "epicsMath.h"
+#include "epicsStdio.h"
+#include "epicsUnitTest.h"
+#include "dbUnitTest.h"
+#include "epicsTime.h"
+#include "testMain.h"
+
+void filterTest_registerRecordDeviceDriver(struct dbBase *);
+
+static epicsTimeStamp now;
+
+static void testHead (char* title) {
+    testDiag("--------------------------------------------------------");
+    testDiag("%s", title);
+    testDiag("--------------------------------------------------------");
+}
+
+static void noFree(db_field_log *pfl) {}
+
+/* Create an event field_log holding a scalar, dt seconds after now */
+static db_field_log* scalarLog(dbChannel *chan, long val, double dt,
+    unsigned short sevr)
+{
+    db_field_log *pfl = db_create_read_log(chan);
+
+    pfl->ctx  = dbfl_context_event;
+    pfl->type = dbfl_type_val;
+    pfl->mask = DBE_VALUE;
+    pfl->stat = sevr ? HIGH_ALARM : NO_ALARM;
+    pfl->sevr = sevr;
+    pfl->time = now;
+    epicsTimeAddSeconds(&pfl->time, dt);
+    pfl->field_type  = DBF_LONG;
+    pfl->field_size  = sizeof(epicsInt32);
+    pfl->no_elements = 1;
+    pfl->u.v.field.dbf_long = val;
+    return pfl;
+}
+
+/* Create an event field_log referring to an array */
+static db_field_log* arrayLog(dbChannel *chan, double *val, long n)
+{
+    db_field_log *pfl = db_create_read_log(chan);
+
+    pfl->ctx  = dbfl_context_event;
+    pfl->type = dbfl_type_ref;
+    pfl->mask = DBE_VALUE;
+    pfl->time = now;
+    pfl->field_type  = DBF_DOUBLE;
+    pfl->field_size  = sizeof(epicsFloat64);
+    pfl->no_elements = n;
+    pfl->u.r.field = val;
+    pfl->dtor = noFree;
+    return pfl;
+}
+
+static void mustDrop(dbChannel *pch, db_field_log *pfl, const char* m) {
+    int oldFree = db_available_logs();
+    db_field_log *pfl2 = dbChannelRunPostChain(pch, pfl);
+    int newFree = db_available_logs();
+
+    testOk(NULL == pfl2 && newFree == oldFree + 1,
+        "filter drops field_log (%s)", m);
+}
+
+static db_field_log* mustSend(dbChannel *pch, db_field_log *pfl,
+    const char* m)
+{
+    db_field_log *pfl2 = dbChannelRunPostChain(pch, pfl);
+
+    testOk(pfl2 == pfl && pfl2->field_type == DBF_DOUBLE,
+        "filter sends DOUBLE field_log (%s)", m);
+    return pfl2;
+}
+
+static void checkScalar(dbChannel *pch, db_field_log *pfl, double expected)
+{
+    if (!pfl) {
+        testFail("no field_log");
+        return;
+    }
+    testOk(pfl->type == dbfl_type_val && pfl->no_elements == 1 &&
+        fabs(pfl->u.v.field.dbf_double - expected) < 1e-9,
+        "result %g == %g", pfl->u.v.field.dbf_double, expected);
+    db_delete_field_log(pfl);
+}
+
+static dbChannel* openChan(const char *name, long nelem)
+{
+    dbChannel *pch = dbChannelCreate(name);
+
+    testOk(pch && !dbChannelOpen(pch), "opened %s", name);
+    if (!pch)
+        testAbort("Can't continue");
+    testOk(ellCount(&pch->post_chain) == 1 &&
+        dbChannelFinalFieldType(pch) == DBF_DOUBLE &&
+        dbChannelFinalElements(pch) == nelem,
+        "post chain filter, %ld DOUBLE element(s)", nelem);
+    return pch;
+}
+
+static void testScalar(const char *func, const double expected[2])
+{
+    char name[64];
+    dbChannel *pch;
+    long vals[] = {1, 2, 3, 4, 10, 20, 30, 40};
+    int i;
+
+    epicsSnprintf(name, sizeof(name), "x.VAL{stat:{n:4,f:\"%s\"}}", func);
+    pch = openChan(name, 1);
+
+    for (i = 0; i < 8; i++) {
+        db_field_log *pfl = scalarLog(pch, vals[i], 0.0, NO_ALARM);
+
+        if (i % 4 != 3)
+            mustDrop(pch, pfl, func);
+        else
+            checkScalar(pch, mustSend(pch, pfl, func), expected[i / 4]);
+    }
+    dbChannelDelete(pch);
+}
+
+MAIN(statTest)
+{
+    dbChannel *pch;
+    db_field_log *pfl;
+    dbEventCtx evtctx;
+    int logsFree, logsFinal;
+
+    testPlan(103);
+
+    testdbPrepare();
+
+    testdbReadDatabase("filterTest.dbd", NULL, NULL);
+
+    filterTest_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("statTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    evtctx = db_init_events();
+    epicsTimeGetCurrent(&now);
+
+    testOk(!!dbFindFilter("stat", 4), "plugin 'stat' registered");
+
+    /* Bad parms */
+    testOk(!dbChannelCreate("x.VAL{stat:{}}"),
+           "dbChannel with stat (no window) failed");
+    testOk(!dbChannelCreate("x.VAL{stat:{n:-1}}"),
+           "dbChannel with stat (n=-1) failed");
+    testOk(!dbChannelCreate("x.VAL{stat:{n:0,t:0}}"),
+           "dbChannel with stat (n=0, t=0) failed");
+    testOk(!dbChannelCreate("x.VAL{stat:{n:2,f:\"median\"}}"),
+           "dbChannel with stat (f=median) failed");
+
+    /* Start the free-list */
+    pch = dbChannelCreate("x.VAL");
+    db_delete_field_log(db_create_read_log(pch));
+    dbChannelDelete(pch);
+    logsFree = db_available_logs();
+
+    testHead("Scalar windows of n updates");
+    {
+        static const double mean[] = {2.5, 25.0};
+        static const double min[] = {1.0, 10.0};
+        static const double max[] = {4.0, 40.0};
+        static const double cnt[] = {4.0, 4.0};
+        double std[2];
+
+        std[0] = sqrt(1.25);
+        std[1] = sqrt(125.0);
+        testScalar("mean", mean);
+        testScalar("min", min);
+        testScalar("max", max);
+        testScalar("std", std);
+        testScalar("count", cnt);
+    }
+
+    testHead("Scalar windows of t seconds, alarms and reads");
+    pch = openChan("x.VAL{stat:{t:1,f:\"max\"}}", 1);
+    mustDrop(pch, scalarLog(pch, 5, 0.0, NO_ALARM), "t=0");
+    mustDrop(pch, scalarLog(pch, 7, 0.5, MAJOR_ALARM), "t=0.5");
+
+    pfl = db_create_read_log(pch);
+    testOk(dbChannelRunPostChain(pch, pfl) == pfl &&
+        pfl->field_type == DBF_LONG,
+        "read field_log passes unchanged");
+    db_delete_field_log(pfl);
+
+    pfl = mustSend(pch, scalarLog(pch, 6, 1.0, MINOR_ALARM), "t=1");
+    testOk(pfl && pfl->sevr == MAJOR_ALARM && pfl->stat == HIGH_ALARM,
+        "window's highest severity sent");
+    checkScalar(pch, pfl, 7.0);
+    mustDrop(pch, scalarLog(pch, 3, 2.5, NO_ALARM), "t=2.5");
+    pfl = mustSend(pch, scalarLog(pch, 2, 3.5, NO_ALARM), "t=3.5");
+    testOk(pfl && pfl->sevr == NO_ALARM, "severity reset for next window");
+    checkScalar(pch, pfl, 3.0);
+    dbChannelDelete(pch);
+
+    testHead("Array windows");
+    {
+        double a1[] = {1.0, 2.0, 3.0, 4.0};
+        double a2[] = {3.0, 6.0, 9.0};
+        double *res;
+
+        pch = openChan("y.VAL{stat:{n:2}}", 10);
+        mustDrop(pch, arrayLog(pch, a1, 4), "elements 1");
+        pfl = mustSend(pch, arrayLog(pch, a2, 3), "elements 2");
+        res = pfl->u.r.field;
+        testOk(pfl->type == dbfl_type_ref && pfl->no_elements == 3 &&
+            res[0] == 2.0 && res[1] == 4.0 && res[2] == 6.0,
+            "per-element mean of shortest length (%ld: %g %g %g)",
+            pfl->no_elements, res[0], res[1], res[2]);
+        db_delete_field_log(pfl);
+        dbChannelDelete(pch);
+
+        pch = openChan("y.VAL{stat:{n:2,f:\"max\",all:true}}", 1);
+        mustDrop(pch, arrayLog(pch, a1, 4), "all 1");
+        checkScalar(pch, mustSend(pch, arrayLog(pch, a2, 3), "all 2"), 9.0);
+        dbChannelDelete(pch);
+
+        pch = openChan("y.VAL{stat:{n:2,f:\"mean\",all:true}}", 1);
+        mustDrop(pch, arrayLog(pch, a1, 4), "all 1");
+        checkScalar(pch, mustSend(pch, arrayLog(pch, a2, 3), "all 2"),
+            28.0 / 7);
+        dbChannelDelete(pch);
+
+        pch = openChan("y.VAL{stat:{n:2,f:\"std\",all:true}}", 1);
+        mustDrop(pch, arrayLog(pch, a1, 4), "all 1");
+        /* values 1 2 3 4 3 6 9, mean 4, squared deviations sum 44 */
+        checkScalar(pch, mustSend(pch, arrayLog(pch, a2, 3), "all 2"),
+            sqrt(44.0 / 7));
+        dbChannelDelete(pch);
+
+        pch = openChan("y.VAL{stat:{n:2,f:\"count\",all:true}}", 1);
+        mustDrop(pch, arrayLog(pch, a1, 4), "all 1");
+        checkScalar(pch, mustSend(pch, arrayLog(pch, a2, 3), "all 2"), 7.0);
+        dbChannelDelete(pch);
+    }
+
+    logsFinal = db_available_logs();
+    testOk(logsFree == logsFinal, "%d field_logs on free-list", logsFinal);
+
+    db_close_events(evtctx);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+
+    return testDone();
+}
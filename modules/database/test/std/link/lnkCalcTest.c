@@ -108,6 +108,69 @@ static void testCalc()
         testOk(sevr == MINOR_ALARM, "Alarm severity = MINOR (%d)", sevr);
     }
 
+    testDiag("testing lnkCalc array input");
+
+    {
+        dbStateId red = dbStateFind("red");
+        dbStateId major = dbStateFind("major");
+        epicsFloat64 arr[5] = {0.0};
+        epicsInt32 i32[4] = {0};
+        epicsEnum16 stat, sevr;
+        long nReq = 5;
+
+        testPutLongStr("io.INPUT", "{calc:{"
+            "expr:'A*B',"
+            "nelm:4,"
+            "args:[{const:[1,2,3,4,5]},10]"
+            "}}");
+        if (testOk1(pinp->type == JSON_LINK))
+            testDiag("Link was set to '%s'", pinp->value.json.string);
+
+        status = dbGetNelements(pinp, &nReq);
+        testOk(!status && nReq == 4, "dbGetNelements gives 4 (%ld)", nReq);
+
+        nReq = 5;
+        status = dbGetLink(pinp, DBF_DOUBLE, arr, NULL, &nReq);
+        testOk(!status, "dbGetLink succeeded (status = %ld)", status);
+        testOk(nReq == 4 && arr[0] == 10.0 && arr[1] == 20.0 &&
+            arr[2] == 30.0 && arr[3] == 40.0 && arr[4] == 0.0,
+            "Got %ld elements %g, %g, %g, %g", nReq,
+            arr[0], arr[1], arr[2], arr[3]);
+
+        nReq = 2;
+        status = dbGetLink(pinp, DBF_LONG, i32, NULL, &nReq);
+        testOk(!status && nReq == 2 && i32[0] == 10 && i32[1] == 20 &&
+            i32[2] == 0, "Got %ld integers %d, %d", nReq, i32[0], i32[1]);
+
+        testPutLongStr("io.INPUT", "{calc:{"
+            "expr:'sum(slice(A,1,-1))+B',"
+            "nelm:4,"
+            "major:'A>C*10',"
+            "args:[{const:[1,2,3,4,5]},{state:'red'},{state:'major'}]"
+            "}}");
+        if (testOk1(pinp->type == JSON_LINK))
+            testDiag("Link was set to '%s'", pinp->value.json.string);
+
+        dbStateSet(red);
+        dbStateSet(major);
+        nReq = 4;
+        status = dbGetLink(pinp, DBF_DOUBLE, arr, NULL, &nReq);
+        testOk(!status, "dbGetLink succeeded (status = %ld)", status);
+        testOk(nReq == 1 && arr[0] == 10.0, "Got %ld element %g",
+            nReq, arr[0]);
+        recGblResetAlarms(pio);
+        status = dbGetAlarm(pinp, &stat, &sevr);
+        testOk(!status && sevr == NO_ALARM, "No alarm (%d)", sevr);
+
+        dbStateClear(major);
+        status = dbGetLink(pinp, DBF_DOUBLE, arr, NULL, &nReq);
+        testOk(!status, "dbGetLink succeeded (status = %ld)", status);
+        testOk(recGblResetAlarms(pio) & DBE_ALARM, "Record alarm was raised");
+        status = dbGetAlarm(pinp, &stat, &sevr);
+        testOk(!status && sevr == MAJOR_ALARM,
+            "Alarm severity = MAJOR (%d)", sevr);
+    }
+
     testDiag("testing lnkCalc output");
 
     {
@@ -157,7 +220,7 @@ static void testCalc()
 
 MAIN(lnkCalcTest)
 {
-    testPlan(30);
+    testPlan(44);
 
     testCalc();
 
@@ -0,0 +1,85 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+/*
+ *  Benchmark of database link traversal along a chain of calc and ao
+ *  records. Each calc has twelve scalar DB input links (DOUBLE->DOUBLE
+ *  and SHORT->DOUBLE) of which its expression uses A unless <calc> is
+ *  given, and each ao does one DOL read and one OUT put.
+ *
+ *  usage: linkChainBench [<stages>] [<passes>] [<calc>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dbAccess.h"
+#include "dbLock.h"
+#include "dbUnitTest.h"
+#include "epicsTime.h"
+#include "errlog.h"
+#include "recSup.h"
+
+#include "testMain.h"
+
+void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(linkChainBench)
+{
+    unsigned long nstage = 1000, npass = 2000, i;
+    const char *calc = "A+1";
+    dbCommon *head;
+    epicsUInt64 start;
+    double elapsed;
+
+    if (argc > 1)
+        nstage = strtoul(argv[1], NULL, 0);
+    if (argc > 2)
+        npass = strtoul(argv[2], NULL, 0);
+    if (argc > 3)
+        calc = argv[3];
+    if (nstage < 1)
+        nstage = 1;
+
+    testPlan(0);
+
+    testdbPrepare();
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    for (i = 0; i < nstage; i++) {
+        char macros[160];
+
+        sprintf(macros, "N=%lu,P=chain%lu,CALC=%.60s", i, i ? i - 1 : 0,
+                calc);
+        if (i + 1 < nstage)
+            sprintf(macros + strlen(macros), ",NEXT=chain%lu", i + 1);
+        else
+            strcat(macros, ",NEXT=");
+        testdbReadDatabase("linkChainBench.db", NULL, macros);
+    }
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    head = testdbRecordPtr("chain0");
+
+    start = epicsMonotonicGet();
+    for (i = 0; i < npass; i++) {
+        dbScanLock(head);
+        dbProcess(head);
+        dbScanUnlock(head);
+    }
+    elapsed = (epicsMonotonicGet() - start) / (double) npass;
+
+    printf("%lu stages x %lu passes: %.1f ns/stage, %.0f records/s\n",
+           nstage, npass, elapsed / nstage, 2e9 * nstage / elapsed);
+
+    testIocShutdownOk();
+    testdbCleanup();
+    return testDone();
+}
@@ -60,11 +60,40 @@ void testint64AfterInit(void)
     testdbGetFieldEqual("in64", DBF_UINT64, 0x22345678abcdef00ULL);
 }
 
+static
+void testCalcFetch(void)
+{
+    testDiag("In %s", EPICS_FUNCTION);
+
+    /* unused inputs are only read for PP or MS links */
+
+    testdbPutFieldOk("alarm", DBF_DOUBLE, 10.0);
+    testdbPutFieldOk("fetch.PROC", DBF_LONG, 1);
+
+    testdbGetFieldEqual("fetch", DBF_DOUBLE, 5.0);
+    testdbGetFieldEqual("fetch.B", DBF_DOUBLE, 0.0);
+    testdbGetFieldEqual("count", DBF_DOUBLE, 1.0);
+    testdbGetFieldEqual("fetch.SEVR", DBF_LONG, 2);
+    testdbGetFieldEqual("fetch.E", DBF_DOUBLE, 7.0);
+
+    /* CALC is pp(TRUE) so this processes the record */
+    testdbPutFieldOk("fetch.CALC", DBF_STRING, "A+B");
+    testdbGetFieldEqual("fetch", DBF_DOUBLE, 10.0);
+    testdbGetFieldEqual("count", DBF_DOUBLE, 2.0);
+
+    /* calcout also reads inputs used by OCAL */
+
+    testdbPutFieldOk("fetchout.PROC", DBF_LONG, 1);
+    testdbGetFieldEqual("fetchout.A", DBF_DOUBLE, 5.0);
+    testdbGetFieldEqual("fetchout.B", DBF_DOUBLE, 5.0);
+    testdbGetFieldEqual("fetchout.C", DBF_DOUBLE, 0.0);
+}
+
 void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
 
 MAIN(recMiscTest)
 {
-    testPlan(12);
+    testPlan(26);
 
     testdbPrepare();
 
@@ -91,6 +120,8 @@ MAIN(recMiscTest)
 
     testint64AfterInit();
 
+    testCalcFetch();
+
     testIocShutdownOk();
 
     testdbCleanup();
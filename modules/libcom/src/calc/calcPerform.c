@@ -390,6 +390,37 @@ LIBCOM_API long
         case COND_END:
             break;
 
+        /* A scalar is its own sum, mean, min or max, and the only
+         * element of any slice.
+         */
+        case SUM:
+        case MEAN:
+            break;
+
+        case RMS:
+            *ptop = fabs(*ptop);
+            break;
+
+        case SLICE:
+            ptop -= 2;
+            break;
+
+        case ADD_ARG:
+            *ptop += parg[(int) *pinst++];
+            break;
+
+        case SUB_ARG:
+            *ptop -= parg[(int) *pinst++];
+            break;
+
+        case MULT_ARG:
+            *ptop *= parg[(int) *pinst++];
+            break;
+
+        case DIV_ARG:
+            *ptop /= parg[(int) *pinst++];
+            break;
+
         default:
             errlogPrintf("calcPerform: Bad Opcode %d at %p\n", op, pinst-1);
             return -1;
@@ -407,6 +438,536 @@ LIBCOM_API long
 #  pragma optimize("", on)
 #endif
 
+/* Array evaluation
+ *
+ * Values on the stack are scalars or arrays. Arrays are either read-only
+ * views of the arguments and VAL, or live in work buffers of nwork doubles
+ * that are reference counted so a STORE_x and the stack can share them.
+ * An operator writes its result into a buffer it holds the only reference
+ * to, so most expressions need no more buffers than array arguments.
+ */
+typedef struct {
+    double *p;          /* elements, NULL for a scalar */
+    unsigned long n;    /* number of elements */
+    double s;           /* value of a scalar */
+    int buf;            /* work buffer referenced, or -1 */
+} avalue;
+
+#define NBUFS (CALCPERFORM_STACK + CALCPERFORM_NARGS + 1)
+
+typedef struct {
+    double *buf[NBUFS];
+    int ref[NBUFS];
+    int nbufs;
+    unsigned long nwork;
+} aworkspace;
+
+static int newBuf(aworkspace *pws)
+{
+    int i;
+
+    for (i = 0; i < pws->nbufs; i++)
+        if (pws->ref[i] == 0)
+            break;
+    if (i == pws->nbufs) {
+        if (i == NBUFS)
+            return -1;
+        pws->buf[i] = malloc(pws->nwork * sizeof(double));
+        if (!pws->buf[i])
+            return -1;
+        pws->nbufs++;
+    }
+    pws->ref[i] = 1;
+    return i;
+}
+
+static void releaseValue(aworkspace *pws, avalue *pv)
+{
+    if (pv->buf >= 0)
+        pws->ref[pv->buf]--;
+    pv->buf = -1;
+}
+
+/* Find a buffer for the result of an operation on the given operands,
+ * reusing one that is only referenced by an operand if possible.
+ */
+static int resultBuf(aworkspace *pws, avalue *pa, avalue *pb)
+{
+    int i;
+
+    if (pa->buf >= 0 && pws->ref[pa->buf] == 1) {
+        i = pa->buf;
+        pa->buf = -1;
+    }
+    else if (pb && pb->buf >= 0 && pws->ref[pb->buf] == 1) {
+        i = pb->buf;
+        pb->buf = -1;
+    }
+    else
+        i = newBuf(pws);
+    releaseValue(pws, pa);
+    if (pb)
+        releaseValue(pws, pb);
+    return i;
+}
+
+/* Run a single operator through calcPerform() with scalar operands */
+static double scalarOp(const char *pop, int nops, double x, double y)
+{
+    char prog[5];
+    double args[2];
+    double result = epicsNAN;
+    int i = 0;
+
+    args[0] = x;
+    args[1] = y;
+    prog[i++] = FETCH_A;
+    if (nops == 2)
+        prog[i++] = FETCH_B;
+    prog[i++] = *pop;
+    if (*pop == MIN || *pop == MAX || *pop == FINITE || *pop == ISNAN)
+        prog[i++] = nops;
+    prog[i] = END_EXPRESSION;
+    calcPerform(args, &result, prog);
+    return result;
+}
+
+#define KERNEL1(EXPR) \
+    for (i = 0; i < n; i++) { \
+        double x = pa->p[i]; \
+        pr[i] = (EXPR); \
+    }
+
+#define KERNEL2(EXPR) \
+    if (pa->p && pb->p) { \
+        for (i = 0; i < n; i++) { \
+            double x = pa->p[i], y = pb->p[i]; \
+            pr[i] = (EXPR); \
+        } \
+    } else if (pa->p) { \
+        double y = pb->s; \
+        for (i = 0; i < n; i++) { \
+            double x = pa->p[i]; \
+            pr[i] = (EXPR); \
+        } \
+    } else { \
+        double x = pa->s; \
+        for (i = 0; i < n; i++) { \
+            double y = pb->p[i]; \
+            pr[i] = (EXPR); \
+        } \
+    }
+
+/* Element-wise unary operator, result replaces *pa */
+static int arrayOp1(aworkspace *pws, const char *pop, avalue *pa)
+{
+    unsigned long i, n = pa->n;
+    double *pr;
+    int buf;
+
+    if (!pa->p) {
+        pa->s = scalarOp(pop, 1, pa->s, 0);
+        return 0;
+    }
+    buf = resultBuf(pws, pa, NULL);
+    if (buf < 0)
+        return -1;
+    pr = pws->buf[buf];
+
+    switch (*pop) {
+    case UNARY_NEG: KERNEL1(-x); break;
+    case ABS_VAL:   KERNEL1(fabs(x)); break;
+    case SQU_RT:    KERNEL1(sqrt(x)); break;
+    case REL_NOT:   KERNEL1(!x); break;
+    case EXP:       KERNEL1(exp(x)); break;
+    case LOG_10:    KERNEL1(log10(x)); break;
+    case LOG_E:     KERNEL1(log(x)); break;
+    case SIN:       KERNEL1(sin(x)); break;
+    case COS:       KERNEL1(cos(x)); break;
+    case TAN:       KERNEL1(tan(x)); break;
+    case CEIL:      KERNEL1(ceil(x)); break;
+    case FLOOR:     KERNEL1(floor(x)); break;
+    default:
+        KERNEL1(scalarOp(pop, 1, x, 0));
+    }
+    pa->p = pr;
+    pa->buf = buf;
+    return 0;
+}
+
+/* Element-wise binary operator, result replaces *pa */
+static int arrayOp2(aworkspace *pws, const char *pop, avalue *pa, avalue *pb)
+{
+    unsigned long i, n;
+    double *pr;
+    int buf;
+
+    if (!pa->p && !pb->p) {
+        pa->s = scalarOp(pop, 2, pa->s, pb->s);
+        return 0;
+    }
+    n = !pa->p ? pb->n : !pb->p ? pa->n : pa->n < pb->n ? pa->n : pb->n;
+    buf = resultBuf(pws, pa, pb);
+    if (buf < 0)
+        return -1;
+    pr = pws->buf[buf];
+
+    switch (*pop) {
+    case ADD:        KERNEL2(x + y); break;
+    case SUB:        KERNEL2(x - y); break;
+    case MULT:       KERNEL2(x * y); break;
+    case DIV:        KERNEL2(x / y); break;
+    case POWER:      KERNEL2(pow(x, y)); break;
+    case FMOD:       KERNEL2(fmod(x, y)); break;
+    case MAX:        KERNEL2((x < y || isnan(y)) ? y : x); break;
+    case MIN:        KERNEL2((x > y || isnan(y)) ? y : x); break;
+    case NOT_EQ:     KERNEL2(x != y); break;
+    case LESS_THAN:  KERNEL2(x < y); break;
+    case LESS_OR_EQ: KERNEL2(x <= y); break;
+    case EQUAL:      KERNEL2(x == y); break;
+    case GR_OR_EQ:   KERNEL2(x >= y); break;
+    case GR_THAN:    KERNEL2(x > y); break;
+    default:
+        KERNEL2(scalarOp(pop, 2, x, y));
+    }
+    pa->p = pr;
+    pa->n = n;
+    pa->buf = buf;
+    return 0;
+}
+
+/* Reduce an array to a scalar */
+static void arrayReduce(aworkspace *pws, int op, avalue *pa)
+{
+    const double *x = pa->p;
+    unsigned long i, n = pa->n;
+    double acc;
+
+    if (!x) {
+        if (op == RMS)
+            pa->s = fabs(pa->s);
+        return;
+    }
+
+    switch (op) {
+    case SUM:
+    case MEAN:
+        acc = 0.0;
+        for (i = 0; i < n; i++)
+            acc += x[i];
+        if (op == MEAN)
+            acc = n ? acc / n : epicsNAN;
+        break;
+    case RMS:
+        acc = 0.0;
+        for (i = 0; i < n; i++)
+            acc += x[i] * x[i];
+        acc = n ? sqrt(acc / n) : epicsNAN;
+        break;
+    case MAX:
+        acc = n ? x[0] : epicsNAN;
+        for (i = 1; i < n; i++)
+            if (acc < x[i] || isnan(x[i]))
+                acc = x[i];
+        break;
+    default: /* MIN */
+        acc = n ? x[0] : epicsNAN;
+        for (i = 1; i < n; i++)
+            if (acc > x[i] || isnan(x[i]))
+                acc = x[i];
+        break;
+    }
+    releaseValue(pws, pa);
+    pa->p = NULL;
+    pa->n = 1;
+    pa->s = acc;
+}
+
+/* Slice elements first to last of *pa, negative indices count from
+ * the end. A slice is a view into the same elements, so costs nothing.
+ */
+static void arraySlice(avalue *pa, double first, double last)
+{
+    static double none;
+    double n = pa->n;
+
+    if (!pa->p)
+        return;
+    if (first < 0)
+        first += n;
+    if (last < 0)
+        last += n;
+    if (!(first >= 0))  /* also NaN */
+        first = 0;
+    if (!(last < n))
+        last = n - 1;
+    first = floor(first);
+    last = floor(last);
+    if (!(last >= first)) {
+        pa->p = &none;
+        pa->n = 0;
+    }
+    else {
+        pa->p += (unsigned long) first;
+        pa->n = (unsigned long) (last - first) + 1;
+    }
+}
+
+LIBCOM_API long
+    calcPerformArray(const double * const *pargs, const unsigned long *pnargs,
+        double *presult, unsigned long *pnresult, unsigned long nmax,
+        const char *pinst)
+{
+    static double none;
+    avalue stack[CALCPERFORM_STACK+1];  /* zero'th entry not used */
+    avalue args[CALCPERFORM_NARGS];
+    avalue *ptop = stack;
+    aworkspace ws;
+    long status = -1;
+    int op, nargs, i;
+
+    if (*pnresult == 1 && nmax >= 1) {
+        /* Only scalars, so calcPerform() gives the same result faster */
+        double sargs[CALCPERFORM_NARGS];
+
+        for (i = 0; i < CALCPERFORM_NARGS && pnargs[i] == 1; i++)
+            sargs[i] = pargs[i][0];
+        if (i == CALCPERFORM_NARGS)
+            return calcPerform(sargs, presult, pinst);
+    }
+
+    ws.nbufs = 0;
+    ws.nwork = *pnresult > 1 ? *pnresult : 1;
+    for (i = 0; i < CALCPERFORM_NARGS; i++) {
+        avalue *parg = &args[i];
+
+        parg->buf = -1;
+        if (pnargs[i] == 1) {
+            parg->p = NULL;
+            parg->n = 1;
+            parg->s = pargs[i][0];
+        }
+        else {
+            parg->p = pnargs[i] ? (double *) pargs[i] : &none;
+            parg->n = pnargs[i];
+            parg->s = 0.0;
+            if (parg->n > ws.nwork)
+                ws.nwork = parg->n;
+        }
+    }
+
+    while ((op = *pinst++) != END_EXPRESSION) {
+        switch (op) {
+
+        case LITERAL_DOUBLE:
+        case LITERAL_INT:
+        case CONST_PI:
+        case CONST_D2R:
+        case CONST_R2D:
+        case RANDOM:
+        {
+            /* Scalar operands, evaluated by calcPerform() */
+            const char *pstart = pinst - 1;
+            char prog[1 + sizeof(double) + 1];
+            double val;
+
+            if (op == LITERAL_DOUBLE)
+                pinst += sizeof(double);
+            else if (op == LITERAL_INT)
+                pinst += sizeof(epicsInt32);
+            memcpy(prog, pstart, pinst - pstart);
+            prog[pinst - pstart] = END_EXPRESSION;
+            calcPerform(NULL, &val, prog);
+            ++ptop;
+            ptop->p = NULL;
+            ptop->n = 1;
+            ptop->s = val;
+            ptop->buf = -1;
+            break;
+        }
+
+        case FETCH_VAL:
+            ++ptop;
+            ptop->buf = -1;
+            if (*pnresult == 1) {
+                ptop->p = NULL;
+                ptop->n = 1;
+                ptop->s = *presult;
+            }
+            else {
+                ptop->p = *pnresult ? presult : &none;
+                ptop->n = *pnresult;
+            }
+            break;
+
+        case FETCH_A:
+        case FETCH_B:
+        case FETCH_C:
+        case FETCH_D:
+        case FETCH_E:
+        case FETCH_F:
+        case FETCH_G:
+        case FETCH_H:
+        case FETCH_I:
+        case FETCH_J:
+        case FETCH_K:
+        case FETCH_L:
+            *++ptop = args[op - FETCH_A];
+            if (ptop->buf >= 0)
+                ws.ref[ptop->buf]++;
+            break;
+
+        case STORE_A:
+        case STORE_B:
+        case STORE_C:
+        case STORE_D:
+        case STORE_E:
+        case STORE_F:
+        case STORE_G:
+        case STORE_H:
+        case STORE_I:
+        case STORE_J:
+        case STORE_K:
+        case STORE_L:
+            releaseValue(&ws, &args[op - STORE_A]);
+            args[op - STORE_A] = *ptop--;
+            break;
+
+        case ADD_ARG:
+        case SUB_ARG:
+        case MULT_ARG:
+        case DIV_ARG:
+        {
+            char binop = ADD + op - ADD_ARG;
+            avalue arg = args[(int) *pinst++];
+
+            if (arg.buf >= 0)
+                ws.ref[arg.buf]++;
+            if (arrayOp2(&ws, &binop, ptop, &arg))
+                goto done;
+            break;
+        }
+
+        case SUM:
+        case MEAN:
+        case RMS:
+            arrayReduce(&ws, op, ptop);
+            break;
+
+        case MAX:
+        case MIN:
+        case FINITE:
+        case ISNAN:
+            nargs = *pinst++;
+            if (nargs == 1) {
+                if (op == MAX || op == MIN)
+                    arrayReduce(&ws, op, ptop);
+                else if (arrayOp1(&ws, pinst - 2, ptop))
+                    goto done;
+                break;
+            }
+            if (op == MAX || op == MIN) {
+                /* Combine pairwise from the top, as calcPerform() does */
+                while (--nargs) {
+                    --ptop;
+                    if (arrayOp2(&ws, pinst - 2, ptop, ptop + 1))
+                        goto done;
+                }
+            }
+            else {
+                /* Test each operand, then AND or OR the results */
+                static const char unop[] = {FINITE, 1, ISNAN, 1};
+                static const char binop[] = {REL_AND, REL_OR};
+                int isnanop = (op == ISNAN);
+
+                if (arrayOp1(&ws, &unop[2 * isnanop], ptop))
+                    goto done;
+                while (--nargs) {
+                    --ptop;
+                    if (arrayOp1(&ws, &unop[2 * isnanop], ptop) ||
+                        arrayOp2(&ws, &binop[isnanop], ptop, ptop + 1))
+                        goto done;
+                }
+            }
+            break;
+
+        case SLICE:
+            if (ptop[-1].p || ptop[0].p)
+                goto done;
+            ptop -= 2;
+            arraySlice(ptop, ptop[1].s, ptop[2].s);
+            break;
+
+        case UNARY_NEG:
+        case ABS_VAL:
+        case EXP:
+        case LOG_10:
+        case LOG_E:
+        case SQU_RT:
+        case ACOS:
+        case ASIN:
+        case ATAN:
+        case COS:
+        case COSH:
+        case SIN:
+        case SINH:
+        case TAN:
+        case TANH:
+        case CEIL:
+        case FLOOR:
+        case ISINF:
+        case NINT:
+        case REL_NOT:
+        case BIT_NOT:
+            if (arrayOp1(&ws, pinst - 1, ptop))
+                goto done;
+            break;
+
+        case COND_IF:
+            if (ptop->p)
+                goto done;      /* condition must be a scalar */
+            if ((ptop--)->s == 0.0 &&
+                cond_search(&pinst, COND_ELSE))
+                goto done;
+            break;
+
+        case COND_ELSE:
+            if (cond_search(&pinst, COND_END))
+                goto done;
+            break;
+
+        case COND_END:
+            break;
+
+        default:
+            /* All remaining operators are binary */
+            --ptop;
+            if (arrayOp2(&ws, pinst - 1, ptop, ptop + 1))
+                goto done;
+        }
+    }
+
+    /* The stack should now have one item on it, the expression value */
+    if (ptop != stack + 1 || nmax < 1)
+        goto done;
+    if (!ptop->p) {
+        *presult = ptop->s;
+        *pnresult = 1;
+    }
+    else {
+        unsigned long n = ptop->n < nmax ? ptop->n : nmax;
+
+        memmove(presult, ptop->p, n * sizeof(double));
+        *pnresult = n;
+    }
+    status = 0;
+
+done:
+    for (i = 0; i < ws.nbufs; i++)
+        free(ws.buf[i]);
+    return status;
+}
+
 LIBCOM_API long
 calcArgUsage(const char *pinst, unsigned long *pinputs, unsigned long *pstores)
 {
@@ -460,6 +1021,13 @@ calcArgUsage(const char *pinst, unsigned long *pinputs, unsigned long *pstores)
             stores |= (1 << (op - STORE_A));
             break;
 
+        case ADD_ARG:
+        case SUB_ARG:
+        case MULT_ARG:
+        case DIV_ARG:
+            inputs |= (1 << *pinst++) & ~stores;
+            break;
+
         default:
             break;
         }
@@ -513,6 +1081,10 @@ static int cond_search(const char **ppinst, int match)
         case MAX:
         case FINITE:
         case ISNAN:
+        case ADD_ARG:
+        case SUB_ARG:
+        case MULT_ARG:
+        case DIV_ARG:
             pinst++;
             break;
         case COND_IF:
@@ -26,6 +26,7 @@
 #include "postfix.h"
 #include "postfixPvt.h"
 #include "libComAPI.h"
+#include "epicsExport.h"
 
 #ifdef RTEMS_HAS_ALTIVEC
 #pragma GCC push_options
@@ -118,17 +119,21 @@ static const ELEMENT operands[] = {
 {"LOG",         7, 8,   0,      UNARY_OPERATOR, LOG_10},
 {"LOGE",        7, 8,   0,      UNARY_OPERATOR, LOG_E},
 {"MAX",         7, 8,   0,      VARARG_OPERATOR,MAX},
+{"MEAN",        7, 8,   0,      UNARY_OPERATOR, MEAN},
 {"MIN",         7, 8,   0,      VARARG_OPERATOR,MIN},
 {"NINT",        7, 8,   0,      UNARY_OPERATOR, NINT},
 {"NAN",         0, 0,   1,      LITERAL_OPERAND,LITERAL_DOUBLE},
 {"NOT",         7, 8,   0,      UNARY_OPERATOR, BIT_NOT},
 {"PI",          0, 0,   1,      OPERAND,        CONST_PI},
 {"R2D",         0, 0,   1,      OPERAND,        CONST_R2D},
+{"RMS",         7, 8,   0,      UNARY_OPERATOR, RMS},
 {"RNDM",        0, 0,   1,      OPERAND,        RANDOM},
 {"SIN",         7, 8,   0,      UNARY_OPERATOR, SIN},
 {"SINH",        7, 8,   0,      UNARY_OPERATOR, SINH},
+{"SLICE",       7, 8,   -2,     UNARY_OPERATOR, SLICE},
 {"SQR",         7, 8,   0,      UNARY_OPERATOR, SQU_RT},
 {"SQRT",        7, 8,   0,      UNARY_OPERATOR, SQU_RT},
+{"SUM",         7, 8,   0,      UNARY_OPERATOR, SUM},
 {"TAN",         7, 8,   0,      UNARY_OPERATOR, TAN},
 {"TANH",        7, 8,   0,      UNARY_OPERATOR, TANH},
 {"VAL",         0, 0,   1,      OPERAND,        FETCH_VAL},
@@ -207,6 +212,197 @@ static int
 }
 
 
+/* Set to 0 to disable the optimizer below */
+int postfixOptimize = 1;
+epicsExportAddress(int, postfixOptimize);
+
+/* Length in bytes of the instruction at pinst */
+static int instLength(const char *pinst)
+{
+    switch (*pinst) {
+    case LITERAL_DOUBLE:
+        return 1 + sizeof(double);
+    case LITERAL_INT:
+        return 1 + sizeof(epicsInt32);
+    case MIN:
+    case MAX:
+    case FINITE:
+    case ISNAN:
+    case ADD_ARG:
+    case SUB_ARG:
+    case MULT_ARG:
+    case DIV_ARG:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+/* Number of operands popped by the instruction at pinst if it has no
+ * side-effects, so can be evaluated at compile time; 0 if it can't.
+ */
+static int foldArgs(const char *pinst)
+{
+    switch (*pinst) {
+    case UNARY_NEG:
+    case ABS_VAL:
+    case EXP:
+    case LOG_10:
+    case LOG_E:
+    case SQU_RT:
+    case ACOS:
+    case ASIN:
+    case ATAN:
+    case COS:
+    case COSH:
+    case SIN:
+    case SINH:
+    case TAN:
+    case TANH:
+    case CEIL:
+    case FLOOR:
+    case ISINF:
+    case NINT:
+    case REL_NOT:
+    case BIT_NOT:
+    case SUM:
+    case MEAN:
+    case RMS:
+        return 1;
+    case ADD:
+    case SUB:
+    case MULT:
+    case DIV:
+    case MODULO:
+    case POWER:
+    case ATAN2:
+    case FMOD:
+    case REL_OR:
+    case REL_AND:
+    case BIT_OR:
+    case BIT_AND:
+    case BIT_EXCL_OR:
+    case RIGHT_SHIFT_ARITH:
+    case LEFT_SHIFT_ARITH:
+    case RIGHT_SHIFT_LOGIC:
+    case NOT_EQ:
+    case LESS_THAN:
+    case LESS_OR_EQ:
+    case EQUAL:
+    case GR_OR_EQ:
+    case GR_THAN:
+        return 2;
+    case SLICE:
+        return 3;
+    case MIN:
+    case MAX:
+    case FINITE:
+    case ISNAN:
+        return pinst[1];
+    default:
+        return 0;
+    }
+}
+
+/* Encode a literal value using the shortest instruction that gives
+ * back exactly the same double, return its length.
+ */
+static int putLiteral(char *pout, double val)
+{
+    static const double zero = 0.0;
+
+    if (val >= -2147483648.0 && val <= 2147483647.0 &&
+        val == (double) (epicsInt32) val &&
+        (val != 0.0 || memcmp(&val, &zero, sizeof(double)) == 0)) {
+        epicsInt32 lit_i = (epicsInt32) val;
+
+        *pout++ = LITERAL_INT;
+        memcpy(pout, &lit_i, sizeof(epicsInt32));
+        return 1 + sizeof(epicsInt32);
+    }
+    *pout++ = LITERAL_DOUBLE;
+    memcpy(pout, &val, sizeof(double));
+    return 1 + sizeof(double);
+}
+
+/* optimize
+ *
+ * Rewrite postfix instructions in place, without changing the result.
+ * Sub-expressions whose operands are all constants are replaced by a
+ * literal holding the value that calcPerform() returns for them, so the
+ * result is bit-for-bit the same as evaluating them at run-time. Where
+ * the literal would be longer than the instructions it replaces they are
+ * kept, but may still be folded into a larger constant sub-expression.
+ * A FETCH_x followed by one of + - * / becomes a single fused instruction.
+ * The rewritten code is never longer than the original.
+ */
+static void optimize(char *pinst)
+{
+    char expr[512];
+    char *pconst[CALCPERFORM_STACK];    /* constants at the end of pout */
+    int nconst = 0;
+    char *pout = pinst;
+
+    while (*pinst != END_EXPRESSION) {
+        int len = instLength(pinst);
+        int nargs = foldArgs(pinst);
+        int op = *pinst;
+
+        if (op == LITERAL_DOUBLE || op == LITERAL_INT ||
+            op == CONST_PI || op == CONST_D2R || op == CONST_R2D) {
+            memmove(pout, pinst, len);
+            pconst[nconst++] = pout;
+            pout += len;
+            pinst += len;
+            continue;
+        }
+
+        if (nargs > 0 && nargs <= nconst) {
+            /* The operands and operator become one constant */
+            char *pstart = pconst[nconst - nargs];
+            size_t oldlen;
+            double val;
+
+            memmove(pout, pinst, len);
+            pout += len;
+            pinst += len;
+            nconst -= nargs - 1;
+
+            oldlen = pout - pstart;
+            if (oldlen < sizeof(expr)) {
+                memcpy(expr, pstart, oldlen);
+                expr[oldlen] = END_EXPRESSION;
+                if (calcPerform(NULL, &val, expr) == 0) {
+                    char lit[1 + sizeof(double)];
+                    size_t litlen = putLiteral(lit, val);
+
+                    if (litlen <= oldlen) {
+                        memcpy(pstart, lit, litlen);
+                        pout = pstart + litlen;
+                    }
+                }
+            }
+            continue;
+        }
+
+        nconst = 0;
+        if (op >= FETCH_A && op <= FETCH_L &&
+            pinst[1] >= ADD && pinst[1] <= DIV) {
+            *pout++ = ADD_ARG + pinst[1] - ADD;
+            *pout++ = op - FETCH_A;
+            pinst += 2;
+            continue;
+        }
+
+        memmove(pout, pinst, len);
+        pout += len;
+        pinst += len;
+    }
+    /* clear the bytes freed up so the result is reproducible */
+    memset(pout, END_EXPRESSION, pinst - pout + 1);
+}
+
+
 /* postfix
  *
  * convert an infix expression to a postfix expression
@@ -483,6 +679,8 @@ LIBCOM_API long
         *perror = CALC_ERR_INCOMPLETE;
         goto bad;
     }
+    if (postfixOptimize)
+        optimize(pdest);
     return 0;
 
 bad:
@@ -571,6 +769,7 @@ LIBCOM_API void
     /* Numeric */
         "CEIL",
         "FLOOR",
+        "FMOD",
         "FINITE",
         "ISINF",
         "ISNAN",
@@ -599,6 +798,16 @@ LIBCOM_API void
         "COND_IF",
         "COND_ELSE",
         "COND_END",
+    /* Array reductions and slicing */
+        "SUM",
+        "MEAN",
+        "RMS",
+        "SLICE",
+    /* Fused FETCH_x and arithmetic */
+        "ADD_ARG",
+        "SUB_ARG",
+        "MULT_ARG",
+        "DIV_ARG",
     /* Misc */
         "NOT_GENERATED"
     };
@@ -625,6 +834,13 @@ LIBCOM_API void
             printf("\t%s, %d arg(s)\n", opcodes[(int) op], *++pinst);
             pinst++;
             break;
+        case ADD_ARG:
+        case SUB_ARG:
+        case MULT_ARG:
+        case DIV_ARG:
+            printf("\t%s %c\n", opcodes[(int) op], 'A' + *++pinst);
+            pinst++;
+            break;
         default:
             printf("\t%s\n", opcodes[(int) op]);
             pinst++;
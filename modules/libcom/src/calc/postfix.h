@@ -113,6 +113,15 @@
 extern "C" {
 #endif
 
+/** \brief Enable the postfix optimizer
+ *
+ * When non-zero (the default) postfix() folds constant sub-expressions
+ * and fuses argument fetches with the following arithmetic operator.
+ * The optimized byte-code always gives exactly the same results.
+ * Changing this only affects expressions compiled afterwards.
+ */
+LIBCOM_API extern int postfixOptimize;
+
 /** \brief Compile an infix expression into postfix byte-code
  *
  * Converts an expression from an infix string to postfix byte-code
@@ -254,6 +263,18 @@ extern "C" {
  *    - Test for all finite, numeric values: finite(a, ...)
  *    - Random number between 0 and 1: rndm
  *
+ * -# ***Array Functions***
+ *  These are mainly for use with calcPerformArray(), where the arguments
+ *  may be arrays. A scalar is treated as an array of one element, so for
+ *  scalars sum(a), mean(a), min(a) and max(a) all return a, and rms(a)
+ *  returns abs(a).
+ *    - Sum of the elements: sum(a)
+ *    - Mean of the elements: mean(a)
+ *    - Root mean square of the elements: rms(a)
+ *    - Smallest or largest element: min(a) or max(a)
+ *    - Elements first to last: slice(a, first, last)
+ *  \since The array functions were added in UNRELEASED
+ *
  * -# ***Boolean Operators***
  *  These operators regard their arguments as true or false, where 0.0 is
  *  false and any other value is true.
@@ -321,6 +342,45 @@ LIBCOM_API long
 LIBCOM_API long
     calcPerform(double *parg, double *presult, const char *ppostfix);
 
+/** \brief Run the calculation engine on array arguments
+ *
+ * Evaluates a postfix expression created by postfix() where any of the
+ * arguments A-L and the previous result VAL may be arrays. Operators and
+ * functions apply element-wise, combining an array with a scalar applies
+ * the scalar to every element, and combining two arrays uses as many
+ * elements as the shorter has. The sum(), mean(), rms() and single
+ * argument min() and max() functions reduce an array to a scalar, and
+ * slice() selects a range of elements; indices start at 0 and negative
+ * indices count back from the end, so slice(a, 0, -1) is all of a.
+ * Element-wise results are identical to those of calcPerform().
+ *
+ * The condition of a ?: operator must be a scalar, an expression with
+ * an array condition fails. Values assigned with := are only seen by the
+ * rest of the expression, the argument arrays are not modified.
+ *
+ * When VAL and all of the arguments are scalars the expression is passed
+ * to calcPerform(), so this costs little more than calling it directly.
+ * Otherwise every operation is a loop over the elements, with some fixed
+ * overhead per operator for tracking the array values.
+ *
+ * \param pargs Array of CALCPERFORM_NARGS pointers to the argument values.
+ * \param pnargs Array of CALCPERFORM_NARGS element counts for the
+ * arguments; an argument with one element is a scalar.
+ * \param presult Buffer for the result, holding the previous result VAL
+ * on entry.
+ * \param pnresult On entry the number of elements of VAL in presult, on
+ * return the number of elements in the result, 1 for a scalar.
+ * \param nmax Size of the presult buffer, the result is truncated to it.
+ * \param ppostfix The postfix expression created by postfix().
+ * \return Status value 0 for OK, or non-zero if an error is discovered
+ * during the evaluation process.
+ * \since UNRELEASED
+ */
+LIBCOM_API long
+    calcPerformArray(const double * const *pargs, const unsigned long *pnargs,
+        double *presult, unsigned long *pnresult, unsigned long nmax,
+        const char *ppostfix);
+
 /** \brief Find the inputs and outputs of an expression
  *
  * Software using the calc subsystem may need to know what expression
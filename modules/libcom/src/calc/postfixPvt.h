@@ -21,6 +21,9 @@
  *     a byte giving the number of arguments to process.
  *  4. You can't use strlen() on an RPN buffer since the literal values
  *     can contain zero bytes.
+ *  5. The fused ADD_ARG through DIV_ARG opcodes are only generated by the
+ *     optimizer in postfix(), they are followed by a byte giving the index
+ *     of the argument (0 for A) to combine with the top of the stack.
  */
 
 #ifndef INCpostfixPvth
@@ -100,6 +103,16 @@ typedef enum {
     COND_IF,
     COND_ELSE,
     COND_END,
+    /* Array reductions and slicing */
+    SUM,
+    MEAN,
+    RMS,
+    SLICE,
+    /* Fused FETCH_x and arithmetic */
+    ADD_ARG,
+    SUB_ARG,
+    MULT_ARG,
+    DIV_ARG,
     /* Misc */
     NOT_GENERATED
 } rpn_opcode;
@@ -31,7 +31,13 @@
 
 #include "cantProceed.h"
 #include "epicsMutex.h"
+#include "epicsSpin.h"
+#include "epicsAtomic.h"
+#include "epicsThread.h"
+#include "epicsExit.h"
+#include "epicsStdio.h"
 #include "ellLib.h"
+#include "epicsExport.h"
 #include "dbmf.h"
 /*
 #define DBMF_FREELIST_DEBUG 1
@@ -41,6 +47,8 @@
 /*Default values for dblfInit */
 #define DBMF_SIZE               64
 #define DBMF_INITIAL_ITEMS      10
+/*Default number of items moved between a thread cache and the pool*/
+#define DBMF_CACHE_ITEMS        16
 
 typedef struct chunkNode {/*control block for each set of chunkItems*/
     ELLNODE    node;
@@ -53,22 +61,39 @@ typedef struct itemHeader{
     chunkNode  *pchunkNode;
 }itemHeader;
 
+/* Per-thread cache of free items.
+ * Only the owning thread pushes and pops, so the spin lock is normally
+ * uncontended. It is also taken, always after pdbmfPvt->lock, by
+ * dbmfShow() and dbmfFreeChunks() to inspect or reclaim the cache.
+ */
+typedef struct dbmfCache {
+    ELLNODE    node;
+    epicsSpinId spin;
+    void       *freeList;
+    int        nFree;
+} dbmfCache;
+
 typedef struct dbmfPrivate {
     ELLLIST    chunkList;
+    ELLLIST    cacheList;
     epicsMutexId lock;
+    epicsThreadPrivateId cacheId;
     size_t     size;
     size_t     allocSize;
     int        chunkItems;
     size_t     chunkSize;
-    int        nAlloc;
     int        nFree;
+    int        nLarge;
     int        nGtSize;
     void       *freeList;
 } dbmfPrivate;
 dbmfPrivate dbmfPvt;
 static dbmfPrivate *pdbmfPvt = NULL;
+static epicsThreadOnceId dbmfOnce = EPICS_THREAD_ONCE_INIT;
 int dbmfDebug=0;
-
+int dbmfCacheItems=DBMF_CACHE_ITEMS;
+epicsExportAddress(int,dbmfCacheItems);
+
 int dbmfInit(size_t size, int chunkItems)
 {
     if(pdbmfPvt) {
@@ -77,7 +102,9 @@ int dbmfInit(size_t size, int chunkItems)
     }
     pdbmfPvt = &dbmfPvt;
     ellInit(&pdbmfPvt->chunkList);
+    ellInit(&pdbmfPvt->cacheList);
     pdbmfPvt->lock = epicsMutexMustCreate();
+    pdbmfPvt->cacheId = epicsThreadPrivateCreate();
     /*allign to at least a double*/
     pdbmfPvt->size = size + size%sizeof(double);
     /* layout is
@@ -86,36 +113,41 @@ int dbmfInit(size_t size, int chunkItems)
     pdbmfPvt->allocSize = pdbmfPvt->size + sizeof(itemHeader) + 2*REDZONE;
     pdbmfPvt->chunkItems = chunkItems;
     pdbmfPvt->chunkSize = pdbmfPvt->allocSize * pdbmfPvt->chunkItems;
-    pdbmfPvt->nAlloc = 0;
     pdbmfPvt->nFree = 0;
+    pdbmfPvt->nLarge = 0;
     pdbmfPvt->nGtSize = 0;
     pdbmfPvt->freeList = NULL;
     VALGRIND_CREATE_MEMPOOL(pdbmfPvt, REDZONE, 0);
     return(0);
 }
 
-
-void* dbmfMalloc(size_t size)
+static void dbmfOnceInit(void *arg)
 {
-    void      **pnextFree;
-    void      **pfreeList;
-    char       *pmem = NULL;
-    chunkNode  *pchunkNode;
-    itemHeader *pitemHeader;
-
     if(!pdbmfPvt) dbmfInit(DBMF_SIZE,DBMF_INITIAL_ITEMS);
-    epicsMutexMustLock(pdbmfPvt->lock);
-    pfreeList = &pdbmfPvt->freeList;
-    if(*pfreeList == NULL) {
+}
+
+/* Remove up to n items from the shared free list, allocating a new chunk
+ * if it is empty. Returns a list linked through pnextFree.
+ * Caller must hold pdbmfPvt->lock.
+ */
+static void * dbmfTakeLocked(int n, int *pnTaken)
+{
+    void       **pnextFree;
+    void       *plist = NULL;
+    int        nTaken = 0;
+
+    if(pdbmfPvt->freeList == NULL) {
         int         i;
         size_t      nbytesTotal;
+        char       *pmem;
+        chunkNode  *pchunkNode;
+        itemHeader *pitemHeader;
 
         if(dbmfDebug) printf("dbmfMalloc allocating new storage\n");
         nbytesTotal = pdbmfPvt->chunkSize + sizeof(chunkNode);
         pmem = (char *)malloc(nbytesTotal);
         if(!pmem) {
-            epicsMutexUnlock(pdbmfPvt->lock);
-            cantProceed("dbmfMalloc malloc failed\n");
+            *pnTaken = 0;
             return(NULL);
         }
         pchunkNode = (chunkNode *)(pmem + pdbmfPvt->chunkSize);
@@ -126,32 +158,167 @@ void* dbmfMalloc(size_t size)
             pitemHeader = (itemHeader *)pmem;
             pitemHeader->pchunkNode = pchunkNode;
             pnextFree = &pitemHeader->pnextFree;
-            *pnextFree = *pfreeList; *pfreeList = (void *)pmem;
+            *pnextFree = pdbmfPvt->freeList; pdbmfPvt->freeList = (void *)pmem;
             pdbmfPvt->nFree++;
             pmem += pdbmfPvt->allocSize;
         }
     }
+    while(nTaken<n && pdbmfPvt->freeList) {
+        pnextFree = pdbmfPvt->freeList; pdbmfPvt->freeList = *pnextFree;
+        ((itemHeader *)pnextFree)->pchunkNode->nNotFree += 1;
+        *pnextFree = plist; plist = pnextFree;
+        pdbmfPvt->nFree--;
+        nTaken++;
+    }
+    *pnTaken = nTaken;
+    return(plist);
+}
+
+/* Return a list of items linked through pnextFree to the shared free list.
+ * Caller must hold pdbmfPvt->lock.
+ */
+static void dbmfPutLocked(void *plist)
+{
+    void       **pnextFree;
+
+    while(plist) {
+        pnextFree = plist; plist = *pnextFree;
+        ((itemHeader *)pnextFree)->pchunkNode->nNotFree--;
+        *pnextFree = pdbmfPvt->freeList; pdbmfPvt->freeList = pnextFree;
+        pdbmfPvt->nFree++;
+    }
+}
+
+/* Empty a thread cache into the shared free list.
+ * Caller must hold pdbmfPvt->lock.
+ */
+static void dbmfCacheReclaimLocked(dbmfCache *pcache)
+{
+    void       *plist;
+
+    epicsSpinLock(pcache->spin);
+    plist = pcache->freeList;
+    pcache->freeList = NULL;
+    pcache->nFree = 0;
+    epicsSpinUnlock(pcache->spin);
+    dbmfPutLocked(plist);
+}
+
+static void dbmfCacheExit(void *arg)
+{
+    dbmfCache  *pcache = (dbmfCache *)arg;
+
+    epicsMutexMustLock(pdbmfPvt->lock);
+    ellDelete(&pdbmfPvt->cacheList,&pcache->node);
+    dbmfCacheReclaimLocked(pcache);
+    epicsMutexUnlock(pdbmfPvt->lock);
+    epicsThreadPrivateSet(pdbmfPvt->cacheId, NULL);
+    epicsSpinDestroy(pcache->spin);
+    free(pcache);
+}
+
+/* Find or create the cache of the calling thread.
+ * Returns NULL if caching is disabled or the cache can't be created,
+ * in which case the caller works directly on the shared free list.
+ */
+static dbmfCache * dbmfCacheGet(void)
+{
+    dbmfCache  *pcache = epicsThreadPrivateGet(pdbmfPvt->cacheId);
+
+    if(pcache || dbmfCacheItems<=0) return(pcache);
+    pcache = calloc(1,sizeof(dbmfCache));
+    if(!pcache) return(NULL);
+    pcache->spin = epicsSpinCreate();
+    if(!pcache->spin) {
+        free(pcache);
+        return(NULL);
+    }
+    if(epicsAtThreadExit(dbmfCacheExit,pcache)) {
+        epicsSpinDestroy(pcache->spin);
+        free(pcache);
+        return(NULL);
+    }
+    epicsMutexMustLock(pdbmfPvt->lock);
+    ellAdd(&pdbmfPvt->cacheList,&pcache->node);
+    epicsMutexUnlock(pdbmfPvt->lock);
+    epicsThreadPrivateSet(pdbmfPvt->cacheId,pcache);
+    return(pcache);
+}
+
+static int dbmfCacheBatch(void)
+{
+    int batch = dbmfCacheItems;
+
+    return(batch>0 ? batch : 1);
+}
+
+void* dbmfMalloc(size_t size)
+{
+    void      **pnextFree;
+    char       *pmem = NULL;
+    dbmfCache  *pcache;
+    itemHeader *pitemHeader;
+
+    epicsThreadOnce(&dbmfOnce,dbmfOnceInit,NULL);
     if(size<=pdbmfPvt->size) {
-        pnextFree = *pfreeList; *pfreeList = *pnextFree;
+        pcache = dbmfCacheGet();
+        if(pcache) {
+            epicsSpinLock(pcache->spin);
+            pnextFree = pcache->freeList;
+            if(pnextFree) {
+                pcache->freeList = *pnextFree;
+                pcache->nFree--;
+            }
+            epicsSpinUnlock(pcache->spin);
+            if(!pnextFree) {
+                void   *plist;
+                void  **plast;
+                int     nTaken;
+
+                /* refill with one batch, keeping the first item */
+                epicsMutexMustLock(pdbmfPvt->lock);
+                plist = dbmfTakeLocked(dbmfCacheBatch(),&nTaken);
+                epicsMutexUnlock(pdbmfPvt->lock);
+                if(!plist) {
+                    cantProceed("dbmfMalloc malloc failed\n");
+                    return(NULL);
+                }
+                pnextFree = plist; plist = *pnextFree;
+                if(plist) {
+                    plast = plist;
+                    while(*plast) plast = *plast;
+                    epicsSpinLock(pcache->spin);
+                    *plast = pcache->freeList;
+                    pcache->freeList = plist;
+                    pcache->nFree += nTaken - 1;
+                    epicsSpinUnlock(pcache->spin);
+                }
+            }
+        } else {
+            int     nTaken;
+
+            epicsMutexMustLock(pdbmfPvt->lock);
+            pnextFree = dbmfTakeLocked(1,&nTaken);
+            epicsMutexUnlock(pdbmfPvt->lock);
+            if(!pnextFree) {
+                cantProceed("dbmfMalloc malloc failed\n");
+                return(NULL);
+            }
+        }
         pmem = (void *)pnextFree;
-        pdbmfPvt->nAlloc++; pdbmfPvt->nFree--;
-        pitemHeader = (itemHeader *)pnextFree;
-        pitemHeader->pchunkNode->nNotFree += 1;
     } else {
         pmem = malloc(sizeof(itemHeader) + 2*REDZONE + size);
         if(!pmem) {
-            epicsMutexUnlock(pdbmfPvt->lock);
             cantProceed("dbmfMalloc malloc failed\n");
             return(NULL);
         }
-        pdbmfPvt->nAlloc++;
-        pdbmfPvt->nGtSize++;
+        epicsAtomicIncrIntT(&pdbmfPvt->nLarge);
+        epicsAtomicIncrIntT(&pdbmfPvt->nGtSize);
         pitemHeader = (itemHeader *)pmem;
         pitemHeader->pchunkNode = NULL; /* not part of free list */
         if(dbmfDebug) printf("dbmfMalloc: size %lu mem %p\n",
                              (unsigned long)size,pmem);
     }
-    epicsMutexUnlock(pdbmfPvt->lock);
     pmem += sizeof(itemHeader) + REDZONE;
     VALGRIND_MEMPOOL_ALLOC(pdbmfPvt, pmem, size);
     return((void *)pmem);
@@ -176,7 +343,7 @@ char * dbmfStrndup(const char *str, size_t len)
 void dbmfFree(void* mem)
 {
     char       *pmem = (char *)mem;
-    chunkNode  *pchunkNode;
+    dbmfCache  *pcache;
     itemHeader *pitemHeader;
 
     if(!mem) return;
@@ -186,35 +353,75 @@ void dbmfFree(void* mem)
     }
     VALGRIND_MEMPOOL_FREE(pdbmfPvt, mem);
     pmem -= sizeof(itemHeader) + REDZONE;
-    epicsMutexMustLock(pdbmfPvt->lock);
     pitemHeader = (itemHeader *)pmem;
     if(!pitemHeader->pchunkNode) {
         if(dbmfDebug) printf("dbmfGree: mem %p\n",pmem);
-        free((void *)pmem); pdbmfPvt->nAlloc--;
-    }else {
-        void **pfreeList = &pdbmfPvt->freeList;
-        void **pnextFree = &pitemHeader->pnextFree;
-
-        pchunkNode = pitemHeader->pchunkNode;
-        pchunkNode->nNotFree--;
-        *pnextFree = *pfreeList; *pfreeList = pnextFree;
-        pdbmfPvt->nAlloc--; pdbmfPvt->nFree++;
+        free((void *)pmem);
+        epicsAtomicDecrIntT(&pdbmfPvt->nLarge);
+        return;
+    }
+    pitemHeader->pnextFree = NULL;
+    pcache = dbmfCacheGet();
+    if(pcache) {
+        void  **pnextFree = &pitemHeader->pnextFree;
+        void   *plist = NULL;
+        int     batch = dbmfCacheBatch();
+
+        epicsSpinLock(pcache->spin);
+        *pnextFree = pcache->freeList; pcache->freeList = pnextFree;
+        pcache->nFree++;
+        if(pcache->nFree > 2*batch) {
+            /* keep one batch, return the rest in bulk */
+            int     i;
+
+            pnextFree = pcache->freeList;
+            for(i=1; i<batch; i++) pnextFree = *pnextFree;
+            plist = *pnextFree;
+            *pnextFree = NULL;
+            pcache->nFree = batch;
+        }
+        epicsSpinUnlock(pcache->spin);
+        if(plist) {
+            epicsMutexMustLock(pdbmfPvt->lock);
+            dbmfPutLocked(plist);
+            epicsMutexUnlock(pdbmfPvt->lock);
+        }
+    } else {
+        epicsMutexMustLock(pdbmfPvt->lock);
+        dbmfPutLocked(&pitemHeader->pnextFree);
+        epicsMutexUnlock(pdbmfPvt->lock);
     }
-    epicsMutexUnlock(pdbmfPvt->lock);
 }
-
+
 int dbmfShow(int level)
 {
+    dbmfCache  *pcache;
+    int         nCached = 0;
+    int         nTotal;
+
     if(pdbmfPvt==NULL) {
         printf("Never initialized\n");
         return(0);
     }
+    epicsMutexMustLock(pdbmfPvt->lock);
+    for(pcache = (dbmfCache *)ellFirst(&pdbmfPvt->cacheList); pcache;
+            pcache = (dbmfCache *)ellNext(&pcache->node)) {
+        epicsSpinLock(pcache->spin);
+        nCached += pcache->nFree;
+        epicsSpinUnlock(pcache->spin);
+    }
+    nTotal = pdbmfPvt->chunkItems * ellCount(&pdbmfPvt->chunkList);
     printf("size %lu allocSize %lu chunkItems %d ",
         (unsigned long)pdbmfPvt->size,
         (unsigned long)pdbmfPvt->allocSize,pdbmfPvt->chunkItems);
     printf("nAlloc %d nFree %d nChunks %d nGtSize %d\n",
-        pdbmfPvt->nAlloc,pdbmfPvt->nFree,
-        ellCount(&pdbmfPvt->chunkList),pdbmfPvt->nGtSize);
+        nTotal - pdbmfPvt->nFree - nCached
+            + epicsAtomicGetIntT(&pdbmfPvt->nLarge),
+        pdbmfPvt->nFree + nCached,
+        ellCount(&pdbmfPvt->chunkList),
+        epicsAtomicGetIntT(&pdbmfPvt->nGtSize));
+    printf("nThreadCaches %d nCached %d cacheItems %d\n",
+        ellCount(&pdbmfPvt->cacheList),nCached,dbmfCacheItems);
     if(level>0) {
         chunkNode  *pchunkNode;
 
@@ -228,14 +435,13 @@ int dbmfShow(int level)
     if(level>1) {
         void **pnextFree;;
 
-        epicsMutexMustLock(pdbmfPvt->lock);
         pnextFree = (void**)pdbmfPvt->freeList;
         while(pnextFree) {
             printf("%p\n",*pnextFree);
             pnextFree = (void**)*pnextFree;
         }
-        epicsMutexUnlock(pdbmfPvt->lock);
     }
+    epicsMutexUnlock(pdbmfPvt->lock);
     return(0);
 }
 
@@ -243,12 +449,16 @@ void dbmfFreeChunks(void)
 {
     chunkNode  *pchunkNode;
     chunkNode  *pnext;;
+    dbmfCache  *pcache;
 
     if(!pdbmfPvt) {
         printf("dbmfFreeChunks called but dbmfInit never called\n");
         return;
     }
     epicsMutexMustLock(pdbmfPvt->lock);
+    for(pcache = (dbmfCache *)ellFirst(&pdbmfPvt->cacheList); pcache;
+            pcache = (dbmfCache *)ellNext(&pcache->node))
+        dbmfCacheReclaimLocked(pcache);
     if(pdbmfPvt->nFree
             != (pdbmfPvt->chunkItems * ellCount(&pdbmfPvt->chunkList))) {
         printf("dbmfFinish: not all free\n");
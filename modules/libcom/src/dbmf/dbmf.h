@@ -31,6 +31,12 @@
  * \note This facility should NOT be used by code that allocates storage and
  * then keeps it for a considerable period of time before releasing. Such code
  * should consider using the freeList library.
+ *
+ * Each thread keeps a small cache of free items in front of the shared pool,
+ * so concurrent callers rarely contend on the pool lock. Items move between
+ * a thread cache and the pool in batches of dbmfCacheItems. A thread's cache
+ * is returned to the pool when the thread exits, or by dbmfFreeChunks().
+ * Setting dbmfCacheItems to 0 stops further thread caches being created.
  */
 #ifndef DBMF_H
 #define DBMF_H
@@ -42,6 +48,10 @@
 extern "C" {
 #endif
 
+/** \brief Number of items moved between a thread cache and the shared pool
+ * at once; a thread cache holds at most twice this many. Default 16. */
+LIBCOM_API extern int dbmfCacheItems;
+
 /**
  * \brief Initialize the facility
  * \param size The maximum size request from dbmfMalloc() that will be
@@ -98,10 +108,14 @@ LIBCOM_API char * dbmfStrcat3(const char *lhs, const char *mid,
 LIBCOM_API void dbmfFree(void *bytes);
 /**
  * \brief Free all chunks that contain only free items.
+ *
+ * Items held in the thread caches are first returned to the pool.
  */
 LIBCOM_API void dbmfFreeChunks(void);
 /**
  * \brief Show the status of the dbmf memory pool.
+ *
+ * The free count includes items held in the thread caches.
  * \param level Detail level.
  * \return 0.
  */
@@ -0,0 +1,210 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dbmf.h"
+#include "epicsEvent.h"
+#include "epicsStdio.h"
+#include "epicsThread.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#define NTHREADS 4
+#define NITEMS 200
+#define NLOOPS 50
+#define NCACHED 8
+
+typedef struct {
+    int id;
+    int nBad;
+    char *items[NITEMS];
+    epicsEventId done;
+} workerPvt;
+
+static void fill(char *buf, int id, int i)
+{
+    sprintf(buf, "t%d-%d", id, i);
+}
+
+static void worker(void *arg)
+{
+    workerPvt *pvt = arg;
+    char expect[32];
+    int loop, i;
+
+    for (loop = 0; loop < NLOOPS; loop++) {
+        for (i = 0; i < NITEMS; i++) {
+            /* mix pool and large allocations */
+            size_t size = (i % 17) ? 32 : 256;
+
+            pvt->items[i] = dbmfMalloc(size);
+            fill(pvt->items[i], pvt->id, i);
+        }
+        for (i = 0; i < NITEMS; i++) {
+            fill(expect, pvt->id, i);
+            if (strcmp(pvt->items[i], expect))
+                pvt->nBad++;
+        }
+        /* free in a different order than allocated */
+        for (i = 0; i < NITEMS; i += 2)
+            dbmfFree(pvt->items[i]);
+        for (i = 1; i < NITEMS; i += 2)
+            dbmfFree(pvt->items[i]);
+    }
+    epicsEventMustTrigger(pvt->done);
+}
+
+static void testSingle(void)
+{
+    char *a, *b, *c;
+
+    testDiag("Single thread");
+    a = dbmfStrdup("hello");
+    b = dbmfStrndup("worldwide", 5);
+    c = dbmfStrcat3(a, " ", b);
+    testOk1(strcmp(a, "hello") == 0);
+    testOk1(strcmp(b, "world") == 0);
+    testOk1(strcmp(c, "hello world") == 0);
+    testOk1(a != b && b != c);
+    dbmfFree(a);
+    dbmfFree(b);
+    dbmfFree(c);
+    dbmfFree(NULL);
+}
+
+static void testThreads(void)
+{
+    workerPvt pvt[NTHREADS];
+    int i;
+
+    testDiag("%d threads allocating concurrently", NTHREADS);
+    for (i = 0; i < NTHREADS; i++) {
+        pvt[i].id = i;
+        pvt[i].nBad = 0;
+        pvt[i].done = epicsEventMustCreate(epicsEventEmpty);
+        epicsThreadMustCreate("dbmfTest", epicsThreadPriorityMedium,
+            epicsThreadGetStackSize(epicsThreadStackSmall),
+            worker, &pvt[i]);
+    }
+    for (i = 0; i < NTHREADS; i++) {
+        epicsEventMustWait(pvt[i].done);
+        testOk(pvt[i].nBad == 0, "thread %d saw %d corrupted items",
+            i, pvt[i].nBad);
+        epicsEventDestroy(pvt[i].done);
+    }
+}
+
+typedef struct {
+    int nAlloc;
+    int nFree;
+    int nChunks;
+    int nThreadCaches;
+    int nCached;
+} dbmfCounts;
+
+/* Read the counts back from the dbmfShow() report */
+static int getCounts(dbmfCounts *pcounts)
+{
+    FILE *fp = epicsTempFile();
+    char line[256];
+    int n = 0;
+
+    if (!fp)
+        testAbort("epicsTempFile() failed");
+    epicsSetThreadStdout(fp);
+    dbmfShow(0);
+    epicsSetThreadStdout(NULL);
+    rewind(fp);
+    while (fgets(line, sizeof(line), fp)) {
+        char *p;
+
+        if ((p = strstr(line, "nAlloc")))
+            n += sscanf(p, "nAlloc %d nFree %d nChunks %d", &pcounts->nAlloc,
+                &pcounts->nFree, &pcounts->nChunks);
+        if ((p = strstr(line, "nThreadCaches")))
+            n += sscanf(p, "nThreadCaches %d nCached %d",
+                &pcounts->nThreadCaches, &pcounts->nCached);
+    }
+    fclose(fp);
+    testDiag("nAlloc %d nFree %d nChunks %d nThreadCaches %d nCached %d",
+        pcounts->nAlloc, pcounts->nFree, pcounts->nChunks,
+        pcounts->nThreadCaches, pcounts->nCached);
+    return n == 5;
+}
+
+typedef struct {
+    epicsEventId held;
+    epicsEventId release;
+} holderPvt;
+
+static void holder(void *arg)
+{
+    holderPvt *pvt = arg;
+    void *items[NCACHED];
+    int i;
+
+    for (i = 0; i < NCACHED; i++)
+        items[i] = dbmfMalloc(32);
+    for (i = 0; i < NCACHED; i++)
+        dbmfFree(items[i]);
+    /* the freed items stay in this thread's cache until it exits */
+    epicsEventMustTrigger(pvt->held);
+    epicsEventMustWait(pvt->release);
+}
+
+static void testAccounting(void)
+{
+    epicsThreadOpts opts = EPICS_THREAD_OPTS_INIT;
+    epicsThreadId tid;
+    holderPvt pvt;
+    dbmfCounts counts;
+    int nCaches;
+
+    testDiag("Accounting of items held in thread caches");
+    pvt.held = epicsEventMustCreate(epicsEventEmpty);
+    pvt.release = epicsEventMustCreate(epicsEventEmpty);
+    opts.joinable = 1;
+    tid = epicsThreadCreateOpt("dbmfHolder", holder, &pvt, &opts);
+    if (!tid)
+        testAbort("epicsThreadCreateOpt() failed");
+    epicsEventMustWait(pvt.held);
+
+    testOk(getCounts(&counts), "dbmfShow() reports the counts");
+    nCaches = counts.nThreadCaches;
+    testOk(nCaches >= 1 && counts.nCached >= NCACHED,
+        "Freed items are held in a thread cache");
+    testOk(counts.nAlloc == 0 &&
+        counts.nFree >= counts.nCached && counts.nFree > 0,
+        "Cached items are counted as free");
+
+    epicsEventMustTrigger(pvt.release);
+    epicsThreadMustJoin(tid);
+    getCounts(&counts);
+    testOk(counts.nThreadCaches < nCaches,
+        "The cache is removed when its thread exits");
+    testOk(counts.nAlloc == 0, "Nothing is allocated");
+
+    /* Items may still sit in this thread's cache, or in the cache of a
+     * worker which has not quite exited yet. These must be reclaimed. */
+    dbmfFreeChunks();
+    getCounts(&counts);
+    testOk(counts.nChunks == 0 && counts.nFree == 0 && counts.nCached == 0 &&
+        counts.nAlloc == 0, "dbmfFreeChunks() releases every chunk");
+
+    epicsEventDestroy(pvt.held);
+    epicsEventDestroy(pvt.release);
+}
+
+MAIN(dbmfTest)
+{
+    testPlan(14);
+    testSingle();
+    testThreads();
+    testAccounting();
+    return testDone();
+}
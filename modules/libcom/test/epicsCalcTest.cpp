@@ -7,6 +7,7 @@
 \*************************************************************************/
 //  Author: Andrew Johnson
 
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -14,6 +15,7 @@
 #include "epicsTypes.h"
 #include "epicsMath.h"
 #include "epicsAlgorithm.h"
+#include "epicsTime.h"
 #include "postfix.h"
 #include "testMain.h"
 
@@ -158,6 +160,294 @@ void testBadExpr(const char *expr, short expected_err) {
     free(rpn);
 }
 
+void testOptimized(const char *expr) {
+    /* Evaluate expression with and without the optimizer,
+     * results and stored arguments must be bit-for-bit identical */
+    double args[2][CALCPERFORM_NARGS] = {
+        {1.0, -2.0, 3.5, 0.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0},
+        {1.0, -2.0, 3.5, 0.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0}
+    };
+    double result[2] = {0.5, 0.5};
+    long status[2] = {-1, -1};
+    size_t size = INFIX_TO_POSTFIX_SIZE(strlen(expr)+1);
+    char *rpn = (char*)malloc(size);
+    short err;
+    int i;
+
+    if(!rpn) {
+        testFail("postfix: %s no memory", expr);
+        return;
+    }
+
+    for (i = 0; i < 2; i++) {
+        postfixOptimize = i;
+        if (postfix(expr, rpn, &err)) {
+            testDiag("postfix: %s in expression '%s'", calcErrorStr(err), expr);
+            break;
+        }
+        status[i] = calcPerform(args[i], &result[i], rpn);
+    }
+    postfixOptimize = 1;
+
+    if (!testOk(status[0] == status[1] &&
+                memcmp(&result[0], &result[1], sizeof(double)) == 0 &&
+                memcmp(args[0], args[1], sizeof(args[0])) == 0,
+                "Optimized '%s'", expr)) {
+        testDiag("Got %g (%ld), optimized %g (%ld)",
+                 result[0], status[0], result[1], status[1]);
+        calcExprDump(rpn);
+    }
+    free(rpn);
+}
+
+void testFolded(const char *expr, const char *folded) {
+    /* Expression must compile to the same byte-code as folded */
+    size_t size = INFIX_TO_POSTFIX_SIZE(strlen(expr)+1);
+    char *rpn = (char*)calloc(1, size);
+    char *rpnf = (char*)calloc(1, size);
+    short err;
+
+    if(!rpn || !rpnf) {
+        testFail("postfix: %s no memory", expr);
+        free(rpn);
+        free(rpnf);
+        return;
+    }
+
+    postfix(expr, rpn, &err);
+    postfix(folded, rpnf, &err);
+    if (!testOk(memcmp(rpn, rpnf, size) == 0, "'%s' folds to '%s'",
+                expr, folded)) {
+        calcExprDump(rpn);
+    }
+    free(rpn);
+    free(rpnf);
+}
+
+/* Compare evaluation speed of unoptimized and optimized byte-code */
+void benchCalc(const char *expr) {
+    double args[CALCPERFORM_NARGS] = {
+        1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0
+    };
+    char *rpn = (char*)malloc(INFIX_TO_POSTFIX_SIZE(strlen(expr)+1));
+    const unsigned long niter = 200000;
+    double ns[2], result = 0.0;
+    short err;
+    int i;
+
+    if(!rpn)
+        return;
+
+    for (i = 0; i < 2; i++) {
+        epicsUInt64 start;
+        unsigned long n;
+
+        postfixOptimize = i;
+        postfix(expr, rpn, &err);
+        start = epicsMonotonicGet();
+        for (n = 0; n < niter; n++)
+            calcPerform(args, &result, rpn);
+        ns[i] = (epicsMonotonicGet() - start) / (double) niter;
+    }
+    postfixOptimize = 1;
+    testDiag("%8.1f %8.1f ns  %s", ns[0], ns[1], expr);
+    free(rpn);
+}
+
+/* Arguments for the array tests, C is a scalar and E-L are empty */
+static const double arrA[] = {1.0, 2.0, 3.0, 4.0, 5.0};
+static const double arrB[] = {10.0, -20.0, 30.0};
+static const double arrC[] = {2.0};
+static const double arrD[] = {-1.0, epicsNAN, 0.5, epicsINF};
+static const double * const arrArgs[CALCPERFORM_NARGS] = {
+    arrA, arrB, arrC, arrD, arrC, arrC, arrC, arrC, arrC, arrC, arrC, arrC
+};
+static const unsigned long arrN[CALCPERFORM_NARGS] = {
+    5, 3, 1, 4, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static bool sameDouble(double a, double b) {
+    return a == b || (isnan(a) && isnan(b));
+}
+
+void testArrayCalc(const char *expr, unsigned long nexpected, ...) {
+    /* Evaluate expression on arrays, compare with expected elements */
+    char *rpn = (char*)malloc(INFIX_TO_POSTFIX_SIZE(strlen(expr)+1));
+    double result[8] = {0.0};
+    unsigned long n = 1, i;
+    short err;
+    long status;
+    bool pass;
+    va_list ap;
+
+    if(!rpn) {
+        testFail("postfix: %s no memory", expr);
+        return;
+    }
+
+    if (postfix(expr, rpn, &err)) {
+        testFail("postfix: %s in expression '%s'", calcErrorStr(err), expr);
+        free(rpn);
+        return;
+    }
+    status = calcPerformArray(arrArgs, arrN, result, &n, 8, rpn);
+    pass = status == 0 && n == nexpected;
+    va_start(ap, nexpected);
+    for (i = 0; i < nexpected; i++) {
+        double expected = va_arg(ap, double);
+        if (pass && !sameDouble(result[i], expected)) {
+            testDiag("Element %lu expected %g, got %g", i, expected,
+                     result[i]);
+            pass = false;
+        }
+    }
+    va_end(ap);
+    if(!testOk(pass, "Array %s", expr)) {
+        testDiag("Status %ld, %lu elements, expected %lu", status, n,
+                 nexpected);
+        calcExprDump(rpn);
+    }
+    free(rpn);
+}
+
+void testArrayBad(const char *expr) {
+    /* Expression must fail when evaluated on arrays */
+    char *rpn = (char*)malloc(INFIX_TO_POSTFIX_SIZE(strlen(expr)+1));
+    double result = 0.0;
+    unsigned long n = 1;
+    short err;
+
+    if(!rpn) {
+        testFail("postfix: %s no memory", expr);
+        return;
+    }
+
+    postfix(expr, rpn, &err);
+    testOk(calcPerformArray(arrArgs, arrN, &result, &n, 1, rpn) != 0,
+           "Array %s fails", expr);
+    free(rpn);
+}
+
+void testArrayScalar(const char *expr) {
+    /* Array results must be the same as calcPerform() gives element-wise */
+    char *rpn = (char*)malloc(INFIX_TO_POSTFIX_SIZE(strlen(expr)+1));
+    double result[8] = {0.0};
+    unsigned long n = 1, i;
+    short err;
+    bool pass;
+
+    if(!rpn) {
+        testFail("postfix: %s no memory", expr);
+        return;
+    }
+
+    postfix(expr, rpn, &err);
+    pass = calcPerformArray(arrArgs, arrN, result, &n, 8, rpn) == 0 &&
+        n == 3;
+    for (i = 0; pass && i < n; i++) {
+        double args[CALCPERFORM_NARGS] = {
+            arrA[i], arrB[i], arrC[0], arrD[i]
+        };
+        double expected = 0.0;
+
+        calcPerform(args, &expected, rpn);
+        if (memcmp(&expected, &result[i], sizeof(double)) != 0 &&
+            !(isnan(expected) && isnan(result[i]))) {
+            testDiag("Element %lu expected %g, got %g", i, expected,
+                     result[i]);
+            pass = false;
+        }
+    }
+    if(!testOk(pass, "Array %s matches scalar", expr))
+        calcExprDump(rpn);
+    free(rpn);
+}
+
+void testArrayAllScalar(const char *expr) {
+    /* With only scalars the result and status are those of calcPerform() */
+    static const double vals[CALCPERFORM_NARGS] = {
+        1.5, -2.0, 0.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0
+    };
+    static const unsigned long ones[CALCPERFORM_NARGS] = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+    };
+    char *rpn = (char*)malloc(INFIX_TO_POSTFIX_SIZE(strlen(expr)+1));
+    const double *pargs[CALCPERFORM_NARGS];
+    double args[CALCPERFORM_NARGS];
+    double result = 0.5, expected = 0.5;
+    unsigned long n = 1, i;
+    long status, expectedStatus;
+    short err;
+
+    if(!rpn) {
+        testFail("postfix: %s no memory", expr);
+        return;
+    }
+
+    postfix(expr, rpn, &err);
+    for (i = 0; i < CALCPERFORM_NARGS; i++) {
+        pargs[i] = &vals[i];
+        args[i] = vals[i];
+    }
+    status = calcPerformArray(pargs, ones, &result, &n, 1, rpn);
+    expectedStatus = calcPerform(args, &expected, rpn);
+    if(!testOk(status == expectedStatus && n == 1 &&
+               sameDouble(result, expected),
+               "Scalar %s matches calcPerform()", expr))
+        testDiag("Status %ld, expected %ld, result %g, expected %g",
+                 status, expectedStatus, result, expected);
+    free(rpn);
+}
+
+/* Time array evaluation against calcPerform() on each element */
+void benchArrayCalc(const char *expr, unsigned long nelm) {
+    double *buf = (double*)malloc(3 * nelm * sizeof(double));
+    char *rpn = (char*)malloc(INFIX_TO_POSTFIX_SIZE(strlen(expr)+1));
+    const double *pargs[CALCPERFORM_NARGS];
+    unsigned long nargs[CALCPERFORM_NARGS];
+    const unsigned long niter = 2000000 / nelm + 1;
+    double ns[2];
+    unsigned long n, i;
+    short err;
+
+    if(!buf || !rpn) {
+        free(buf);
+        free(rpn);
+        return;
+    }
+    for (i = 0; i < 2 * nelm; i++)
+        buf[i] = i * 0.5;
+    for (i = 0; i < CALCPERFORM_NARGS; i++) {
+        pargs[i] = &buf[(i & 1) * nelm];
+        nargs[i] = nelm;
+    }
+
+    postfix(expr, rpn, &err);
+    {
+        epicsUInt64 start = epicsMonotonicGet();
+        for (n = 0; n < niter; n++) {
+            for (i = 0; i < nelm; i++) {
+                double args[CALCPERFORM_NARGS] = {
+                    buf[i], buf[nelm + i], buf[i], buf[nelm + i]
+                };
+                calcPerform(args, &buf[2 * nelm + i], rpn);
+            }
+        }
+        ns[0] = (epicsMonotonicGet() - start) / (double) (niter * nelm);
+    }
+    {
+        epicsUInt64 start = epicsMonotonicGet();
+        for (n = 0; n < niter; n++) {
+            unsigned long nres = nelm;
+            calcPerformArray(pargs, nargs, &buf[2 * nelm], &nres, nelm, rpn);
+        }
+        ns[1] = (epicsMonotonicGet() - start) / (double) (niter * nelm);
+    }
+    testDiag("%8.2f %8.2f ns/element  %s", ns[0], ns[1], expr);
+    free(buf);
+    free(rpn);
+}
+
 /* Test an expression that is also valid C code */
 #define testExpr(expr) testCalc(#expr, expr);
 
@@ -298,7 +588,7 @@ MAIN(epicsCalcTest)
     const double a=1.0, b=2.0, c=3.0, d=4.0, e=5.0, f=6.0,
                  g=7.0, h=8.0, i=9.0, j=10.0, k=11.0, l=12.0;
 
-    testPlan(635);
+    testPlan(743);
 
     /* LITERAL_OPERAND elements */
     testExpr(0);
@@ -1010,5 +1300,136 @@ MAIN(epicsCalcTest)
     testUInt32Calc("-1431655766.1 << 0.1", 0xaaaaaaaau);
     testUInt32Calc("2863311530.1 << 0.1", 0xaaaaaaaau);
 
+    // Optimizer must not change any result
+    testOptimized("1+2");
+    testOptimized("-1");
+    testOptimized("-0");
+    testOptimized("-0.0*1");
+    testOptimized("2**0.5");
+    testOptimized("PI/2");
+    testOptimized("-PI");
+    testOptimized("sin(PI/4)*A");
+    testOptimized("A+B*C-D/E");
+    testOptimized("A-B-C-D");
+    testOptimized("A/D");
+    testOptimized("1/0");
+    testOptimized("-1/0");
+    testOptimized("0/0");
+    testOptimized("1.5%0");
+    testOptimized("7%3");
+    testOptimized("1e300*1e300");
+    testOptimized("0.1+0.2");
+    testOptimized("1/3");
+    testOptimized("max(1,2,NaN)");
+    testOptimized("min(3,A,1)");
+    testOptimized("isnan(0/0,1)");
+    testOptimized("finite(1,2,3)");
+    testOptimized("isinf(1/0)");
+    testOptimized("nint(2.5)+nint(-2.5)");
+    testOptimized("~0xaaaaaaaa");
+    testOptimized("0x80000000|1");
+    testOptimized("0xffffffff>>>4");
+    testOptimized("2147483647+1");
+    testOptimized("-2147483648-1");
+    testOptimized("A+1+2");
+    testOptimized("1+2+A");
+    testOptimized("D2R*R2D");
+    testOptimized("VAL+1*2");
+    testOptimized("a:=1+2;a*3");
+    testOptimized("b:=A*2;c:=b+1;b*c");
+    testOptimized("A?1+2:3*4");
+    testOptimized("(1+2)?A:B");
+    testOptimized("0?A:B+C");
+    testOptimized("A<B?C+D:E-F");
+    testOptimized("(A>0?1:2)+3");
+    testOptimized("atan2(1,2)+fmod(7,2)");
+    testOptimized("log(exp(1))+log(100)+ln(2)");
+    testOptimized("sqrt(2)*sqr(2)");
+    testOptimized("abs(-3)+ceil(1.5)+floor(1.5)");
+    testOptimized("!0 && 1 || 0");
+    testOptimized("(1<2)+(2<=2)+(3=3)+(4>=5)+(5>6)+(6!=7)");
+    testOptimized("1<<31");
+    testOptimized("-1>>1");
+    testFolded("1+2", "3");
+    testFolded("2*3+4", "10");
+    testFolded("A*(2+3)", "A*5");
+    testFolded("0.5*(1+2)", "1.5");
+    testFolded("max(1,2,3)", "3");
+
+    // Performance comparison, times per evaluation
+    testDiag("unoptimized / optimized:");
+    benchCalc("A+B+C+D");
+    benchCalc("A*2*PI/360");
+    benchCalc("(A+B)/2");
+    benchCalc("A<B?C+D:E-F");
+    benchCalc("A*B+C*D+E*F+G*H+I*J+K*L");
+    benchCalc("(A-B)*(1/(D2R*180))+sin(2*PI*0.25)");
+    benchCalc("a:=a+1;b:=b*1.0001;a+b-c/d");
+
+    // Array evaluation
+    testArrayCalc("A", 5, 1.0, 2.0, 3.0, 4.0, 5.0);
+    testArrayCalc("C", 1, 2.0);
+    testArrayCalc("A*C+1", 5, 3.0, 5.0, 7.0, 9.0, 11.0);
+    testArrayCalc("C-A", 5, 1.0, 0.0, -1.0, -2.0, -3.0);
+    testArrayCalc("A+B", 3, 11.0, -18.0, 33.0);
+    testArrayCalc("-B", 3, -10.0, 20.0, -30.0);
+    testArrayCalc("abs(B)/10", 3, 1.0, 2.0, 3.0);
+    testArrayCalc("A>2", 5, 0.0, 0.0, 1.0, 1.0, 1.0);
+    testArrayCalc("C>1?A:B", 5, 1.0, 2.0, 3.0, 4.0, 5.0);
+    testArrayCalc("sum(A)", 1, 15.0);
+    testArrayCalc("mean(A)", 1, 3.0);
+    testArrayCalc("rms(B)", 1, sqrt(1400.0 / 3));
+    testArrayCalc("max(A)", 1, 5.0);
+    testArrayCalc("min(B)", 1, -20.0);
+    testArrayCalc("max(D)", 1, epicsNAN);
+    testArrayCalc("max(A,3)", 5, 3.0, 3.0, 3.0, 4.0, 5.0);
+    testArrayCalc("min(A,B,C)", 3, 1.0, -20.0, 2.0);
+    testArrayCalc("sum(C)+mean(C)+rms(-C)", 1, 6.0);
+    testArrayCalc("sum(E)", 1, 0.0);
+    testArrayCalc("mean(E)", 1, epicsNAN);
+    testArrayCalc("E+1", 0);
+    testArrayCalc("slice(A,1,3)", 3, 2.0, 3.0, 4.0);
+    testArrayCalc("slice(A,-2,-1)", 2, 4.0, 5.0);
+    testArrayCalc("slice(A,3,10)", 2, 4.0, 5.0);
+    testArrayCalc("slice(A,3,1)", 0);
+    testArrayCalc("slice(C,0,0)", 1, 2.0);
+    testArrayCalc("sum(slice(A,0,1))", 1, 3.0);
+    testArrayCalc("slice(A,1,-1)-slice(A,0,-2)", 4, 1.0, 1.0, 1.0, 1.0);
+    testArrayCalc("isnan(D)", 4, 0.0, 1.0, 0.0, 0.0);
+    testArrayCalc("finite(A,D)", 4, 1.0, 0.0, 1.0, 0.0);
+    testArrayCalc("isnan(C,D)", 4, 0.0, 1.0, 0.0, 0.0);
+    testArrayCalc("a:=A*2;a+a", 5, 4.0, 8.0, 12.0, 16.0, 20.0);
+    testArrayCalc("b:=A;b:=b+1;sum(b)-sum(A)", 1, 5.0);
+    testArrayCalc("VAL+1", 1, 1.0);
+    testArrayCalc("A*(1+2)", 5, 3.0, 6.0, 9.0, 12.0, 15.0);
+    testArrayBad("A?1:2");
+    testArrayBad("slice(A,B,1)");
+    testArrayScalar("A+B*C-D/A");
+    testArrayScalar("max(A,B,D)");
+    testArrayScalar("min(D,B)");
+    testArrayScalar("sin(A)+cos(B)+exp(-A)");
+    testArrayScalar("A**2+B%7");
+    testArrayScalar("~B|A");
+    testArrayScalar("(A<<2 >> 1)+B");
+    testArrayScalar("nint(B/7)+floor(A/2)+ceil(A/2)");
+    testArrayScalar("atan2(A,B)");
+    testArrayScalar("isinf(D)+isnan(D)+finite(D)+B");
+    testArrayScalar("!A || B<0 && D");
+    testArrayAllScalar("A*B+C*D-L");
+    testArrayAllScalar("C?A:B");
+    testArrayAllScalar("VAL+1");
+    testArrayAllScalar("a:=A*2;a+A");
+    testArrayAllScalar("sum(A)+rms(B)+slice(C,1,2)");
+    testArrayAllScalar("B/C");
+
+    // Performance comparison, times per element
+    testDiag("calcPerform / calcPerformArray:");
+    benchArrayCalc("A+B", 1000);
+    benchArrayCalc("A*B+C*D", 1000);
+    benchArrayCalc("sqrt(A*A+B*B)", 1000);
+    benchArrayCalc("A>B?A:B", 1);
+    benchArrayCalc("A*B+C*D", 1);
+    benchArrayCalc("sin(A)*B", 1000);
+
     return testDone();
 }
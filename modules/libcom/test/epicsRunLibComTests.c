@@ -19,6 +19,7 @@
 
 int aslibtest(void);
 int blockingSockTest(void);
+int dbmfTest(void);
 int epicsAlgorithm(void);
 int epicsAtomicTest(void);
 int epicsCalcTest(void);
@@ -78,6 +79,7 @@ void epicsRunLibComTests(void)
      */
     runTest(aslibtest);
     runTest(blockingSockTest);
+    runTest(dbmfTest);
     runTest(epicsAlgorithm);
     runTest(epicsAtomicTest);
     runTest(epicsCalcTest);